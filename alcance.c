@@ -0,0 +1,206 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "alcance.h"
+#include "tabela_simbolos.h"
+
+static EstatisticasAlcance estatisticas;
+static int avisos;
+
+static void avisa(int linha, const char* mensagem, const char* nome) {
+    if (!avisos) return;
+    printf("AVISO (linha %d): ", linha);
+    printf(mensagem, nome);
+    printf("\n");
+}
+
+
+// --- Comandos ---
+
+static void remove_da_lista(No* lista);
+
+static int lista_sempre_retorna(No* lista);
+
+// Um comando "sempre retorna" se nenhum caminho por ele chega ao comando seguinte.
+static int sempre_retorna(No* no) {
+    switch (no->tipo_no) {
+        case NO_RETORNO:
+            return 1;
+        case NO_BLOCO:
+            return lista_sempre_retorna(no->filho2);
+        case NO_IF:
+            return no->filho3 && lista_sempre_retorna(no->filho2) && lista_sempre_retorna(no->filho3);
+        default:
+            return 0;
+    }
+}
+
+static int lista_sempre_retorna(No* lista) {
+    for (No* no = lista; no != NULL; no = no->proximo) {
+        if (sempre_retorna(no)) return 1;
+    }
+    return 0;
+}
+
+static int eh_zero(const No* no) {
+    return no->tipo_no == NO_CONST_INT && atoi(texto_atomo(no->lexema)) == 0;
+}
+
+static void remove_do_comando(No* no) {
+    switch (no->tipo_no) {
+        case NO_BLOCO:
+            remove_da_lista(no->filho2);
+            break;
+        case NO_IF:
+            remove_da_lista(no->filho2);
+            remove_da_lista(no->filho3);
+            break;
+        case NO_WHILE:
+            if (eh_zero(no->filho1)) {
+                // O corpo nunca é executado: o laço vira um bloco vazio (o teste não tem efeitos).
+                if (no->filho2) {
+                    avisa(no->linha, "corpo de '%s' com condição sempre falsa removido.", "enquanto");
+                    for (No* c = no->filho2; c != NULL; c = c->proximo) estatisticas.comandos_removidos++;
+                }
+                no->tipo_no = NO_BLOCO;
+                no->lexema = ATOMO_NULO;
+                no->filho1 = no->filho2 = no->filho3 = no->filho4 = NULL;
+            } else {
+                remove_da_lista(no->filho2);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static void remove_da_lista(No* lista) {
+    for (No* no = lista; no != NULL; no = no->proximo) {
+        remove_do_comando(no);
+        if (no->proximo && sempre_retorna(no)) {
+            avisa(no->proximo->linha, "comando(s) inalcançável(is) depois de '%s' removido(s).", "retorne");
+            for (No* c = no->proximo; c != NULL; c = c->proximo) estatisticas.comandos_removidos++;
+            no->proximo = NULL;
+        }
+    }
+}
+
+EstatisticasAlcance remove_comandos_inalcancaveis(No* raiz_arvore, int com_avisos) {
+    avisos = com_avisos;
+    estatisticas.comandos_removidos = 0;
+    for (No* d = raiz_arvore->filho1; d != NULL; d = d->proximo) {
+        if (d->tipo_no == NO_DECL_FUNCAO) remove_da_lista(d->filho3);
+    }
+    remove_da_lista(raiz_arvore->filho2);
+    return estatisticas;
+}
+
+
+// --- Grafo de Chamadas ---
+// Um vértice por função do programa (o bloco principal incluído) e uma aresta de cada função
+// para cada função que ela chama, guardados como vetores de índices em programa->funcoes.
+
+typedef struct Vertice {
+    int* chamadas;
+    int num_chamadas;
+    int capacidade_chamadas;
+    int alcancado;
+} Vertice;
+
+static void* aloca_zerado(int n, size_t tamanho) {
+    void* v = calloc(n ? n : 1, tamanho);
+    if (!v) {
+        fprintf(stderr, "Erro: Falha de alocação de memória no grafo de chamadas.\n");
+        exit(1);
+    }
+    return v;
+}
+
+static int indice_da_funcao(const ProgramaIR* programa, const Vinculo* v) {
+    for (int f = 0; f < programa->num_funcoes; f++) {
+        if (programa->funcoes[f]->vinculo == v) return f;
+    }
+    return -1;
+}
+
+static void acrescenta_chamada(Vertice* vertice, int chamada) {
+    for (int i = 0; i < vertice->num_chamadas; i++) {
+        if (vertice->chamadas[i] == chamada) return;
+    }
+    if (vertice->num_chamadas == vertice->capacidade_chamadas) {
+        vertice->capacidade_chamadas = vertice->capacidade_chamadas ? vertice->capacidade_chamadas * 2 : 4;
+        vertice->chamadas = realloc(vertice->chamadas, vertice->capacidade_chamadas * sizeof(int));
+        if (!vertice->chamadas) {
+            fprintf(stderr, "Erro: Falha de alocação de memória no grafo de chamadas.\n");
+            exit(1);
+        }
+    }
+    vertice->chamadas[vertice->num_chamadas++] = chamada;
+}
+
+static Vertice* monta_grafo(const ProgramaIR* programa) {
+    Vertice* grafo = aloca_zerado(programa->num_funcoes, sizeof(Vertice));
+    for (int f = 0; f < programa->num_funcoes; f++) {
+        FuncaoIR* funcao = programa->funcoes[f];
+        for (int i = 0; i < funcao->num_blocos; i++) {
+            for (InstrucaoIR* ins = funcao->blocos[i]->primeira; ins; ins = ins->proxima) {
+                if (ins->op != IR_CHAMADA) continue;
+                int chamada = indice_da_funcao(programa, ins->funcao);
+                if (chamada >= 0) acrescenta_chamada(&grafo[f], chamada);
+            }
+        }
+    }
+    return grafo;
+}
+
+// Marca tudo o que a função alcança (busca em profundidade com pilha explícita).
+static void marca_alcancadas(Vertice* grafo, int num_vertices, int inicio) {
+    int* pilha = aloca_zerado(num_vertices, sizeof(int));
+    int topo = 0;
+    grafo[inicio].alcancado = 1;
+    pilha[topo++] = inicio;
+    while (topo > 0) {
+        Vertice* v = &grafo[pilha[--topo]];
+        for (int i = 0; i < v->num_chamadas; i++) {
+            int w = v->chamadas[i];
+            if (!grafo[w].alcancado) {
+                grafo[w].alcancado = 1;
+                pilha[topo++] = w;
+            }
+        }
+    }
+    free(pilha);
+}
+
+EstatisticasAlcance remove_funcoes_inalcancaveis(ProgramaIR* programa, int com_avisos) {
+    avisos = com_avisos;
+    estatisticas.funcoes_alcancadas = estatisticas.funcoes_removidas = 0;
+    int n = programa->num_funcoes;
+    Vertice* grafo = monta_grafo(programa);
+    int principal = 0;
+    while (programa->funcoes[principal] != programa->principal) principal++;
+    marca_alcancadas(grafo, n, principal);
+
+    // Separa as funções antes de remover (a remoção muda os índices).
+    FuncaoIR** mortas = aloca_zerado(n, sizeof(FuncaoIR*));
+    int num_mortas = 0;
+    for (int f = 0; f < n; f++) {
+        if (f != principal && grafo[f].alcancado) estatisticas.funcoes_alcancadas++;
+        else if (f != principal) mortas[num_mortas++] = programa->funcoes[f];
+        free(grafo[f].chamadas);
+    }
+    for (int i = 0; i < num_mortas; i++) {
+        Vinculo* v = mortas[i]->vinculo;
+        avisa(v->linha, "função '%s' não é chamada a partir do programa; removida.", texto_atomo(v->nome));
+        ir_remove_funcao(programa, mortas[i]);
+        estatisticas.funcoes_removidas++;
+    }
+    free(mortas);
+    free(grafo);
+    return estatisticas;
+}
+
+void imprime_estatisticas_alcance(void) {
+    printf("Código inalcançável: %d comando(s) removido(s); %d função(ões) alcançada(s) a partir do programa, "
+           "%d removida(s).\n",
+           estatisticas.comandos_removidos, estatisticas.funcoes_alcancadas, estatisticas.funcoes_removidas);
+}
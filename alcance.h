@@ -0,0 +1,32 @@
+#ifndef ALCANCE_H
+#define ALCANCE_H
+
+#include "arvore.h"
+#include "ir.h"
+
+// --- Código Inalcançável e Grafo de Chamadas ---
+// Duas passadas que descartam o que nunca pode ser executado, feitas em todos os níveis:
+//  - sobre a árvore, antes do código intermediário: os comandos que vêm depois de um comando
+//    que sempre retorna ('retorne', um bloco que contém um, ou um 'se' com 'senao' em que os
+//    dois ramos retornam) e o corpo dos 'enquanto' cuja condição é a constante 0;
+//  - sobre o código intermediário, depois da expansão em linha: o grafo de chamadas é montado a
+//    partir do bloco principal e as funções que ele não alcança deixam de ser geradas.
+// Com 'avisos', cada remoção é relatada com a linha do código-fonte.
+
+// Contadores do que as passadas fizeram (para o relatório).
+typedef struct EstatisticasAlcance {
+    int comandos_removidos;     // Comandos depois de um 'retorne' ou em laços que nunca executam.
+    int funcoes_alcancadas;     // Funções declaradas que o bloco principal pode chamar.
+    int funcoes_removidas;      // Funções que nunca são chamadas.
+} EstatisticasAlcance;
+
+// Remove da árvore os comandos inalcançáveis.
+EstatisticasAlcance remove_comandos_inalcancaveis(No* raiz_arvore, int avisos);
+
+// Remove do programa as funções fora do grafo de chamadas do bloco principal.
+EstatisticasAlcance remove_funcoes_inalcancaveis(ProgramaIR* programa, int avisos);
+
+// Imprime o relatório (das duas passadas).
+void imprime_estatisticas_alcance(void);
+
+#endif // ALCANCE_H
@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "alocacao.h"
+
+#define PROFUNDIDADE_MAXIMA_PESO 5 // Limita o peso (8^5) em laços muito aninhados.
+
+static const Registrador alocaveis[NUM_REGISTRADORES_ALOCAVEIS] = {
+    REG_T0, REG_T1, REG_T2, REG_T3, REG_T4, REG_T5, REG_T6, REG_T7
+};
+
+static void* aloca_vetor(int n, size_t tamanho) {
+    void* v = malloc((n ? n : 1) * tamanho);
+    if (!v) {
+        fprintf(stderr, "Erro: Falha de alocação de memória na alocação de registradores.\n");
+        exit(1);
+    }
+    return v;
+}
+
+static void estende(Alocacao* a, Operando o, int posicao) {
+    if (o.tipo != OPERANDO_TEMP) return;
+    if (posicao < a->inicio[o.valor]) a->inicio[o.valor] = posicao;
+    if (posicao > a->fim[o.valor]) a->fim[o.valor] = posicao;
+}
+
+// Calcula os intervalos. Um temporário vivo na entrada (saída) de um bloco fica vivo desde
+// antes da primeira (até a última) posição do bloco; como o intervalo é um único trecho
+// contínuo, os valores que atravessam um laço ficam vivos durante o laço inteiro.
+// As instruções recebem números pares: o ímpar anterior representa a entrada do bloco, para
+// que um valor vivo na entrada não divida o registrador com um operando lido pela primeira
+// instrução.
+static void calcula_intervalos(FuncaoIR* funcao, Alocacao* a) {
+    int posicao = 2;
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        for (InstrucaoIR* ins = b->primeira; ins; ins = ins->proxima, posicao += 2) ins->numero = posicao;
+        b->numero_terminador = posicao;
+        posicao += 2;
+    }
+
+    ir_calcula_vivacidade(funcao);
+    for (int t = 0; t < a->num_temporarios; t++) {
+        a->inicio[t] = INT_MAX;
+        a->fim[t] = -1;
+    }
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        int entrada = (b->primeira ? b->primeira->numero : b->numero_terminador) - 1;
+        for (int t = 0; t < a->num_temporarios; t++) {
+            if (ir_pertence(b->vivos_entrada, t)) estende(a, (Operando){ OPERANDO_TEMP, t, NULL }, entrada);
+            if (ir_pertence(b->vivos_saida, t)) estende(a, (Operando){ OPERANDO_TEMP, t, NULL }, b->numero_terminador);
+        }
+        for (InstrucaoIR* ins = b->primeira; ins; ins = ins->proxima) {
+            estende(a, ins->destino, ins->numero);
+            estende(a, ins->a, ins->numero);
+            estende(a, ins->b, ins->numero);
+        }
+        estende(a, b->valor, b->numero_terminador);
+        estende(a, b->valor2, b->numero_terminador);
+    }
+}
+
+static const int* inicios_ordenacao;
+
+static int compara_inicio(const void* x, const void* y) {
+    int a = *(const int*)x, b = *(const int*)y;
+    if (inicios_ordenacao[a] != inicios_ordenacao[b]) return inicios_ordenacao[a] < inicios_ordenacao[b] ? -1 : 1;
+    return a - b;
+}
+
+// Procura um registrador livre, primeiro entre os preservados ou primeiro entre os $t.
+static int registrador_livre(const int* ativo, int total, int preferir_preservados) {
+    for (int passo = 0; passo < 2; passo++) {
+        int preservado = passo == 0 ? preferir_preservados : !preferir_preservados;
+        int de = preservado ? NUM_REGISTRADORES_ALOCAVEIS : 0;
+        int ate = preservado ? total : NUM_REGISTRADORES_ALOCAVEIS;
+        for (int r = de; r < ate; r++) {
+            if (ativo[r] < 0) return r;
+        }
+    }
+    return -1;
+}
+
+void aloca_registradores(FuncaoIR* funcao, Alocacao* a, const Registrador* preservados, int num_preservados) {
+    int n = funcao->num_temporarios;
+    a->num_temporarios = n;
+    a->registrador = aloca_vetor(n, sizeof(Registrador));
+    a->slot = aloca_vetor(n, sizeof(int));
+    a->inicio = aloca_vetor(n, sizeof(int));
+    a->fim = aloca_vetor(n, sizeof(int));
+    a->num_slots = 0;
+    calcula_intervalos(funcao, a);
+
+    int* ordem = aloca_vetor(n, sizeof(int));
+    int num_ordem = 0;
+    for (int t = 0; t < n; t++) {
+        a->registrador[t] = REG_ZERO;
+        a->slot[t] = -1;
+        if (a->inicio[t] <= a->fim[t]) ordem[num_ordem++] = t;
+    }
+    inicios_ordenacao = a->inicio;
+    qsort(ordem, num_ordem, sizeof(int), compara_inicio);
+
+    // Chamadas atravessadas por cada temporário, pesadas pelo aninhamento de laços (8 por nível).
+    int* chamadas_atravessadas = aloca_vetor(n, sizeof(int));
+    for (int t = 0; t < n; t++) chamadas_atravessadas[t] = 0;
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        int p = b->profundidade_laco < PROFUNDIDADE_MAXIMA_PESO ? b->profundidade_laco : PROFUNDIDADE_MAXIMA_PESO;
+        int peso = 1 << (3 * p);
+        for (InstrucaoIR* ins = b->primeira; ins; ins = ins->proxima) {
+            if (ins->op != IR_CHAMADA) continue;
+            for (int t = 0; t < n; t++) {
+                if (vivo_atraves(a, t, ins->numero)) chamadas_atravessadas[t] += peso;
+            }
+        }
+    }
+
+    // Os $t vêm primeiro, seguidos dos preservados oferecidos.
+    // ativo[r] = temporário que ocupa registradores[r] (-1 = livre).
+    Registrador registradores[NUM_REGISTRADORES_ALOCAVEIS + MAX_REGISTRADORES_PRESERVADOS];
+    int ativo[NUM_REGISTRADORES_ALOCAVEIS + MAX_REGISTRADORES_PRESERVADOS];
+    if (num_preservados > MAX_REGISTRADORES_PRESERVADOS) num_preservados = MAX_REGISTRADORES_PRESERVADOS;
+    int total = NUM_REGISTRADORES_ALOCAVEIS + num_preservados;
+    for (int r = 0; r < total; r++) {
+        registradores[r] = r < NUM_REGISTRADORES_ALOCAVEIS ? alocaveis[r] : preservados[r - NUM_REGISTRADORES_ALOCAVEIS];
+        ativo[r] = -1;
+    }
+
+    for (int k = 0; k < num_ordem; k++) {
+        int t = ordem[k];
+        // Libera os registradores cujos intervalos já terminaram. Um intervalo que termina
+        // exatamente onde este começa também libera o registrador: a instrução lê os
+        // operandos antes de escrever o destino.
+        int mais_longo = -1;
+        for (int r = 0; r < total; r++) {
+            if (ativo[r] >= 0 && a->fim[ativo[r]] <= a->inicio[t]) ativo[r] = -1;
+            if (ativo[r] >= 0 && (mais_longo < 0 || a->fim[ativo[r]] > a->fim[ativo[mais_longo]])) {
+                mais_longo = r;
+            }
+        }
+        int livre = registrador_livre(ativo, total, chamadas_atravessadas[t] > 1);
+        if (livre >= 0) {
+            ativo[livre] = t;
+            a->registrador[t] = registradores[livre];
+        } else if (a->fim[ativo[mais_longo]] > a->fim[t]) {
+            // Quem vive mais vai para a memória e cede o registrador.
+            int despejado = ativo[mais_longo];
+            a->registrador[despejado] = REG_ZERO;
+            a->slot[despejado] = a->num_slots++;
+            ativo[mais_longo] = t;
+            a->registrador[t] = registradores[mais_longo];
+        } else {
+            a->slot[t] = a->num_slots++;
+        }
+    }
+    free(chamadas_atravessadas);
+    free(ordem);
+}
+
+void libera_alocacao(Alocacao* a) {
+    free(a->registrador);
+    free(a->slot);
+    free(a->inicio);
+    free(a->fim);
+    a->registrador = NULL;
+    a->slot = a->inicio = a->fim = NULL;
+}
+
+int vivo_atraves(const Alocacao* a, int temp, int posicao) {
+    return a->inicio[temp] < posicao && a->fim[temp] > posicao;
+}
@@ -0,0 +1,42 @@
+#ifndef ALOCACAO_H
+#define ALOCACAO_H
+
+#include "ir.h"
+#include "emissor.h"
+
+// --- Alocação de Registradores por Varredura Linear ---
+// Cada temporário do código intermediário recebe um dos registradores $t0-$t7 ou, quando há
+// mais valores vivos ao mesmo tempo do que registradores, uma posição ("slot") no quadro da
+// função. As instruções são numeradas na ordem em que serão emitidas, e o intervalo de vida
+// de um temporário vai da primeira à última posição em que ele está vivo. Os intervalos são
+// percorridos em ordem de início; quando faltam registradores, vai para a memória o intervalo
+// que termina mais tarde (Poletto e Sarkar). $t8 e $t9 não são alocados: a geração de código os
+// usa para carregar operandos que estão na memória.
+// Quem chama pode oferecer também registradores preservados pelas chamadas ($s que a função não
+// usa para outra coisa). Um $t que atravessa uma chamada é guardado e recarregado a cada 'jal',
+// enquanto um $s custa o mesmo uma única vez (no prólogo e no epílogo): os preservados vão de
+// preferência para os temporários que atravessam mais de uma chamada ou chamadas dentro de laços.
+
+#define NUM_REGISTRADORES_ALOCAVEIS 8
+#define MAX_REGISTRADORES_PRESERVADOS 6
+
+typedef struct Alocacao {
+    int num_temporarios;
+    Registrador* registrador;   // Por temporário: o registrador, ou REG_ZERO se ficou na memória.
+    int* slot;                  // Por temporário: a posição no quadro (-1 se está num registrador).
+    int* inicio;                // Intervalo de vida [inicio, fim] na numeração das instruções
+    int* fim;                   // (inicio > fim para temporários que nunca aparecem).
+    int num_slots;              // Quantas posições do quadro foram usadas.
+} Alocacao;
+
+// Numera as instruções da função (InstrucaoIR.numero e BlocoBasico.numero_terminador),
+// calcula a vivacidade e distribui os temporários.
+void aloca_registradores(FuncaoIR* funcao, Alocacao* alocacao,
+                         const Registrador* preservados, int num_preservados);
+void libera_alocacao(Alocacao* alocacao);
+
+// Indica se o temporário está vivo antes E depois da posição (ou seja, atravessa a instrução
+// ali, como uma chamada que destrói os registradores $t).
+int vivo_atraves(const Alocacao* alocacao, int temp, int posicao);
+
+#endif // ALOCACAO_H
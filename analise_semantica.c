@@ -1,17 +1,26 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
 #include "analise_semantica.h"
 #include "tabela_simbolos.h"
+#include "arena.h"      // Os vínculos ficam numa arena (endereços estáveis, liberação em massa).
 
 // --- Variáveis Globais Estáticas ---
 // 'static' significa que estas variáveis só são visíveis dentro deste arquivo.
 
 // A pilha de escopos é a estrutura de dados central para a análise semântica.
-static PilhaDeTabelas pilha_escopos;
-// Ponteiro para o símbolo da função que está sendo analisada no momento.
-// É usado para verificar se os comandos 'retorne' são compatíveis com a assinatura da função.
-static Simbolo* funcao_atual = NULL;
+static PilhaDeEscopos pilha_escopos;
+// Vínculo da função que está sendo analisada no momento (NULL fora de funções).
+// É usado para verificar se os comandos 'retorne' são compatíveis com a assinatura da função
+// e para acumular o tamanho do quadro com as variáveis locais declaradas nela.
+static Vinculo* funcao_atual = NULL;
+// Bytes do quadro da função ocupados pelos parâmetros e pelas variáveis dos blocos abertos no
+// momento. Ao fechar um bloco, as posições das variáveis dele voltam a ficar livres para os blocos
+// seguintes (que nunca estão vivos ao mesmo tempo); o quadro fica com o maior valor alcançado.
+static int quadro_ocupado = 0;
+// Bytes de variáveis locais que ficaram em posições já usadas por um bloco anterior (relatório).
+static int bytes_reaproveitados = 0;
+// Vínculos de todas as declarações.
+static Arena arena_vinculos = { .tamanho_bloco = 16 * 1024 };
 
 // Função de conveniência para reportar erros semânticos.
 // De acordo com a especificação do projeto, a compilação termina no primeiro erro encontrado.
@@ -21,12 +30,43 @@ void erro_semantico(const char* mensagem, int linha) {
     exit(1); // Encerra o programa com status de erro.
 }
 
-// Converte uma string de tipo (ex: "int") para o valor enum 'TipoDado' correspondente.
-TipoDado string_para_tipo(char* str) {
-    if (strcmp(str, "int") == 0) return TIPO_INT;
-    if (strcmp(str, "car") == 0) return TIPO_CAR;
-    if (strcmp(str, "void") == 0) return TIPO_VOID;
-    return TIPO_INDEFINIDO; // Retorna indefinido se a string não for um tipo válido.
+// Converte o átomo de um nome de tipo (ex: "int") para o valor enum 'TipoDado' correspondente.
+TipoDado atomo_para_tipo(Atomo nome_tipo) {
+    switch (nome_tipo) {
+        case ATOMO_INT: return TIPO_INT;
+        case ATOMO_CAR: return TIPO_CAR;
+        case ATOMO_VOID: return TIPO_VOID;
+        default: return TIPO_INDEFINIDO; // Retorna indefinido se o átomo não for um tipo válido.
+    }
+}
+
+// Cria um vínculo na arena com os campos comuns preenchidos e os demais zerados.
+static Vinculo* novo_vinculo(Atomo nome, CategoriaSimbolo categoria, ClasseArmazenamento classe,
+                             TipoDado tipo_dado, int linha) {
+    Vinculo* v = arena_alocar(&arena_vinculos, sizeof(Vinculo));
+    v->nome = nome;
+    v->categoria = categoria;
+    v->classe = classe;
+    v->tipo_dado = tipo_dado;
+    v->linha = linha;
+    v->deslocamento = 0;
+    v->registrador = 0;
+    v->peso_uso = 0;
+    v->constante_versao = 0;
+    v->constante_valor = 0;
+    v->numero_ssa = 0;
+    v->params = NULL;
+    v->num_params = 0;
+    v->tamanho_quadro = 0;
+    return v;
+}
+
+// Torna o vínculo visível no escopo atual.
+static void declarar(Vinculo* v) {
+    Simbolo s;
+    s.nome = v->nome;
+    s.vinculo = v;
+    inserir_na_pilha(&pilha_escopos, s);
 }
 
 // Protótipo da função 'visita_no'. Como as funções se chamam mutuamente (recursão mútua),
@@ -35,119 +75,112 @@ void visita_no(No* no);
 
 // Adiciona os símbolos das funções nativas da linguagem (leia, escreva) na tabela de símbolos global.
 void inicializar_simbolos_nativos() {
-    // Cria e insere o símbolo para a função 'leia'.
-    Simbolo s_leia;
-    strcpy(s_leia.nome, "leia");
-    s_leia.categoria = CAT_FUNCAO;
-    s_leia.tipo_dado = TIPO_VOID; // leia não retorna valor.
-    s_leia.num_params = 1;
-    s_leia.params = NULL; // A verificação de parâmetros de funções nativas pode ser simplificada.
-    inserir_na_pilha(&pilha_escopos, s_leia);
+    // 'leia' não retorna valor. A verificação de parâmetros de funções nativas pode ser simplificada
+    // (sem lista de parâmetros, apenas a quantidade).
+    Vinculo* v_leia = novo_vinculo(ATOMO_LEIA, CAT_FUNCAO, ARMAZ_NATIVA, TIPO_VOID, 0);
+    v_leia->num_params = 1;
+    declarar(v_leia);
 
     // Cria e insere o símbolo para a função 'escreva'.
-    Simbolo s_escreva;
-    strcpy(s_escreva.nome, "escreva");
-    s_escreva.categoria = CAT_FUNCAO;
-    s_escreva.tipo_dado = TIPO_VOID;
-    s_escreva.num_params = 1;
-    s_escreva.params = NULL;
-    inserir_na_pilha(&pilha_escopos, s_escreva);
+    Vinculo* v_escreva = novo_vinculo(ATOMO_ESCREVA, CAT_FUNCAO, ARMAZ_NATIVA, TIPO_VOID, 0);
+    v_escreva->num_params = 1;
+    declarar(v_escreva);
 
     // Cria e insere o símbolo para a função 'novalinha'.
-    Simbolo s_novalinha;
-    strcpy(s_novalinha.nome, "novalinha");
-    s_novalinha.categoria = CAT_FUNCAO;
-    s_novalinha.tipo_dado = TIPO_VOID;
-    s_novalinha.num_params = 0;
-    s_novalinha.params = NULL;
-    inserir_na_pilha(&pilha_escopos, s_novalinha);
+    declarar(novo_vinculo(ATOMO_NOVALINHA, CAT_FUNCAO, ARMAZ_NATIVA, TIPO_VOID, 0));
 }
 
 // Analisa um nó de declaração de variável.
 void analisa_declaracao_var(No* no) {
     // O nome da variável está no lexema do primeiro filho do nó de declaração.
-    char* nome_var = no->filho1->lexema;
+    Atomo nome_var = no->filho1->lexema;
     // Verifica se a variável já foi declarada NO ESCOPO ATUAL.
     if (buscar_no_escopo_atual(&pilha_escopos, nome_var)) {
         char msg[200];
-        sprintf(msg, "Variável ou parâmetro '%s' já declarado neste escopo.", nome_var);
+        snprintf(msg, sizeof(msg), "Variável ou parâmetro '%s' já declarado neste escopo.", texto_atomo(nome_var));
         erro_semantico(msg, no->linha);
     }
 
-    // Se não houve erro, cria um novo símbolo para a variável.
-    Simbolo s;
-    strcpy(s.nome, nome_var);
-    s.categoria = CAT_VARIAVEL;
-    // O tipo da variável está no lexema do próprio nó de declaração.
-    s.tipo_dado = string_para_tipo(no->lexema);
-    s.linha = no->linha;
-    s.params = NULL;
-    s.num_params = 0;
-
-    // Define o escopo do símbolo.
-    if (funcao_atual == NULL) { // Se não estamos dentro de uma função, é uma variável global.
-        s.escopo = 0; // Escopo global é 0.
-    } else { // Se estamos dentro de uma função, é uma variável local.
-        s.escopo = pilha_escopos.topo;
+    // Se não houve erro, cria o vínculo da variável. O tipo está no lexema do próprio nó de declaração.
+    Vinculo* v = novo_vinculo(nome_var, CAT_VARIAVEL, ARMAZ_GLOBAL, atomo_para_tipo(no->lexema), no->linha);
+
+    // Define onde a variável vive. Fora de funções (inclusive no bloco principal), na área
+    // global, que a geração de código arruma na seção .data (e só ela decide os endereços).
+    // Dentro de uma função (em qualquer bloco), no quadro: 4 bytes abaixo das variáveis dos
+    // blocos que a envolvem (irmãos já fechados podem ter usado a mesma posição).
+    if (funcao_atual != NULL) {
+        v->classe = ARMAZ_LOCAL;
+        quadro_ocupado += 4;
+        v->deslocamento = -quadro_ocupado;
+        if (quadro_ocupado > funcao_atual->tamanho_quadro) funcao_atual->tamanho_quadro = quadro_ocupado;
+        else bytes_reaproveitados += 4;
     }
 
-    // Insere o novo símbolo na tabela de símbolos do escopo atual.
-    inserir_na_pilha(&pilha_escopos, s);
+    // Insere o novo símbolo no escopo atual e anota a declaração.
+    declarar(v);
+    no->vinculo = v;
 }
 
 // Analisa um nó de declaração de função.
 void analisa_declaracao_funcao(No* no) {
-    char* nome_funcao = no->lexema;
+    Atomo nome_funcao = no->lexema;
     // Funções só podem ser declaradas no escopo global. Verifica se já existe um símbolo com esse nome.
     if (buscar_no_escopo_atual(&pilha_escopos, nome_funcao)) {
         char msg[200];
-        sprintf(msg, "Função ou variável '%s' já declarada.", nome_funcao);
+        snprintf(msg, sizeof(msg), "Função ou variável '%s' já declarada.", texto_atomo(nome_funcao));
         erro_semantico(msg, no->linha);
     }
 
-    // Cria o símbolo para a função.
-    Simbolo s_funcao;
-    strcpy(s_funcao.nome, nome_funcao);
-    s_funcao.categoria = CAT_FUNCAO;
-    s_funcao.tipo_dado = string_para_tipo(no->filho1->lexema); // Tipo de retorno.
-    s_funcao.linha = no->linha;
-    s_funcao.params = no->filho2; // Ponteiro para a lista de parâmetros na ASA.
+    // Cria o vínculo da função. O tipo de retorno está no primeiro filho.
+    Vinculo* v_funcao = novo_vinculo(nome_funcao, CAT_FUNCAO, ARMAZ_FUNCAO,
+                                     atomo_para_tipo(no->filho1->lexema), no->linha);
+    v_funcao->params = no->filho2; // Ponteiro para a lista de parâmetros na ASA.
     
     // Conta o número de parâmetros.
     int n_params = 0;
     for (No* p = no->filho2; p != NULL; p = p->proximo) n_params++;
-    s_funcao.num_params = n_params;
+    v_funcao->num_params = n_params;
 
     // Insere a função na tabela do escopo atual (global).
-    inserir_na_pilha(&pilha_escopos, s_funcao);
+    declarar(v_funcao);
+    no->vinculo = v_funcao;
     // Atualiza a variável global 'funcao_atual' para sabermos que estamos dentro desta função.
-    funcao_atual = buscar_no_escopo_atual(&pilha_escopos, nome_funcao);
+    funcao_atual = v_funcao;
 
     // --- Início do Escopo da Função ---
     // Cria um novo escopo para os parâmetros e o corpo da função.
     empilhar(&pilha_escopos);
 
     // Itera sobre a lista de parâmetros, adicionando-os como símbolos no novo escopo.
+    // Os primeiros chegam em registradores ($a0-$a3) e o prólogo os guarda no quadro, como as
+    // variáveis locais. Os demais o chamador empilha: o quinto fica logo acima do $fp e do $ra salvos.
+    int offset_param = 8;
+    int posicao = 0;
     for (No* p = no->filho2; p != NULL; p = p->proximo) {
         // Verifica se há parâmetros com nomes duplicados.
         if (buscar_no_escopo_atual(&pilha_escopos, p->filho1->lexema)){
             char msg[200];
-            sprintf(msg, "Parâmetro '%s' redeclarado na função '%s'.", p->filho1->lexema, nome_funcao);
+            snprintf(msg, sizeof(msg), "Parâmetro '%s' redeclarado na função '%s'.", texto_atomo(p->filho1->lexema), texto_atomo(nome_funcao));
             erro_semantico(msg, p->linha);
         }
         // Cria e insere o símbolo do parâmetro.
-        Simbolo s_param;
-        strcpy(s_param.nome, p->filho1->lexema);
-        s_param.categoria = CAT_PARAMETRO;
-        s_param.tipo_dado = string_para_tipo(p->lexema);
-        s_param.linha = p->linha;
-        s_param.params = NULL;
-        s_param.num_params = 0;
-        inserir_na_pilha(&pilha_escopos, s_param);
+        Vinculo* v_param = novo_vinculo(p->filho1->lexema, CAT_PARAMETRO, ARMAZ_PARAMETRO,
+                                        atomo_para_tipo(p->lexema), p->linha);
+        if (posicao++ < PARAMETROS_EM_REGISTRADORES) {
+            v_funcao->tamanho_quadro += 4;
+            v_param->deslocamento = -v_funcao->tamanho_quadro;
+        } else {
+            v_param->deslocamento = offset_param;
+            offset_param += 4; // Cada parâmetro ocupa 4 bytes.
+        }
+        declarar(v_param);
+        p->vinculo = v_param;
     }
 
     // Analisa recursivamente o corpo da função (que é um bloco).
+    quadro_ocupado = v_funcao->tamanho_quadro;
     visita_no(no->filho3);
+    quadro_ocupado = 0;
 
     // --- Fim do Escopo da Função ---
     // Fecha o escopo da função, removendo seus parâmetros e variáveis locais.
@@ -160,11 +193,13 @@ void analisa_declaracao_funcao(No* no) {
 void analisa_bloco(No* no) {
     // Abre um novo escopo para o bloco.
     empilhar(&pilha_escopos);
+    int marca_quadro = quadro_ocupado;
     // As declarações locais do bloco são o filho1. Visita cada uma delas.
     for (No* decl = no->filho1; decl != NULL; decl = decl->proximo) visita_no(decl);
     // Os comandos do bloco são o filho2. Visita cada um deles.
     for (No* cmd = no->filho2; cmd != NULL; cmd = cmd->proximo) visita_no(cmd);
 
+    quadro_ocupado = marca_quadro; // As posições das variáveis do bloco ficam livres.
     desempilhar(&pilha_escopos);
 }
 
@@ -175,12 +210,14 @@ void analisa_identificador(No* no) {
     // Se não encontrou, é um erro de "identificador não declarado".
     if (!s) {
         char msg[200];
-        sprintf(msg, "Identificador '%s' não declarado.", no->lexema);
+        snprintf(msg, sizeof(msg), "Identificador '%s' não declarado.", texto_atomo(no->lexema));
         erro_semantico(msg, no->linha);
     }
-    // Se encontrou, "anota" o nó da ASA com o tipo de dado do símbolo.
-    // Isso é fundamental para a checagem de tipos em expressões.
-    no->tipo_dado = s->tipo_dado;
+    // Se encontrou, "anota" o nó da ASA com o tipo de dado e o vínculo do símbolo.
+    // O tipo é fundamental para a checagem de tipos em expressões; o vínculo diz à
+    // geração de código onde a variável está, sem precisar procurá-la de novo.
+    no->tipo_dado = s->vinculo->tipo_dado;
+    no->vinculo = s->vinculo;
 }
 
 // Analisa um nó de atribuição (`=`).
@@ -260,42 +297,46 @@ void analisa_chamada_funcao(No* no) {
     // Busca a função na tabela de símbolos.
     Simbolo* s = buscar_em_todos_escopos(&pilha_escopos, no->lexema);
     if (!s) {
-        char msg[200]; sprintf(msg, "Função '%s' não declarada.", no->lexema);
+        char msg[200]; snprintf(msg, sizeof(msg), "Função '%s' não declarada.", texto_atomo(no->lexema));
         erro_semantico(msg, no->linha);
     }
     // Verifica se o identificador encontrado é de fato uma função.
-    if (s->categoria != CAT_FUNCAO) {
-        char msg[200]; sprintf(msg, "'%s' não é uma função.", no->lexema);
+    Vinculo* v = s->vinculo;
+    if (v->categoria != CAT_FUNCAO) {
+        char msg[200]; snprintf(msg, sizeof(msg), "'%s' não é uma função.", texto_atomo(no->lexema));
         erro_semantico(msg, no->linha);
     }
 
-    // O tipo do nó da chamada é o tipo de retorno da função.
-    no->tipo_dado = s->tipo_dado;
+    // O tipo do nó da chamada é o tipo de retorno da função; o vínculo dá sua assinatura.
+    no->tipo_dado = v->tipo_dado;
+    no->vinculo = v;
 
     // --- Checagem de Número e Tipos dos Argumentos ---
     No* arg = no->filho1;      // Ponteiro para o primeiro argumento na chamada.
-    No* param = s->params;     // Ponteiro para o primeiro parâmetro na declaração da função.
+    No* param = v->params;     // Ponteiro para o primeiro parâmetro na declaração da função.
     int n_args = 0;            // Contador de argumentos.
-    int n_params = s->num_params; // Número de parâmetros esperado.
+    int n_params = v->num_params; // Número de parâmetros esperado.
 
     // Itera enquanto houver argumentos e parâmetros para comparar.
     while(arg != NULL && param != NULL) {
         visita_no(arg); // Analisa o argumento para descobrir seu tipo.
         // Compara o tipo do argumento com o tipo esperado do parâmetro.
-        if (arg->tipo_dado != string_para_tipo(param->lexema)) {
-             char msg[200]; sprintf(msg, "Tipo do argumento na chamada da função '%s' não corresponde ao tipo do parâmetro.", no->lexema);
+        if (arg->tipo_dado != atomo_para_tipo(param->lexema)) {
+             char msg[200]; snprintf(msg, sizeof(msg), "Tipo do argumento na chamada da função '%s' não corresponde ao tipo do parâmetro.", texto_atomo(no->lexema));
              erro_semantico(msg, arg->linha);
         }
         n_args++;
         arg = arg->proximo;
         param = param->proximo;
     }
-    // Se, após o laço, ainda sobraram argumentos, conta-os.
-    if (arg != NULL) while(arg != NULL) { n_args++; arg = arg->proximo; }
+    // Se, após o laço, ainda sobraram argumentos, conta-os. Eles também são analisados,
+    // pois as funções nativas (leia, escreva) não têm lista de parâmetros e a geração de
+    // código depende do tipo anotado nos seus argumentos (ex: 'escreva' de um 'car').
+    while (arg != NULL) { visita_no(arg); n_args++; arg = arg->proximo; }
 
     // Compara o número de argumentos contados com o número de parâmetros esperado.
     if (n_args != n_params) {
-        char msg[200]; sprintf(msg, "Número incorreto de argumentos para a função '%s'. Esperado: %d, Recebido: %d.", no->lexema, n_params, n_args);
+        char msg[200]; snprintf(msg, sizeof(msg), "Número incorreto de argumentos para a função '%s'. Esperado: %d, Recebido: %d.", texto_atomo(no->lexema), n_params, n_args);
         erro_semantico(msg, no->linha);
     }
 }
@@ -384,4 +425,22 @@ int analisar(No* raiz_arvore) {
 
     // 5. Retorna 0. Se algum erro tivesse ocorrido, a função `erro_semantico` já teria encerrado o programa.
     return 0;
+}
+
+// Mostra a ocupação e o custo das buscas nas tabelas de símbolos usadas pela análise:
+// o escopo global (que continua na pilha) e o acumulado dos escopos já fechados.
+void imprime_estatisticas_analise(void) {
+    imprime_estatisticas_pilha(&pilha_escopos);
+    printf("Quadros: %d byte(s) de variáveis locais em posições reaproveitadas de blocos já fechados.\n",
+           bytes_reaproveitados);
+    printf("--- Vínculos ---\n");
+    arena_imprime_estatisticas(&arena_vinculos, "vínculos");
+    printf("----------------\n\n");
+}
+
+// Libera a tabela de símbolos e os vínculos. Deve ser chamada só depois da geração de código,
+// que lê os vínculos anotados na árvore.
+void liberar_analise(void) {
+    liberar_pilha(&pilha_escopos);
+    arena_liberar(&arena_vinculos);
 }
\ No newline at end of file
@@ -14,4 +14,10 @@
 // o valor de retorno é menos crítico, mas a assinatura é mantida.
 int analisar(No* raiz_arvore);
 
+// Imprime as estatísticas das tabelas de símbolos usadas pela análise (modo de depuração).
+void imprime_estatisticas_analise(void);
+
+// Libera a tabela de símbolos e os vínculos anotados na árvore (chamar após a geração de código).
+void liberar_analise(void);
+
 #endif // ANALISE_SEMANTICA_H
\ No newline at end of file
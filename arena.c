@@ -0,0 +1,94 @@
+#include <stdio.h>      // Para printf.
+#include <stdlib.h>     // Para malloc, free e exit.
+#include <string.h>     // Para memcpy.
+#include <stdint.h>     // Para uintptr_t (cálculo de alinhamento).
+#include "arena.h"
+
+// Alinhamento garantido para toda alocação. 16 bytes é suficiente para qualquer tipo básico.
+#define ALINHAMENTO_ARENA 16
+
+// Arredonda 'n' para o próximo múltiplo de 'alinhamento' (que deve ser potência de 2).
+static uintptr_t alinhar(uintptr_t n, uintptr_t alinhamento) {
+    return (n + alinhamento - 1) & ~(alinhamento - 1);
+}
+
+// Inicializa a arena sem reservar memória ainda.
+void arena_inicializar(Arena* arena, size_t tamanho_bloco) {
+    arena->atual = NULL;
+    arena->tamanho_bloco = tamanho_bloco;
+    arena->num_alocacoes = 0;
+    arena->bytes_alocados = 0;
+    arena->num_blocos = 0;
+    arena->bytes_reservados = 0;
+}
+
+// Obtém um novo bloco com pelo menos 'minimo' bytes livres e o torna o bloco atual.
+static void novo_bloco(Arena* arena, size_t minimo) {
+    // Pedidos maiores que o tamanho padrão recebem um bloco exclusivo do tamanho exato.
+    size_t capacidade = minimo > arena->tamanho_bloco ? minimo : arena->tamanho_bloco;
+    BlocoArena* bloco = malloc(sizeof(BlocoArena) + capacidade);
+    if (!bloco) {
+        printf("Erro: Falha de alocação de memória para bloco da arena.\n");
+        exit(1);
+    }
+    bloco->anterior = arena->atual;
+    bloco->usado = 0;
+    bloco->capacidade = capacidade;
+    arena->atual = bloco;
+    arena->num_blocos++;
+    arena->bytes_reservados += capacidade;
+}
+
+// Calcula o deslocamento alinhado da próxima alocação dentro de um bloco.
+static size_t inicio_alinhado(BlocoArena* bloco, size_t alinhamento) {
+    uintptr_t livre = (uintptr_t)(bloco->dados + bloco->usado);
+    return bloco->usado + (alinhar(livre, alinhamento) - livre);
+}
+
+// Entrega 'tamanho' bytes avançando o ponteiro do bloco atual, respeitando o alinhamento pedido.
+static void* alocar(Arena* arena, size_t tamanho, size_t alinhamento) {
+    // Se não houver bloco ou ele não tiver espaço suficiente, pede um novo
+    // (com folga para o alinhamento do início da área de dados).
+    if (!arena->atual || inicio_alinhado(arena->atual, alinhamento) + tamanho > arena->atual->capacidade) {
+        novo_bloco(arena, tamanho + alinhamento);
+    }
+    size_t inicio = inicio_alinhado(arena->atual, alinhamento);
+    void* ptr = arena->atual->dados + inicio;
+    arena->atual->usado = inicio + tamanho;
+
+    arena->num_alocacoes++;
+    arena->bytes_alocados += tamanho;
+    return ptr;
+}
+
+// Aloca memória alinhada para qualquer tipo (usada para estruturas como 'No').
+void* arena_alocar(Arena* arena, size_t tamanho) {
+    return alocar(arena, tamanho, ALINHAMENTO_ARENA);
+}
+
+// Copia 'tamanho' caracteres de 'texto' para a arena, terminando com '\0'.
+// Strings não precisam de alinhamento, então ficam coladas umas às outras no bloco.
+char* arena_copia_string(Arena* arena, const char* texto, size_t tamanho) {
+    char* copia = alocar(arena, tamanho + 1, 1);
+    memcpy(copia, texto, tamanho);
+    copia[tamanho] = '\0';
+    return copia;
+}
+
+// Libera todos os blocos de uma só vez, percorrendo a lista do mais novo para o mais antigo.
+void arena_liberar(Arena* arena) {
+    BlocoArena* bloco = arena->atual;
+    while (bloco) {
+        BlocoArena* anterior = bloco->anterior;
+        free(bloco);
+        bloco = anterior;
+    }
+    arena_inicializar(arena, arena->tamanho_bloco);
+}
+
+// Mostra quantas alocações a arena atendeu e quanta memória ela precisou reservar.
+void arena_imprime_estatisticas(const Arena* arena, const char* nome) {
+    printf("  %-10s %8zu alocações, %10zu bytes pedidos, %4zu bloco(s), %10zu bytes reservados\n",
+           nome, arena->num_alocacoes, arena->bytes_alocados,
+           arena->num_blocos, arena->bytes_reservados);
+}
@@ -0,0 +1,47 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>     // Para o tipo size_t.
+
+// --- Alocador por Arena (Bump-Pointer) ---
+// Uma arena reserva grandes blocos de memória e entrega pedaços deles sequencialmente,
+// apenas avançando um ponteiro ("bump"). Não existe liberação individual: toda a memória
+// da arena é devolvida de uma só vez ao final da unidade de compilação.
+// Isso troca milhares de chamadas a malloc/free por poucas alocações grandes.
+
+// Um bloco (chunk) de memória da arena. Os blocos formam uma lista ligada.
+typedef struct BlocoArena {
+    struct BlocoArena* anterior; // Bloco alocado antes deste (usado na liberação em massa).
+    size_t usado;                // Quantos bytes de 'dados' já foram entregues.
+    size_t capacidade;           // Tamanho total de 'dados'.
+    char dados[];                // Área de memória propriamente dita (flexible array member).
+} BlocoArena;
+
+// Estrutura de controle de uma arena.
+typedef struct Arena {
+    BlocoArena* atual;           // Bloco de onde as próximas alocações serão feitas.
+    size_t tamanho_bloco;        // Tamanho padrão de cada novo bloco.
+
+    // --- Estatísticas (para medir o ganho em relação a malloc individual) ---
+    size_t num_alocacoes;        // Número de pedidos atendidos pela arena.
+    size_t bytes_alocados;       // Soma dos bytes pedidos (sem contar alinhamento).
+    size_t num_blocos;           // Número de blocos obtidos com malloc.
+    size_t bytes_reservados;     // Soma da capacidade de todos os blocos.
+} Arena;
+
+// Prepara uma arena vazia. Nenhuma memória é reservada até a primeira alocação.
+void arena_inicializar(Arena* arena, size_t tamanho_bloco);
+
+// Aloca 'tamanho' bytes alinhados para qualquer tipo. Aborta o programa se faltar memória.
+void* arena_alocar(Arena* arena, size_t tamanho);
+
+// Copia uma string (com até 'tamanho' caracteres) para dentro da arena.
+char* arena_copia_string(Arena* arena, const char* texto, size_t tamanho);
+
+// Devolve de uma vez toda a memória da arena e zera suas estatísticas.
+void arena_liberar(Arena* arena);
+
+// Imprime as estatísticas de uso da arena (usado no modo de depuração).
+void arena_imprime_estatisticas(const Arena* arena, const char* nome);
+
+#endif // ARENA_H
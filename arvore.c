@@ -1,34 +1,40 @@
 #include <stdio.h>      // Para funções de entrada e saída, como printf.
-#include <stdlib.h>     // Para alocação de memória (malloc, free) e para a função exit.
-#include <string.h>     // Para funções de manipulação de strings, como strdup.
+#include <stdlib.h>     // Para strtol.
 #include "arvore.h"     // Inclui as definições das estruturas e enums que serão usadas aqui.
+#include "arena.h"      // Alocador por arena usado para os nós.
+
+// --- Arena da Unidade de Compilação ---
+// Todos os nós da ASA saem de 'arena_nos', liberada em massa por `libera_arvores`.
+// Os lexemas não precisam de memória própria: são átomos da tabela de internamento.
+static Arena arena_nos = { .tamanho_bloco = 64 * 1024 };
+
+// Retorna o valor de uma constante inteira ou caractere (ex: "123" -> 123, "'a'" -> 97).
+int valor_constante(const No* no) {
+    const char* texto = texto_atomo(no->lexema);
+    if (no->tipo_no == NO_CONST_CAR) {
+        return (unsigned char)texto[1]; // O caractere fica entre as aspas simples.
+    }
+    return (int)strtol(texto, NULL, 10);
+}
 
 // Função para criar um novo nó da árvore.
 // Esta é uma função "fábrica" que simplifica a criação de nós.
-No* cria_no(TipoNo tipo_no, int linha, char* lexema) {
-    // Aloca memória do tamanho de uma estrutura 'No'.
-    No* novo_no = (No*) malloc(sizeof(No));
-    // Verifica se a alocação de memória foi bem-sucedida. Se não, o programa é encerrado.
-    if (!novo_no) {
-        printf("Erro: Falha de alocação de memória para novo nó.\n");
-        exit(1);
-    }
+No* cria_no(TipoNo tipo_no, int linha, Atomo lexema) {
+    // Reserva espaço para a estrutura 'No' na arena (a arena aborta o programa se faltar memória).
+    No* novo_no = arena_alocar(&arena_nos, sizeof(No));
 
     // Inicializa os campos do nó com os valores passados como parâmetros.
     novo_no->tipo_no = tipo_no;
     novo_no->linha = linha;
     // O tipo de dado é inicialmente indefinido. A análise semântica irá preencher este campo.
     novo_no->tipo_dado = TIPO_INDEFINIDO;
+    novo_no->vinculo = NULL;
+    novo_no->registradores = 0;
+    novo_no->tem_efeitos = 0;
 
-    // Se um lexema foi fornecido (ex: um nome de variável ou um número)...
-    if (lexema != NULL) {
-        // `strdup` cria uma cópia da string 'lexema' em uma nova área de memória.
-        // Isso é crucial porque o buffer original do analisador léxico (yytext) pode ser sobrescrito.
-        novo_no->lexema = strdup(lexema);
-    } else {
-        // Se não houver lexema, o ponteiro é definido como NULL.
-        novo_no->lexema = NULL;
-    }
+    // Guarda o átomo do lexema (ou ATOMO_NULO). O analisador léxico já internou o texto,
+    // então o buffer 'yytext' pode ser sobrescrito à vontade.
+    novo_no->lexema = lexema;
 
     // Inicializa todos os ponteiros de filhos e do próximo nó como NULL.
     // Os filhos serão adicionados posteriormente conforme a árvore é construída.
@@ -57,43 +63,6 @@ void adiciona_filho(No* pai, No* filho) {
     // Isso assume que a gramática da linguagem não precisa de mais de 4 filhos diretos.
 }
 
-No* copia_arvore(No* raiz) {
-    // Condição de parada da recursão: se o nó original é nulo, a cópia também é.
-    if (raiz == NULL) {
-        return NULL;
-    }
-
-    // Aloca memória para o novo nó da cópia.
-    No* novo_no = (No*) malloc(sizeof(No));
-    if (!novo_no) {
-        printf("Erro: Falha de alocação de memória para cópia do nó.\n");
-        exit(1);
-    }
-
-    // Copia os valores do nó original para o novo nó.
-    novo_no->tipo_no = raiz->tipo_no;
-    novo_no->tipo_dado = raiz->tipo_dado; // Copia o tipo, mesmo que seja INDEFINIDO.
-    novo_no->linha = raiz->linha;
-
-    // Se houver um lexema, cria uma cópia separada dele na memória.
-    // Isso é crucial para uma cópia profunda.
-    if (raiz->lexema != NULL) {
-        novo_no->lexema = strdup(raiz->lexema);
-    } else {
-        novo_no->lexema = NULL;
-    }
-
-    // Chama recursivamente a função de cópia para todos os filhos e para o próximo irmão.
-    novo_no->filho1 = copia_arvore(raiz->filho1);
-    novo_no->filho2 = copia_arvore(raiz->filho2);
-    novo_no->filho3 = copia_arvore(raiz->filho3);
-    novo_no->filho4 = copia_arvore(raiz->filho4);
-    novo_no->proximo = copia_arvore(raiz->proximo);
-
-    // Retorna o ponteiro para o nó recém-copiado.
-    return novo_no;
-}
-
 // Função recursiva para imprimir a árvore (usada para depuração).
 void imprime_arvore(No* no, int profundidade) {
     // Condição de parada da recursão: se o nó é nulo, não há nada a fazer.
@@ -111,26 +80,26 @@ void imprime_arvore(No* no, int profundidade) {
     switch(no->tipo_no) {
         case NO_PROGRAMA: printf("Programa\n"); break;
         case NO_LISTA_DECLARACOES: printf("ListaDeclaracoes\n"); break;
-        case NO_DECL_VAR: printf("DeclaracaoVariavel (Tipo: %s)\n", no->lexema); break;
-        case NO_DECL_FUNCAO: printf("DeclaracaoFuncao: %s\n", no->lexema); break;
+        case NO_DECL_VAR: printf("DeclaracaoVariavel (Tipo: %s)\n", texto_atomo(no->lexema)); break;
+        case NO_DECL_FUNCAO: printf("DeclaracaoFuncao: %s\n", texto_atomo(no->lexema)); break;
         case NO_LISTA_PARAM: printf("ListaParametros\n"); break;
         // Para um parâmetro, o tipo está no nó pai (lexema) e o nome no filho1.
-        case NO_PARAM: printf("Parametro: %s (Tipo: %s)\n", no->filho1->lexema, no->lexema); break;
+        case NO_PARAM: printf("Parametro: %s (Tipo: %s)\n", texto_atomo(no->filho1->lexema), texto_atomo(no->lexema)); break;
         case NO_BLOCO: printf("Bloco\n"); break;
         case NO_LISTA_COMANDOS: printf("ListaComandos\n"); break;
         case NO_IF: printf("If\n"); break;
         case NO_WHILE: printf("While\n"); break;
         case NO_ATRIBUICAO: printf("Atribuicao\n"); break;
         case NO_RETORNO: printf("Retorno\n"); break;
-        case NO_CHAMADA_FUNCAO: printf("ChamadaFuncao: %s\n", no->lexema); break;
+        case NO_CHAMADA_FUNCAO: printf("ChamadaFuncao: %s\n", texto_atomo(no->lexema)); break;
         case NO_LISTA_ARGS: printf("ListaArgumentos\n"); break;
         case NO_NEGACAO: printf("Negacao\n"); break;
-        case NO_OP_LOGICO: printf("OpLogico: %s\n", no->lexema); break;
-        case NO_OP_RELACIONAL: printf("OpRelacional: %s\n", no->lexema); break;
-        case NO_OP_ARITMETICO: printf("OpAritmetico: %s\n", no->lexema); break;
-        case NO_IDENTIFICADOR: printf("ID: %s\n", no->lexema); break;
-        case NO_CONST_INT: printf("ConstInt: %s\n", no->lexema); break;
-        case NO_CONST_CAR: printf("ConstCar: %s\n", no->lexema); break;
+        case NO_OP_LOGICO: printf("OpLogico: %s\n", texto_atomo(no->lexema)); break;
+        case NO_OP_RELACIONAL: printf("OpRelacional: %s\n", texto_atomo(no->lexema)); break;
+        case NO_OP_ARITMETICO: printf("OpAritmetico: %s\n", texto_atomo(no->lexema)); break;
+        case NO_IDENTIFICADOR: printf("ID: %s\n", texto_atomo(no->lexema)); break;
+        case NO_CONST_INT: printf("ConstInt: %s\n", texto_atomo(no->lexema)); break;
+        case NO_CONST_CAR: printf("ConstCar: %s\n", texto_atomo(no->lexema)); break;
         default: printf("Nó desconhecido\n"); break;
     }
 
@@ -145,23 +114,15 @@ void imprime_arvore(No* no, int profundidade) {
 }
 
 
-// Libera a memória alocada para a árvore de forma recursiva.
-void libera_arvore(No* raiz) {
-    // Condição de parada da recursão.
-    if (raiz == NULL) return;
-
-    // Usa um percurso em pós-ordem: primeiro libera os descendentes, depois o próprio nó.
-    // Isso evita "ponteiros perdidos" (dangling pointers).
-    libera_arvore(raiz->filho1);
-    libera_arvore(raiz->filho2);
-    libera_arvore(raiz->filho3);
-    libera_arvore(raiz->filho4);
-    libera_arvore(raiz->proximo);
+// Libera toda a memória das árvores de uma só vez.
+// Não é preciso percorrer a árvore: basta devolver os blocos da arena.
+void libera_arvores(void) {
+    arena_liberar(&arena_nos);
+}
 
-    // Se o nó continha um lexema (copiado com strdup), a memória dele também precisa ser liberada.
-    if (raiz->lexema) {
-        free(raiz->lexema);
-    }
-    // Finalmente, libera a memória da própria estrutura do nó.
-    free(raiz);
-}
\ No newline at end of file
+// Imprime as estatísticas de alocação da arena de nós.
+void imprime_estatisticas_arvore(void) {
+    printf("--- Memória da Árvore Sintática ---\n");
+    arena_imprime_estatisticas(&arena_nos, "nós");
+    printf("-----------------------------------\n\n");
+}
@@ -1,6 +1,8 @@
 #ifndef ARVORE_H
 #define ARVORE_H
 
+#include "atomos.h" // Os lexemas dos nós são átomos da tabela de internamento.
+
 // --- Início das "Include Guards" ---
 // O bloco #ifndef/#define/#endif é um mecanismo padrão em C para evitar que o conteúdo
 // deste arquivo de cabeçalho seja incluído mais de uma vez em um mesmo arquivo de código.
@@ -55,10 +57,16 @@ typedef enum {
 typedef struct No {
     // --- Campos de Identificação do Nó ---
     TipoNo tipo_no;     // Guarda o tipo do nó (ex: NO_IF, NO_DECL_VAR), definido na enumeração `TipoNo`.
-    char* lexema;       // Armazena o texto (lexema) associado ao nó, como o nome de uma variável ("x")
-                        // ou o valor de uma constante ("123"). É NULL para nós que não têm lexema (ex: NO_BLOCO).
+    Atomo lexema;       // Átomo do texto (lexema) associado ao nó, como o nome de uma variável ("x")
+                        // ou o valor de uma constante ("123"). É ATOMO_NULO para nós sem lexema (ex: NO_BLOCO).
+                        // O texto é obtido com `texto_atomo`; comparar lexemas é comparar inteiros.
     TipoDado tipo_dado; // Armazena o tipo de dado do nó (ex: TIPO_INT). É preenchido durante a análise semântica.
     int linha;          // Armazena o número da linha no código-fonte onde este nó se origina. Essencial para mensagens de erro.
+    struct Vinculo* vinculo; // Declaração resolvida pela análise semântica (identificadores, chamadas e
+                        // declarações). NULL nos demais nós.
+    int registradores;  // Expressões: número de Sethi-Ullman (registradores temporários necessários para
+                        // avaliar a subárvore). Calculado sob demanda pela geração do código intermediário; 0 = ainda não calculado.
+    int tem_efeitos;    // Expressões: 1 se a subárvore contém chamada de função ou atribuição (preenchido junto).
 
     // --- Ponteiros para a Estrutura da Árvore ---
     // Filhos da árvore. Usamos até 4 ponteiros para cobrir todas as estruturas da nossa linguagem.
@@ -77,8 +85,11 @@ typedef struct No {
 // Estas são as "promessas" das funções que estão implementadas no arquivo arvore.c.
 // Elas permitem que outros arquivos (.c) usem estas funções.
 
-// Aloca memória e cria um novo nó da árvore.
-No* cria_no(TipoNo tipo_no, int linha, char* lexema);
+// Aloca memória (na arena de nós) e cria um novo nó da árvore.
+No* cria_no(TipoNo tipo_no, int linha, Atomo lexema);
+
+// Retorna o valor de um nó NO_CONST_INT ou NO_CONST_CAR (que não seja cadeia).
+int valor_constante(const No* no);
 
 // Adiciona um nó 'filho' à estrutura de um nó 'pai'.
 void adiciona_filho(No* pai, No* filho);
@@ -86,10 +97,11 @@ void adiciona_filho(No* pai, No* filho);
 // Imprime a árvore no console (usado para depuração).
 void imprime_arvore(No* raiz, int profundidade);
 
-// Libera toda a memória alocada para a árvore recursivamente.
-void libera_arvore(No* raiz);
+// Libera de uma só vez toda a memória de nós da unidade de compilação.
+// Substitui a antiga liberação recursiva nó a nó.
+void libera_arvores(void);
 
-// Cria uma cópia profunda (deep copy) de uma árvore.
-No* copia_arvore(No* raiz);
+// Imprime quantas alocações e bytes a arena da árvore consumiu (modo de depuração).
+void imprime_estatisticas_arvore(void);
 
 #endif // ARVORE_H
\ No newline at end of file
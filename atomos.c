@@ -0,0 +1,125 @@
+#include <stdio.h>      // Para printf.
+#include <stdlib.h>     // Para malloc, realloc, calloc, free e exit.
+#include <string.h>     // Para strlen e memcmp.
+#include "atomos.h"
+#include "arena.h"      // Os textos dos átomos ficam numa arena de strings.
+
+// --- Estado da Tabela de Átomos ---
+// 'textos[a]' e 'tamanhos[a]' descrevem o átomo 'a'. O índice de busca é uma tabela de hash
+// com endereçamento aberto cujas posições guardam números de átomos (0 = posição vazia,
+// o que funciona porque ATOMO_NULO nunca é inserido no índice).
+static const char** textos = NULL;     // Texto de cada átomo (na arena).
+static size_t* tamanhos = NULL;        // Tamanho de cada texto (evita strlen nas comparações).
+static unsigned int* hashes = NULL;    // Hash de cada texto (evita recalcular ao crescer o índice).
+static int num_atomos = 0;             // Quantidade de átomos já criados (inclui ATOMO_NULO).
+static int capacidade_atomos = 0;      // Tamanho alocado dos vetores acima.
+
+static Atomo* indice = NULL;           // Tabela de hash: posição -> átomo.
+static unsigned int capacidade_indice = 0; // Sempre uma potência de 2.
+
+static Arena arena_textos = { .tamanho_bloco = 16 * 1024 };
+
+// Textos dos átomos predefinidos, na mesma ordem do enum em atomos.h.
+static const char* const textos_predefinidos[NUM_ATOMOS_PREDEFINIDOS] = {
+    "", "int", "car", "void", "leia", "escreva", "novalinha",
+    "e", "ou", "==", "!=", "<", "<=", ">", ">=",
+    "+", "-", "*", "/", "!", "-1"
+};
+
+// Função de hash FNV-1a (32 bits): simples e com boa dispersão para identificadores curtos.
+static unsigned int hash_texto(const char* texto, size_t tamanho) {
+    unsigned int h = 2166136261u;
+    for (size_t i = 0; i < tamanho; i++) {
+        h ^= (unsigned char)texto[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Dobra o índice de hash e reinsere todos os átomos existentes.
+static void crescer_indice(void) {
+    unsigned int nova_capacidade = capacidade_indice ? capacidade_indice * 2 : 256;
+    Atomo* novo = calloc(nova_capacidade, sizeof(Atomo));
+    if (!novo) {
+        printf("Erro: Falha de alocação de memória para tabela de átomos.\n");
+        exit(1);
+    }
+    for (Atomo a = 1; a < num_atomos; a++) {
+        unsigned int pos = hashes[a] & (nova_capacidade - 1);
+        while (novo[pos] != 0) pos = (pos + 1) & (nova_capacidade - 1); // Sondagem linear.
+        novo[pos] = a;
+    }
+    free(indice);
+    indice = novo;
+    capacidade_indice = nova_capacidade;
+}
+
+// Acrescenta um novo átomo aos vetores de descrição, crescendo-os se necessário.
+static Atomo novo_atomo(const char* texto, size_t tamanho, unsigned int h) {
+    if (num_atomos == capacidade_atomos) {
+        capacidade_atomos = capacidade_atomos ? capacidade_atomos * 2 : 256;
+        textos = realloc(textos, capacidade_atomos * sizeof(*textos));
+        tamanhos = realloc(tamanhos, capacidade_atomos * sizeof(*tamanhos));
+        hashes = realloc(hashes, capacidade_atomos * sizeof(*hashes));
+        if (!textos || !tamanhos || !hashes) {
+            printf("Erro: Falha de alocação de memória para tabela de átomos.\n");
+            exit(1);
+        }
+    }
+    Atomo a = num_atomos++;
+    textos[a] = arena_copia_string(&arena_textos, texto, tamanho);
+    tamanhos[a] = tamanho;
+    hashes[a] = h;
+    return a;
+}
+
+// Registra os átomos predefinidos (uma única vez).
+void inicializar_atomos(void) {
+    if (num_atomos > 0) return; // Já inicializada.
+    novo_atomo("", 0, 0); // ATOMO_NULO: ocupa o número 0, mas não entra no índice.
+    for (int i = 1; i < NUM_ATOMOS_PREDEFINIDOS; i++) {
+        interna(textos_predefinidos[i], strlen(textos_predefinidos[i]));
+    }
+}
+
+// Busca o texto no índice; se não existir, cria um novo átomo para ele.
+Atomo interna(const char* texto, size_t tamanho) {
+    if (num_atomos == 0) inicializar_atomos();
+    // Mantém o fator de carga do índice abaixo de 50%, o que deixa as sondagens curtas.
+    if ((unsigned int)num_atomos * 2 >= capacidade_indice) crescer_indice();
+
+    unsigned int h = hash_texto(texto, tamanho);
+    unsigned int pos = h & (capacidade_indice - 1);
+    while (indice[pos] != 0) {
+        Atomo a = indice[pos];
+        if (hashes[a] == h && tamanhos[a] == tamanho && memcmp(textos[a], texto, tamanho) == 0) {
+            return a; // Texto já internado.
+        }
+        pos = (pos + 1) & (capacidade_indice - 1);
+    }
+    Atomo a = novo_atomo(texto, tamanho, h);
+    indice[pos] = a;
+    return a;
+}
+
+// Retorna o texto do átomo.
+const char* texto_atomo(Atomo atomo) {
+    return textos[atomo];
+}
+
+// Devolve toda a memória da tabela de átomos.
+void liberar_atomos(void) {
+    free(textos); free(tamanhos); free(hashes); free(indice);
+    textos = NULL; tamanhos = NULL; hashes = NULL; indice = NULL;
+    num_atomos = capacidade_atomos = 0;
+    capacidade_indice = 0;
+    arena_liberar(&arena_textos);
+}
+
+// Estatísticas de uso da tabela de átomos.
+void imprime_estatisticas_atomos(void) {
+    printf("--- Tabela de Átomos ---\n");
+    printf("  %d átomos distintos, índice com %u posições\n", num_atomos - 1, capacidade_indice);
+    arena_imprime_estatisticas(&arena_textos, "textos");
+    printf("------------------------\n\n");
+}
@@ -0,0 +1,64 @@
+#ifndef ATOMOS_H
+#define ATOMOS_H
+
+#include <stddef.h> // Para o tipo size_t.
+
+// --- Tabela Global de Internamento de Strings ---
+// Todo identificador, operador e literal do programa é "internado": a primeira vez que um
+// texto aparece ele recebe um número inteiro único (o átomo); as ocorrências seguintes do
+// mesmo texto recebem o mesmo número. Assim, comparar dois nomes vira uma comparação de
+// inteiros, e o texto de cada nome é guardado uma única vez.
+typedef int Atomo;
+
+// Átomos predefinidos. Eles são registrados nesta ordem por `inicializar_atomos`, então
+// seus valores são constantes conhecidas em tempo de compilação e podem ser usados em 'switch'.
+enum {
+    ATOMO_NULO = 0,       // Ausência de lexema (ex: nós de bloco). Não corresponde a texto algum.
+
+    // Nomes de tipos.
+    ATOMO_INT,            // "int"
+    ATOMO_CAR,            // "car"
+    ATOMO_VOID,           // "void"
+
+    // Funções nativas da linguagem.
+    ATOMO_LEIA,           // "leia"
+    ATOMO_ESCREVA,        // "escreva"
+    ATOMO_NOVALINHA,      // "novalinha"
+
+    // Operadores lógicos e relacionais (que chegam do analisador léxico com lexema).
+    ATOMO_E,              // "e"
+    ATOMO_OU,             // "ou"
+    ATOMO_IGUAL,          // "=="
+    ATOMO_DIFERENTE,      // "!="
+    ATOMO_MENOR,          // "<"
+    ATOMO_MENOR_IGUAL,    // "<="
+    ATOMO_MAIOR,          // ">"
+    ATOMO_MAIOR_IGUAL,    // ">="
+
+    // Operadores aritméticos e unários (criados pelo analisador sintático).
+    ATOMO_MAIS,           // "+"
+    ATOMO_MENOS,          // "-"
+    ATOMO_VEZES,          // "*"
+    ATOMO_DIVIDIDO,       // "/"
+    ATOMO_NEGACAO,        // "!"
+    ATOMO_MENOS_UM,       // "-1" (usado para representar o menos unário como multiplicação)
+
+    NUM_ATOMOS_PREDEFINIDOS
+};
+
+// Registra os átomos predefinidos. Deve ser chamada antes da análise léxica.
+void inicializar_atomos(void);
+
+// Retorna o átomo do texto (com 'tamanho' caracteres), criando-o se ainda não existir.
+Atomo interna(const char* texto, size_t tamanho);
+
+// Retorna o texto de um átomo. O ponteiro vale até `liberar_atomos`.
+const char* texto_atomo(Atomo atomo);
+
+// Libera a tabela de átomos e todos os textos internados.
+void liberar_atomos(void);
+
+// Imprime quantos átomos existem e quanta memória eles ocupam (modo de depuração).
+void imprime_estatisticas_atomos(void);
+
+#endif // ATOMOS_H
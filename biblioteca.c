@@ -0,0 +1,269 @@
+#include <string.h>     // Para strncmp.
+#include "biblioteca.h"
+
+#define TAMANHO_SAIDA 1024      // Bytes do buffer de saída.
+#define TAMANHO_ENTRADA 256     // Bytes lidos de uma vez pelo 'read_string' (uma linha).
+#define MAIOR_INTEIRO 11        // Caracteres de "-2147483648".
+
+#define TEXTO(x) #x
+#define DIRETIVA_ESPACO(n) "  .space " TEXTO(n)
+
+// Registradores de trabalho das rotinas (além de $v0, $a0 e $a1).
+#define PONTEIRO REG_T8
+#define AUXILIAR REG_T9
+
+static CodigoMips* codigo;
+
+static const char* nomes_rotinas[NUM_ROTINAS] = {
+    [ROTINA_ESCREVA_INTEIRO] = "bib.escreva_int",
+    [ROTINA_ESCREVA_CARACTERE] = "bib.escreva_car",
+    [ROTINA_ESCREVA_CADEIA] = "bib.escreva_cadeia",
+    [ROTINA_LEIA_INTEIRO] = "bib.leia_int",
+    [ROTINA_DESCARREGA] = "bib.descarrega",
+};
+
+Rotulo rotulo_rotina(RotinaBiblioteca rotina) {
+    return rotulo_nome(nomes_rotinas[rotina]);
+}
+
+int eh_rotina_da_biblioteca(Rotulo rotulo) {
+    return rotulo.prefixo && strncmp(rotulo.prefixo, "bib.", 4) == 0;
+}
+
+static Rotulo r(const char* nome) {
+    return rotulo_nome(nome);
+}
+
+// Empilha (ou desempilha) os registradores em 'regs', o primeiro no topo.
+static void empilha(const Registrador* regs, int n) {
+    emite_i(codigo, OP_ADDIU, REG_SP, REG_SP, -4 * n);
+    for (int i = 0; i < n; i++) emite_mem(codigo, OP_SW, regs[i], 4 * i, REG_SP);
+}
+
+static void desempilha(const Registrador* regs, int n) {
+    for (int i = 0; i < n; i++) emite_mem(codigo, OP_LW, regs[i], 4 * i, REG_SP);
+    emite_i(codigo, OP_ADDIU, REG_SP, REG_SP, 4 * n);
+}
+
+
+// --- Rotinas ---
+
+// Entra com o novo fim do texto em PONTEIRO e o endereço de bib.saida_proximo em AUXILIAR.
+// Guarda o ponteiro e, se o buffer encheu, segue para bib.descarrega.
+// bib.descarrega: escreve o conteúdo do buffer (se houver) com um único 'print_string'.
+// Preserva $a0 e $a1.
+static void emite_descarrega(void) {
+    emite_rotulo(codigo, r("bib.guarda_proximo"));
+    emite_mem(codigo, OP_SW, PONTEIRO, 0, AUXILIAR);
+    emite_la(codigo, REG_V0, r("bib.saida_fim"));
+    emite_desvio_comparacao(codigo, OP_BGE, PONTEIRO, REG_V0, rotulo_rotina(ROTINA_DESCARREGA));
+    emite_jr(codigo, REG_RA);
+
+    emite_rotulo(codigo, rotulo_rotina(ROTINA_DESCARREGA));
+    emite_la(codigo, AUXILIAR, r("bib.saida_proximo"));
+    emite_mem(codigo, OP_LW, PONTEIRO, 0, AUXILIAR);
+    emite_la(codigo, REG_V0, r("bib.saida"));
+    emite_desvio_comparacao(codigo, OP_BEQ, PONTEIRO, REG_V0, r("bib.descarrega_fim")); // Buffer vazio.
+    emite_mem(codigo, OP_SB, REG_ZERO, 0, PONTEIRO);        // Termina a cadeia.
+    emite_mem(codigo, OP_SW, REG_V0, 0, AUXILIAR);          // O buffer volta a ficar vazio.
+    emite_move(codigo, AUXILIAR, REG_A0);
+    emite_move(codigo, REG_A0, REG_V0);
+    emite_li(codigo, REG_V0, 4);                            // Código de serviço 4 (print_string).
+    emite_syscall(codigo);
+    emite_move(codigo, REG_A0, AUXILIAR);
+    emite_rotulo(codigo, r("bib.descarrega_fim"));
+    emite_jr(codigo, REG_RA);
+}
+
+// $a0: o caractere. O caractere 0 terminaria a cadeia escrita por bib.descarrega: ele é
+// escrito à parte ('print_character'), depois do que já estava no buffer.
+static void emite_escreva_caractere(void) {
+    static const Registrador salvos[] = {REG_RA};
+    emite_rotulo(codigo, rotulo_rotina(ROTINA_ESCREVA_CARACTERE));
+    emite_beqz(codigo, REG_A0, r("bib.escreva_car_zero"));
+    emite_la(codigo, AUXILIAR, r("bib.saida_proximo"));
+    emite_mem(codigo, OP_LW, PONTEIRO, 0, AUXILIAR);
+    emite_mem(codigo, OP_SB, REG_A0, 0, PONTEIRO);
+    emite_i(codigo, OP_ADDIU, PONTEIRO, PONTEIRO, 1);
+    emite_desvio(codigo, OP_J, r("bib.guarda_proximo"));
+    emite_rotulo(codigo, r("bib.escreva_car_zero"));
+    empilha(salvos, 1);
+    emite_desvio(codigo, OP_JAL, rotulo_rotina(ROTINA_DESCARREGA));
+    desempilha(salvos, 1);
+    emite_li(codigo, REG_V0, 11);                           // Código de serviço 11 (print_character).
+    emite_syscall(codigo);
+    emite_jr(codigo, REG_RA);
+}
+
+// $a0: o inteiro. Os algarismos são tirados do valor negativo (o de -2147483648 não tem
+// positivo), do menos para o mais significativo, e depois postos na ordem.
+static void emite_escreva_inteiro(void) {
+    static const Registrador salvos[] = {REG_A2, REG_RA};
+    emite_rotulo(codigo, rotulo_rotina(ROTINA_ESCREVA_INTEIRO));
+    empilha(salvos, 2);
+    emite_la(codigo, AUXILIAR, r("bib.saida_proximo"));
+    emite_mem(codigo, OP_LW, PONTEIRO, 0, AUXILIAR);
+    emite_la(codigo, REG_V0, r("bib.saida_fim"));
+    emite_r(codigo, OP_SUB, REG_V0, REG_V0, PONTEIRO);      // Bytes livres.
+    emite_desvio_comparacao_i(codigo, OP_BGE, REG_V0, MAIOR_INTEIRO, r("bib.escreva_int_cabe"));
+    emite_desvio(codigo, OP_JAL, rotulo_rotina(ROTINA_DESCARREGA));
+    emite_la(codigo, PONTEIRO, r("bib.saida"));
+    emite_rotulo(codigo, r("bib.escreva_int_cabe"));
+    emite_move(codigo, REG_A1, REG_A0);
+    emite_desvio_comparacao(codigo, OP_BLT, REG_A1, REG_ZERO, r("bib.escreva_int_negativo"));
+    emite_r(codigo, OP_SUB, REG_A1, REG_ZERO, REG_A1);
+    emite_desvio(codigo, OP_J, r("bib.escreva_int_algarismos"));
+    emite_rotulo(codigo, r("bib.escreva_int_negativo"));
+    emite_li(codigo, REG_A0, '-');
+    emite_mem(codigo, OP_SB, REG_A0, 0, PONTEIRO);
+    emite_i(codigo, OP_ADDIU, PONTEIRO, PONTEIRO, 1);
+    emite_rotulo(codigo, r("bib.escreva_int_algarismos"));
+    emite_move(codigo, REG_A2, PONTEIRO);                   // Primeiro algarismo.
+    emite_li(codigo, AUXILIAR, 10);
+    emite_rotulo(codigo, r("bib.escreva_int_laco"));
+    emite_r(codigo, OP_DIV, REG_V0, REG_A1, AUXILIAR);
+    emite_r(codigo, OP_MUL, REG_A0, REG_V0, AUXILIAR);
+    emite_r(codigo, OP_SUB, REG_A0, REG_A0, REG_A1);        // Algarismo (o resto, com o sinal trocado).
+    emite_i(codigo, OP_ADDIU, REG_A0, REG_A0, '0');
+    emite_mem(codigo, OP_SB, REG_A0, 0, PONTEIRO);
+    emite_i(codigo, OP_ADDIU, PONTEIRO, PONTEIRO, 1);
+    emite_move(codigo, REG_A1, REG_V0);
+    emite_bnez(codigo, REG_A1, r("bib.escreva_int_laco"));
+    emite_i(codigo, OP_ADDIU, AUXILIAR, PONTEIRO, -1);      // Último algarismo.
+    emite_rotulo(codigo, r("bib.escreva_int_inverte"));
+    emite_desvio_comparacao(codigo, OP_BGE, REG_A2, AUXILIAR, r("bib.escreva_int_fim"));
+    emite_mem(codigo, OP_LBU, REG_A0, 0, REG_A2);
+    emite_mem(codigo, OP_LBU, REG_V0, 0, AUXILIAR);
+    emite_mem(codigo, OP_SB, REG_V0, 0, REG_A2);
+    emite_mem(codigo, OP_SB, REG_A0, 0, AUXILIAR);
+    emite_i(codigo, OP_ADDIU, REG_A2, REG_A2, 1);
+    emite_i(codigo, OP_ADDIU, AUXILIAR, AUXILIAR, -1);
+    emite_desvio(codigo, OP_J, r("bib.escreva_int_inverte"));
+    emite_rotulo(codigo, r("bib.escreva_int_fim"));
+    desempilha(salvos, 2);
+    emite_la(codigo, AUXILIAR, r("bib.saida_proximo"));
+    emite_desvio(codigo, OP_J, r("bib.guarda_proximo"));
+}
+
+// $a0: o endereço da cadeia; $a1: o comprimento (ou mais). Uma cadeia maior que o buffer
+// inteiro é escrita direto, depois do que já estava nele.
+static void emite_escreva_cadeia(void) {
+    static const Registrador salvos[] = {REG_RA};
+    emite_rotulo(codigo, rotulo_rotina(ROTINA_ESCREVA_CADEIA));
+    emite_la(codigo, AUXILIAR, r("bib.saida_proximo"));
+    emite_mem(codigo, OP_LW, PONTEIRO, 0, AUXILIAR);
+    emite_la(codigo, REG_V0, r("bib.saida_fim"));
+    emite_r(codigo, OP_SUB, REG_V0, REG_V0, PONTEIRO);      // Bytes livres.
+    emite_desvio_comparacao(codigo, OP_BGE, REG_V0, REG_A1, r("bib.escreva_cadeia_copia"));
+    empilha(salvos, 1);
+    emite_desvio(codigo, OP_JAL, rotulo_rotina(ROTINA_DESCARREGA));
+    desempilha(salvos, 1);
+    emite_desvio_comparacao_i(codigo, OP_BLE, REG_A1, TAMANHO_SAIDA, r("bib.escreva_cadeia_vazio"));
+    emite_li(codigo, REG_V0, 4);                            // Código de serviço 4 (print_string).
+    emite_syscall(codigo);
+    emite_jr(codigo, REG_RA);
+    emite_rotulo(codigo, r("bib.escreva_cadeia_vazio"));
+    emite_la(codigo, AUXILIAR, r("bib.saida_proximo"));
+    emite_la(codigo, PONTEIRO, r("bib.saida"));
+    emite_rotulo(codigo, r("bib.escreva_cadeia_copia"));
+    emite_mem(codigo, OP_LBU, REG_V0, 0, REG_A0);
+    emite_beqz(codigo, REG_V0, r("bib.guarda_proximo"));
+    emite_mem(codigo, OP_SB, REG_V0, 0, PONTEIRO);
+    emite_i(codigo, OP_ADDIU, PONTEIRO, PONTEIRO, 1);
+    emite_i(codigo, OP_ADDIU, REG_A0, REG_A0, 1);
+    emite_desvio(codigo, OP_J, r("bib.escreva_cadeia_copia"));
+}
+
+// Devolve em $v0 o próximo inteiro da entrada (0 no fim dela). Antes de esperar pela entrada,
+// escreve o que estiver no buffer de saída. Os inteiros são separados por brancos (podem vir
+// vários numa linha); o que vier colado a um inteiro e não for algarismo é descartado.
+static void emite_leia_inteiro(void) {
+    static const Registrador salvos[] = {REG_A0, REG_A1, REG_RA};
+    emite_rotulo(codigo, rotulo_rotina(ROTINA_LEIA_INTEIRO));
+    empilha(salvos, 3);
+    emite_desvio(codigo, OP_JAL, rotulo_rotina(ROTINA_DESCARREGA));
+    emite_la(codigo, AUXILIAR, r("bib.entrada_proximo"));
+    emite_mem(codigo, OP_LW, PONTEIRO, 0, AUXILIAR);
+    emite_rotulo(codigo, r("bib.leia_int_brancos"));
+    emite_mem(codigo, OP_LBU, REG_V0, 0, PONTEIRO);
+    emite_beqz(codigo, REG_V0, r("bib.leia_int_linha"));
+    emite_desvio_comparacao_i(codigo, OP_BGT, REG_V0, ' ', r("bib.leia_int_numero"));
+    emite_i(codigo, OP_ADDIU, PONTEIRO, PONTEIRO, 1);
+    emite_desvio(codigo, OP_J, r("bib.leia_int_brancos"));
+    // Buffer consumido: lê a próxima linha. Se nada vier, a entrada acabou.
+    emite_rotulo(codigo, r("bib.leia_int_linha"));
+    emite_la(codigo, REG_A0, r("bib.entrada"));
+    emite_li(codigo, REG_A1, TAMANHO_ENTRADA);
+    emite_li(codigo, REG_V0, 8);                            // Código de serviço 8 (read_string).
+    emite_syscall(codigo);
+    emite_la(codigo, PONTEIRO, r("bib.entrada"));
+    emite_mem(codigo, OP_LBU, REG_V0, 0, PONTEIRO);
+    emite_bnez(codigo, REG_V0, r("bib.leia_int_brancos"));
+    emite_li(codigo, REG_A0, 0);
+    emite_desvio(codigo, OP_J, r("bib.leia_int_fim"));
+    // O valor é acumulado negativo, como na escrita; o sinal é acertado no fim.
+    emite_rotulo(codigo, r("bib.leia_int_numero"));
+    emite_move(codigo, REG_A1, REG_V0);                     // Primeiro caractere ('-' ou não).
+    emite_desvio_comparacao_i(codigo, OP_BNE, REG_V0, '-', r("bib.leia_int_algarismos"));
+    emite_i(codigo, OP_ADDIU, PONTEIRO, PONTEIRO, 1);
+    emite_rotulo(codigo, r("bib.leia_int_algarismos"));
+    emite_li(codigo, REG_A0, 0);
+    emite_li(codigo, AUXILIAR, 10);
+    emite_rotulo(codigo, r("bib.leia_int_laco"));
+    emite_mem(codigo, OP_LBU, REG_V0, 0, PONTEIRO);
+    emite_desvio_comparacao_i(codigo, OP_BLT, REG_V0, '0', r("bib.leia_int_sinal"));
+    emite_desvio_comparacao_i(codigo, OP_BGT, REG_V0, '9', r("bib.leia_int_sinal"));
+    emite_r(codigo, OP_MUL, REG_A0, REG_A0, AUXILIAR);
+    emite_i(codigo, OP_ADDIU, REG_V0, REG_V0, -'0');
+    emite_r(codigo, OP_SUB, REG_A0, REG_A0, REG_V0);
+    emite_i(codigo, OP_ADDIU, PONTEIRO, PONTEIRO, 1);
+    emite_desvio(codigo, OP_J, r("bib.leia_int_laco"));
+    emite_rotulo(codigo, r("bib.leia_int_sinal"));
+    emite_desvio_comparacao_i(codigo, OP_BEQ, REG_A1, '-', r("bib.leia_int_resto"));
+    emite_r(codigo, OP_SUB, REG_A0, REG_ZERO, REG_A0);
+    emite_rotulo(codigo, r("bib.leia_int_resto"));
+    emite_mem(codigo, OP_LBU, REG_V0, 0, PONTEIRO);
+    emite_desvio_comparacao_i(codigo, OP_BLE, REG_V0, ' ', r("bib.leia_int_fim"));
+    emite_i(codigo, OP_ADDIU, PONTEIRO, PONTEIRO, 1);
+    emite_desvio(codigo, OP_J, r("bib.leia_int_resto"));
+    emite_rotulo(codigo, r("bib.leia_int_fim"));
+    emite_move(codigo, REG_V0, REG_A0);
+    emite_la(codigo, AUXILIAR, r("bib.entrada_proximo"));
+    emite_mem(codigo, OP_SW, PONTEIRO, 0, AUXILIAR);
+    desempilha(salvos, 3);
+    emite_jr(codigo, REG_RA);
+}
+
+void emite_biblioteca(CodigoMips* c, const int usadas[NUM_ROTINAS]) {
+    int alguma = 0;
+    for (int i = 0; i < NUM_ROTINAS; i++) alguma |= usadas[i];
+    if (!alguma) return;
+    codigo = c;
+
+    emite_comentario(codigo, "---- Biblioteca de execução (entrada e saída com buffer) ----", 1);
+    emite_descarrega();                     // Usada por todas as outras.
+    if (usadas[ROTINA_ESCREVA_CARACTERE]) emite_escreva_caractere();
+    if (usadas[ROTINA_ESCREVA_INTEIRO]) emite_escreva_inteiro();
+    if (usadas[ROTINA_ESCREVA_CADEIA]) emite_escreva_cadeia();
+    if (usadas[ROTINA_LEIA_INTEIRO]) emite_leia_inteiro();
+
+    // Os buffers (o byte depois do de saída termina a cadeia escrita) e os ponteiros para a
+    // próxima posição livre de cada um.
+    emite_diretiva(codigo, ".data");
+    emite_rotulo(codigo, r("bib.saida"));
+    emite_diretiva(codigo, DIRETIVA_ESPACO(TAMANHO_SAIDA));
+    emite_rotulo(codigo, r("bib.saida_fim"));
+    emite_diretiva(codigo, "  .space 1");
+    if (usadas[ROTINA_LEIA_INTEIRO]) {
+        emite_rotulo(codigo, r("bib.entrada"));
+        emite_diretiva(codigo, DIRETIVA_ESPACO(TAMANHO_ENTRADA));
+    }
+    emite_diretiva(codigo, "  .align 2");
+    emite_rotulo(codigo, r("bib.saida_proximo"));
+    emite_diretiva(codigo, "  .word bib.saida");
+    if (usadas[ROTINA_LEIA_INTEIRO]) {
+        emite_rotulo(codigo, r("bib.entrada_proximo"));
+        emite_diretiva(codigo, "  .word bib.entrada");
+    }
+    codigo = NULL;
+}
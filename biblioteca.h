@@ -0,0 +1,38 @@
+#ifndef BIBLIOTECA_H
+#define BIBLIOTECA_H
+
+#include "emissor.h"
+
+// --- Biblioteca de Execução (entrada e saída com buffer) ---
+// Com a saída com buffer, 'escreva' e 'novalinha' não fazem mais uma chamada ao sistema cada um:
+// o código gerado chama (com 'jal') rotinas que formatam o valor num buffer de saída, escrito
+// com um único 'print_string' quando enche, antes de cada 'leia' e no fim do programa. O 'leia'
+// correspondente lê uma linha inteira de uma vez ('read_string') e tira dela um inteiro por
+// chamada. As rotinas só são emitidas se o programa as usa, depois do código do programa.
+//
+// Convenção: os argumentos vêm em $a0 (o valor, ou o endereço da cadeia) e $a1 (o tamanho da
+// cadeia); o inteiro lido volta em $v0. As rotinas de escrita podem destruir $v0, $a0, $a1,
+// $t8, $t9 e $ra; a de leitura, só $v0, $t8, $t9 e $ra. Os demais registradores são preservados.
+
+typedef enum {
+    ROTINA_ESCREVA_INTEIRO,
+    ROTINA_ESCREVA_CARACTERE,
+    ROTINA_ESCREVA_CADEIA,
+    ROTINA_LEIA_INTEIRO,
+    ROTINA_DESCARREGA,          // Escreve o que estiver no buffer de saída.
+    NUM_ROTINAS
+} RotinaBiblioteca;
+
+// Rótulo de entrada da rotina (os nomes têm um ponto, que não pode aparecer num identificador
+// do programa, para não se confundirem com os das funções).
+Rotulo rotulo_rotina(RotinaBiblioteca rotina);
+
+// Indica se o rótulo é o de uma rotina da biblioteca. Uma chamada a ela, ao contrário das
+// chamadas a funções do programa, preserva $t0-$t7.
+int eh_rotina_da_biblioteca(Rotulo rotulo);
+
+// Emite no fim do código as rotinas marcadas em 'usadas' (e as que elas usam), seguidas dos
+// buffers e variáveis delas na seção .data.
+void emite_biblioteca(CodigoMips* codigo, const int usadas[NUM_ROTINAS]);
+
+#endif // BIBLIOTECA_H
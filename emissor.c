@@ -0,0 +1,383 @@
+#include <stdlib.h>     // Para realloc, free e exit.
+#include <string.h>     // Para memcpy e strlen.
+#include "emissor.h"
+
+// Nomes dos registradores, indexados pelo número (enum Registrador).
+static const char* const nomes_registradores[NUM_REGISTRADORES] = {
+    "$zero", "$at", "$v0", "$v1", "$a0", "$a1", "$a2", "$a3",
+    "$t0", "$t1", "$t2", "$t3", "$t4", "$t5", "$t6", "$t7",
+    "$s0", "$s1", "$s2", "$s3", "$s4", "$s5", "$s6", "$s7",
+    "$t8", "$t9", "$k0", "$k1", "$gp", "$sp", "$fp", "$ra"
+};
+
+const char* nome_registrador(Registrador r) {
+    return nomes_registradores[r];
+}
+
+// Mnemônicos das instruções, indexados pelo código de operação (NULL nas pseudo-operações).
+static const char* const mnemonicos[NUM_OPCODES] = {
+    [OP_ADD] = "add", [OP_SUB] = "sub", [OP_ADDU] = "addu", [OP_SUBU] = "subu",
+    [OP_MUL] = "mul", [OP_DIV] = "div",
+    [OP_AND] = "and", [OP_OR] = "or",
+    [OP_SEQ] = "seq", [OP_SNE] = "sne", [OP_SLT] = "slt", [OP_SLE] = "sle",
+    [OP_SGT] = "sgt", [OP_SGE] = "sge",
+    [OP_ADDI] = "addi", [OP_ADDIU] = "addiu", [OP_SLL] = "sll", [OP_SRA] = "sra", [OP_SRL] = "srl",
+    [OP_LW] = "lw", [OP_SW] = "sw", [OP_LBU] = "lbu", [OP_SB] = "sb",
+    [OP_LI] = "li", [OP_MOVE] = "move", [OP_JR] = "jr", [OP_SYSCALL] = "syscall",
+    [OP_LA] = "la", [OP_J] = "j", [OP_JAL] = "jal", [OP_BEQZ] = "beqz",
+    [OP_BNEZ] = "bnez",
+    [OP_BEQ] = "beq", [OP_BNE] = "bne", [OP_BLT] = "blt", [OP_BLE] = "ble",
+    [OP_BGT] = "bgt", [OP_BGE] = "bge"
+};
+
+// --- Rótulos ---
+
+Rotulo rotulo_numerado(const char* prefixo, int numero) {
+    Rotulo r = { prefixo, numero, NULL };
+    return r;
+}
+
+Rotulo rotulo_nome(const char* nome) {
+    Rotulo r = { nome, -1, NULL };
+    return r;
+}
+
+Rotulo rotulo_com_sufixo(const char* nome, const char* sufixo) {
+    Rotulo r = { nome, -1, sufixo };
+    return r;
+}
+
+// --- Vetor de Instruções ---
+
+void codigo_inicializar(CodigoMips* codigo) {
+    codigo->instrucoes = NULL;
+    codigo->num_instrucoes = 0;
+    codigo->capacidade = 0;
+}
+
+void codigo_liberar(CodigoMips* codigo) {
+    free(codigo->instrucoes);
+    codigo_inicializar(codigo);
+}
+
+// Acrescenta um registro zerado ao fim do código (dobrando o vetor quando necessário).
+static Instrucao* nova_instrucao(CodigoMips* codigo, Opcode op) {
+    if (codigo->num_instrucoes == codigo->capacidade) {
+        codigo->capacidade = codigo->capacidade ? codigo->capacidade * 2 : 1024;
+        codigo->instrucoes = realloc(codigo->instrucoes, codigo->capacidade * sizeof(Instrucao));
+        if (!codigo->instrucoes) {
+            printf("Erro: Falha de alocação de memória para o código gerado.\n");
+            exit(1);
+        }
+    }
+    Instrucao* ins = &codigo->instrucoes[codigo->num_instrucoes++];
+    memset(ins, 0, sizeof(Instrucao));
+    ins->op = op;
+    return ins;
+}
+
+Instrucao* emite_r(CodigoMips* codigo, Opcode op, Registrador rd, Registrador rs, Registrador rt) {
+    Instrucao* ins = nova_instrucao(codigo, op);
+    ins->rd = rd; ins->rs = rs; ins->rt = rt;
+    return ins;
+}
+
+Instrucao* emite_i(CodigoMips* codigo, Opcode op, Registrador rt, Registrador rs, int imediato) {
+    Instrucao* ins = nova_instrucao(codigo, op);
+    ins->rt = rt; ins->rs = rs; ins->imediato = imediato;
+    return ins;
+}
+
+Instrucao* emite_mem(CodigoMips* codigo, Opcode op, Registrador rt, int deslocamento, Registrador base) {
+    Instrucao* ins = nova_instrucao(codigo, op);
+    ins->rt = rt; ins->rs = base; ins->imediato = deslocamento;
+    return ins;
+}
+
+Instrucao* emite_li(CodigoMips* codigo, Registrador rd, int imediato) {
+    Instrucao* ins = nova_instrucao(codigo, OP_LI);
+    ins->rd = rd; ins->imediato = imediato;
+    return ins;
+}
+
+Instrucao* emite_move(CodigoMips* codigo, Registrador rd, Registrador rs) {
+    Instrucao* ins = nova_instrucao(codigo, OP_MOVE);
+    ins->rd = rd; ins->rs = rs;
+    return ins;
+}
+
+Instrucao* emite_jr(CodigoMips* codigo, Registrador rs) {
+    Instrucao* ins = nova_instrucao(codigo, OP_JR);
+    ins->rs = rs;
+    return ins;
+}
+
+Instrucao* emite_syscall(CodigoMips* codigo) {
+    return nova_instrucao(codigo, OP_SYSCALL);
+}
+
+Instrucao* emite_la(CodigoMips* codigo, Registrador rd, Rotulo rotulo) {
+    Instrucao* ins = nova_instrucao(codigo, OP_LA);
+    ins->rd = rd; ins->rotulo = rotulo;
+    return ins;
+}
+
+Instrucao* emite_desvio(CodigoMips* codigo, Opcode op, Rotulo rotulo) {
+    Instrucao* ins = nova_instrucao(codigo, op);
+    ins->rotulo = rotulo;
+    return ins;
+}
+
+Instrucao* emite_beqz(CodigoMips* codigo, Registrador rs, Rotulo rotulo) {
+    Instrucao* ins = nova_instrucao(codigo, OP_BEQZ);
+    ins->rs = rs; ins->rotulo = rotulo;
+    return ins;
+}
+
+Instrucao* emite_bnez(CodigoMips* codigo, Registrador rs, Rotulo rotulo) {
+    Instrucao* ins = nova_instrucao(codigo, OP_BNEZ);
+    ins->rs = rs; ins->rotulo = rotulo;
+    return ins;
+}
+
+Instrucao* emite_desvio_comparacao(CodigoMips* codigo, Opcode op, Registrador rs, Registrador rt, Rotulo rotulo) {
+    Instrucao* ins = nova_instrucao(codigo, op);
+    ins->rs = rs; ins->rt = rt; ins->rotulo = rotulo;
+    return ins;
+}
+
+Instrucao* emite_desvio_comparacao_i(CodigoMips* codigo, Opcode op, Registrador rs, int imediato, Rotulo rotulo) {
+    Instrucao* ins = nova_instrucao(codigo, op);
+    ins->rs = rs; ins->rt = REG_ZERO; ins->imediato = imediato; ins->rotulo = rotulo;
+    return ins;
+}
+
+Instrucao* emite_rotulo(CodigoMips* codigo, Rotulo rotulo) {
+    Instrucao* ins = nova_instrucao(codigo, OP_ROTULO);
+    ins->rotulo = rotulo;
+    return ins;
+}
+
+Instrucao* emite_comentario(CodigoMips* codigo, const char* texto, int linha_em_branco) {
+    Instrucao* ins = nova_instrucao(codigo, OP_COMENTARIO);
+    ins->texto = texto; ins->imediato = linha_em_branco;
+    return ins;
+}
+
+Instrucao* emite_diretiva(CodigoMips* codigo, const char* texto) {
+    Instrucao* ins = nova_instrucao(codigo, OP_DIRETIVA);
+    ins->texto = texto;
+    return ins;
+}
+
+Instrucao* emite_asciiz(CodigoMips* codigo, Rotulo rotulo, const char* texto) {
+    Instrucao* ins = nova_instrucao(codigo, OP_ASCIIZ);
+    ins->rotulo = rotulo; ins->texto = texto;
+    return ins;
+}
+
+// --- Consultas ---
+
+static int textos_iguais(const char* a, const char* b) {
+    if (a == b) return 1;
+    return a && b && strcmp(a, b) == 0;
+}
+
+int rotulos_iguais(Rotulo a, Rotulo b) {
+    return a.numero == b.numero && textos_iguais(a.prefixo, b.prefixo) && textos_iguais(a.sufixo, b.sufixo);
+}
+
+int eh_desvio_condicional(Opcode op) {
+    return op == OP_BEQZ || op == OP_BNEZ || (op >= OP_BEQ && op <= OP_BGE);
+}
+
+Registrador registrador_escrito(const Instrucao* ins) {
+    switch (ins->op) {
+        case OP_ADD: case OP_SUB: case OP_ADDU: case OP_SUBU: case OP_MUL: case OP_DIV: case OP_AND: case OP_OR:
+        case OP_SEQ: case OP_SNE: case OP_SLT: case OP_SLE: case OP_SGT: case OP_SGE:
+        case OP_LI: case OP_MOVE: case OP_LA:
+            return ins->rd;
+        case OP_ADDI: case OP_ADDIU: case OP_SLL: case OP_SRA: case OP_SRL: case OP_LW: case OP_LBU:
+            return ins->rt;
+        case OP_JAL:
+            return REG_RA;
+        case OP_SYSCALL:
+            return REG_V0; // O serviço de leitura devolve o valor em $v0.
+        default:
+            return REG_ZERO;
+    }
+}
+
+int le_registrador(const Instrucao* ins, Registrador r) {
+    switch (ins->op) {
+        case OP_ADD: case OP_SUB: case OP_ADDU: case OP_SUBU: case OP_MUL: case OP_DIV: case OP_AND: case OP_OR:
+        case OP_SEQ: case OP_SNE: case OP_SLT: case OP_SLE: case OP_SGT: case OP_SGE:
+        case OP_BEQ: case OP_BNE: case OP_BLT: case OP_BLE: case OP_BGT: case OP_BGE:
+            return ins->rs == r || ins->rt == r;
+        case OP_ADDI: case OP_ADDIU: case OP_SLL: case OP_SRA: case OP_SRL:
+        case OP_LW: case OP_LBU: case OP_MOVE: case OP_JR: case OP_BEQZ: case OP_BNEZ:
+            return ins->rs == r;
+        case OP_SW: case OP_SB:
+            return ins->rs == r || ins->rt == r;
+        case OP_JAL:
+            return r >= REG_A0 && r <= REG_A3;
+        case OP_SYSCALL:
+            return r == REG_V0 || r == REG_A0;
+        default:
+            return 0;
+    }
+}
+
+// --- Conversão para Texto ---
+// O texto é montado à mão num buffer único (sem fprintf/snprintf por linha): copiar nomes
+// de tabelas e converter inteiros em decimal é tudo o que a formatação precisa.
+
+typedef struct Buffer {
+    char* dados;
+    size_t tamanho;
+    size_t capacidade;
+} Buffer;
+
+// Garante espaço para mais 'n' bytes no buffer.
+static void reserva(Buffer* b, size_t n) {
+    if (b->tamanho + n <= b->capacidade) return;
+    while (b->tamanho + n > b->capacidade) {
+        b->capacidade = b->capacidade ? b->capacidade * 2 : 64 * 1024;
+    }
+    b->dados = realloc(b->dados, b->capacidade);
+    if (!b->dados) {
+        printf("Erro: Falha de alocação de memória para o código gerado.\n");
+        exit(1);
+    }
+}
+
+static void acrescenta(Buffer* b, const char* texto, size_t n) {
+    reserva(b, n);
+    memcpy(b->dados + b->tamanho, texto, n);
+    b->tamanho += n;
+}
+
+static void acrescenta_texto(Buffer* b, const char* texto) {
+    acrescenta(b, texto, strlen(texto));
+}
+
+// Escreve um inteiro em decimal (com sinal).
+static void acrescenta_inteiro(Buffer* b, int valor) {
+    char digitos[12];
+    int n = sizeof(digitos);
+    // Trabalha com o valor absoluto em 'unsigned' para que INT_MIN não transborde.
+    unsigned int v = valor < 0 ? 0u - (unsigned int)valor : (unsigned int)valor;
+    do {
+        digitos[--n] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    if (valor < 0) digitos[--n] = '-';
+    acrescenta(b, digitos + n, sizeof(digitos) - n);
+}
+
+static void acrescenta_registrador(Buffer* b, Registrador r) {
+    acrescenta_texto(b, nomes_registradores[r]);
+}
+
+static void acrescenta_rotulo(Buffer* b, Rotulo r) {
+    if (!r.prefixo) return; // Rótulo vazio (registro zerado).
+    acrescenta_texto(b, r.prefixo);
+    if (r.numero >= 0) acrescenta_inteiro(b, r.numero);
+    if (r.sufixo) acrescenta_texto(b, r.sufixo);
+}
+
+// Formata uma instrução (uma linha, incluindo o '\n').
+static void formata_instrucao(Buffer* b, const Instrucao* ins) {
+    switch (ins->op) {
+        case OP_ROTULO:
+            acrescenta_rotulo(b, ins->rotulo);
+            acrescenta(b, ":", 1);
+            break;
+        case OP_COMENTARIO:
+            // Comentários de seção (com linha em branco antes) ficam na coluna 0; os demais, recuados.
+            acrescenta(b, ins->imediato ? "\n# " : "  # ", ins->imediato ? 3 : 4);
+            acrescenta_texto(b, ins->texto);
+            acrescenta_rotulo(b, ins->rotulo);
+            break;
+        case OP_DIRETIVA:
+            acrescenta_texto(b, ins->texto);
+            break;
+        case OP_ASCIIZ:
+            acrescenta_rotulo(b, ins->rotulo);
+            acrescenta(b, ": .asciiz ", 10);
+            acrescenta_texto(b, ins->texto);
+            break;
+        default:
+            // Instruções: recuo de dois espaços, mnemônico e operandos.
+            acrescenta(b, "  ", 2);
+            acrescenta_texto(b, mnemonicos[ins->op]);
+            switch (ins->op) {
+                case OP_ADDI: case OP_ADDIU: case OP_SLL: case OP_SRA: case OP_SRL:
+                    acrescenta(b, " ", 1);   acrescenta_registrador(b, ins->rt);
+                    acrescenta(b, ", ", 2);  acrescenta_registrador(b, ins->rs);
+                    acrescenta(b, ", ", 2);  acrescenta_inteiro(b, ins->imediato);
+                    break;
+                case OP_LW: case OP_SW: case OP_LBU: case OP_SB:
+                    acrescenta(b, " ", 1);   acrescenta_registrador(b, ins->rt);
+                    acrescenta(b, ", ", 2);  acrescenta_inteiro(b, ins->imediato);
+                    acrescenta(b, "(", 1);   acrescenta_registrador(b, ins->rs);
+                    acrescenta(b, ")", 1);
+                    break;
+                case OP_LI:
+                    acrescenta(b, " ", 1);   acrescenta_registrador(b, ins->rd);
+                    acrescenta(b, ", ", 2);  acrescenta_inteiro(b, ins->imediato);
+                    break;
+                case OP_MOVE:
+                    acrescenta(b, " ", 1);   acrescenta_registrador(b, ins->rd);
+                    acrescenta(b, ", ", 2);  acrescenta_registrador(b, ins->rs);
+                    break;
+                case OP_JR:
+                    acrescenta(b, " ", 1);   acrescenta_registrador(b, ins->rs);
+                    break;
+                case OP_SYSCALL:
+                    break;
+                case OP_LA:
+                    acrescenta(b, " ", 1);   acrescenta_registrador(b, ins->rd);
+                    acrescenta(b, ", ", 2);  acrescenta_rotulo(b, ins->rotulo);
+                    break;
+                case OP_J: case OP_JAL:
+                    acrescenta(b, " ", 1);   acrescenta_rotulo(b, ins->rotulo);
+                    break;
+                case OP_BEQZ: case OP_BNEZ:
+                    acrescenta(b, " ", 1);   acrescenta_registrador(b, ins->rs);
+                    acrescenta(b, ", ", 2);  acrescenta_rotulo(b, ins->rotulo);
+                    break;
+                case OP_BEQ: case OP_BNE: case OP_BLT: case OP_BLE: case OP_BGT: case OP_BGE:
+                    acrescenta(b, " ", 1);   acrescenta_registrador(b, ins->rs);
+                    acrescenta(b, ", ", 2);
+                    if (ins->rt == REG_ZERO && ins->imediato != 0) acrescenta_inteiro(b, ins->imediato);
+                    else acrescenta_registrador(b, ins->rt);
+                    acrescenta(b, ", ", 2);  acrescenta_rotulo(b, ins->rotulo);
+                    break;
+                default: // Formato "op rd, rs, rt".
+                    acrescenta(b, " ", 1);   acrescenta_registrador(b, ins->rd);
+                    acrescenta(b, ", ", 2);  acrescenta_registrador(b, ins->rs);
+                    acrescenta(b, ", ", 2);  acrescenta_registrador(b, ins->rt);
+                    break;
+            }
+            break;
+    }
+    if (ins->comentario) {
+        acrescenta(b, " # ", 3);
+        acrescenta_texto(b, ins->comentario);
+    }
+    acrescenta(b, "\n", 1);
+}
+
+long codigo_escreve(const CodigoMips* codigo, FILE* arquivo) {
+    Buffer b = { NULL, 0, 0 };
+    // Estimativa inicial: cerca de 20 caracteres por linha evita a maioria das realocações.
+    reserva(&b, (size_t)codigo->num_instrucoes * 20 + 1);
+    for (int i = 0; i < codigo->num_instrucoes; i++) {
+        formata_instrucao(&b, &codigo->instrucoes[i]);
+    }
+    size_t escritos = fwrite(b.dados, 1, b.tamanho, arquivo);
+    long resultado = escritos == b.tamanho ? (long)b.tamanho : -1;
+    free(b.dados);
+    return resultado;
+}
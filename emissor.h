@@ -0,0 +1,130 @@
+#ifndef EMISSOR_H
+#define EMISSOR_H
+
+#include <stdio.h>      // Para o tipo FILE.
+
+// --- Emissor de Instruções MIPS ---
+// Em vez de escrever cada instrução no arquivo com seu próprio fprintf, a geração de código
+// acrescenta REGISTROS de instrução (código de operação, registradores, imediato, rótulo) a um
+// vetor em memória. Só no final o vetor inteiro é convertido em texto, num único buffer,
+// e gravado no arquivo com uma única escrita. Enquanto está em memória, o código pode ser
+// examinado e reescrito por passadas posteriores (ex: otimizações sobre as instruções).
+
+// Registradores do MIPS, na ordem de sua numeração (o valor do enum é o número do registrador).
+typedef enum {
+    REG_ZERO, REG_AT, REG_V0, REG_V1,
+    REG_A0, REG_A1, REG_A2, REG_A3,
+    REG_T0, REG_T1, REG_T2, REG_T3, REG_T4, REG_T5, REG_T6, REG_T7,
+    REG_S0, REG_S1, REG_S2, REG_S3, REG_S4, REG_S5, REG_S6, REG_S7,
+    REG_T8, REG_T9, REG_K0, REG_K1,
+    REG_GP, REG_SP, REG_FP, REG_RA,
+    NUM_REGISTRADORES
+} Registrador;
+
+// Códigos de operação. Além das instruções (e pseudo-instruções do MARS) usadas pelo gerador,
+// há "operações" que não geram código: rótulos, comentários e diretivas do montador.
+typedef enum {
+    // Formato "op rd, rs, rt". 'addu' e 'subu' não param o programa quando o resultado transborda.
+    OP_ADD, OP_SUB, OP_ADDU, OP_SUBU, OP_MUL, OP_DIV, OP_AND, OP_OR,
+    OP_SEQ, OP_SNE, OP_SLT, OP_SLE, OP_SGT, OP_SGE,
+    // Formato "op rt, rs, imediato" (nos deslocamentos, o imediato é o número de bits).
+    OP_ADDI, OP_ADDIU, OP_SLL, OP_SRA, OP_SRL,
+    // Formato "op rt, imediato(rs)". 'lbu' e 'sb' leem e escrevem um só byte.
+    OP_LW, OP_SW, OP_LBU, OP_SB,
+    // Formatos com um ou dois registradores.
+    OP_LI,          // li rd, imediato
+    OP_MOVE,        // move rd, rs
+    OP_JR,          // jr rs
+    OP_SYSCALL,     // syscall
+    // Formatos com rótulo.
+    OP_LA,          // la rd, rotulo
+    OP_J,           // j rotulo
+    OP_JAL,         // jal rotulo
+    OP_BEQZ,        // beqz rs, rotulo
+    OP_BNEZ,        // bnez rs, rotulo
+    // Formato "op rs, rt, rotulo" (desvia se "rs op rt"). Com rt = $zero e 'imediato' != 0,
+    // compara com o imediato ("blt rs, 10, rotulo", pseudo-instrução do MARS).
+    OP_BEQ, OP_BNE, OP_BLT, OP_BLE, OP_BGT, OP_BGE,
+    // Pseudo-operações (não são instruções).
+    OP_ROTULO,      // Definição de rótulo ("rotulo:").
+    OP_COMENTARIO,  // Linha de comentário ("# texto" seguido do rótulo, se houver), com uma linha
+                    // em branco antes (comentário de seção) se 'imediato' != 0.
+    OP_DIRETIVA,    // Linha copiada literalmente (ex: ".data", ".globl main").
+    OP_ASCIIZ,      // Cadeia na seção de dados ("rotulo: .asciiz texto").
+    NUM_OPCODES
+} Opcode;
+
+// Um rótulo é formado por até três partes: prefixo, número (se >= 0) e sufixo.
+// Um rótulo sem prefixo (NULL) é vazio, como o de um registro zerado.
+// Ex: {"L_ELSE_", 3, NULL} -> "L_ELSE_3";  {"soma", -1, "_epilogo"} -> "soma_epilogo".
+// As partes de texto não são copiadas: devem continuar válidas até o código ser escrito
+// (literais do programa ou textos de átomos servem).
+typedef struct Rotulo {
+    const char* prefixo;
+    int numero;
+    const char* sufixo;
+} Rotulo;
+
+// Registro de uma instrução. Os campos não usados pelo código de operação ficam zerados.
+typedef struct Instrucao {
+    Opcode op;
+    Registrador rd, rs, rt;
+    int imediato;
+    Rotulo rotulo;
+    const char* texto;          // Comentários, diretivas e o conteúdo de OP_ASCIIZ.
+    const char* comentario;     // Comentário opcional no fim da linha (NULL = nenhum).
+} Instrucao;
+
+// Sequência de instruções em memória (vetor que cresce conforme a necessidade).
+typedef struct CodigoMips {
+    Instrucao* instrucoes;
+    int num_instrucoes;
+    int capacidade;
+} CodigoMips;
+
+// Nome do registrador como aparece no código ("$t0").
+const char* nome_registrador(Registrador r);
+
+// Construtores de rótulos.
+Rotulo rotulo_numerado(const char* prefixo, int numero);
+Rotulo rotulo_nome(const char* nome);
+Rotulo rotulo_com_sufixo(const char* nome, const char* sufixo);
+
+void codigo_inicializar(CodigoMips* codigo);
+void codigo_liberar(CodigoMips* codigo);
+
+// Funções de emissão. Cada uma acrescenta um registro ao fim do código e o devolve, para que
+// o chamador possa, por exemplo, preencher 'comentario'. O ponteiro só vale até a próxima emissão.
+Instrucao* emite_r(CodigoMips* codigo, Opcode op, Registrador rd, Registrador rs, Registrador rt);
+Instrucao* emite_i(CodigoMips* codigo, Opcode op, Registrador rt, Registrador rs, int imediato);
+Instrucao* emite_mem(CodigoMips* codigo, Opcode op, Registrador rt, int deslocamento, Registrador base);
+Instrucao* emite_li(CodigoMips* codigo, Registrador rd, int imediato);
+Instrucao* emite_move(CodigoMips* codigo, Registrador rd, Registrador rs);
+Instrucao* emite_jr(CodigoMips* codigo, Registrador rs);
+Instrucao* emite_syscall(CodigoMips* codigo);
+Instrucao* emite_la(CodigoMips* codigo, Registrador rd, Rotulo rotulo);
+Instrucao* emite_desvio(CodigoMips* codigo, Opcode op, Rotulo rotulo);       // j, jal
+Instrucao* emite_beqz(CodigoMips* codigo, Registrador rs, Rotulo rotulo);
+Instrucao* emite_bnez(CodigoMips* codigo, Registrador rs, Rotulo rotulo);
+Instrucao* emite_desvio_comparacao(CodigoMips* codigo, Opcode op, Registrador rs, Registrador rt, Rotulo rotulo);
+Instrucao* emite_desvio_comparacao_i(CodigoMips* codigo, Opcode op, Registrador rs, int imediato, Rotulo rotulo);
+Instrucao* emite_rotulo(CodigoMips* codigo, Rotulo rotulo);
+Instrucao* emite_comentario(CodigoMips* codigo, const char* texto, int linha_em_branco);
+Instrucao* emite_diretiva(CodigoMips* codigo, const char* texto);
+Instrucao* emite_asciiz(CodigoMips* codigo, Rotulo rotulo, const char* texto);
+
+// Consultas sobre instruções (usadas pelas passadas que reescrevem o código).
+int rotulos_iguais(Rotulo a, Rotulo b);
+// Indica se a instrução é um desvio condicional (beqz, bnez, beq, blt, ...).
+int eh_desvio_condicional(Opcode op);
+// Registrador que a instrução escreve ($zero se nenhum).
+Registrador registrador_escrito(const Instrucao* ins);
+// Indica se a instrução lê o registrador 'r'. Chamadas contam como leitura de $a0-$a3 e
+// 'syscall' como leitura de $v0 e $a0 (os registradores de argumento dos serviços).
+int le_registrador(const Instrucao* ins, Registrador r);
+
+// Converte todo o código em texto e o grava no arquivo com uma única escrita.
+// Devolve o número de bytes gravados (ou -1 em caso de erro de escrita).
+long codigo_escreve(const CodigoMips* codigo, FILE* arquivo);
+
+#endif // EMISSOR_H
@@ -0,0 +1,460 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "expansao.h"
+#include "tabela_simbolos.h"
+
+static EstatisticasExpansao estatisticas;
+
+// O programa, a função onde as chamadas são expandidas e o que vale para a passada toda.
+static ProgramaIR* programa;
+static FuncaoIR* funcao;
+static int orcamento;
+static int depuracao;
+
+// Durante uma cópia: as variáveis novas (uma para cada variável da função copiada, na mesma
+// ordem) e o número somado aos temporários dela.
+static FuncaoIR* copiada;
+static Vinculo** variaveis_novas;
+static int base_temporarios;
+
+static void* aloca_zerado(int n, size_t tamanho) {
+    void* v = calloc(n ? n : 1, tamanho);
+    if (!v) {
+        fprintf(stderr, "Erro: Falha de alocação de memória na expansão de funções.\n");
+        exit(1);
+    }
+    return v;
+}
+
+static FuncaoIR* funcao_do_vinculo(const Vinculo* v) {
+    for (int f = 0; f < programa->num_funcoes; f++) {
+        if (programa->funcoes[f]->vinculo == v) return programa->funcoes[f];
+    }
+    return NULL;
+}
+
+// Tamanho do corpo: instruções mais os terminadores.
+static int tamanho(const FuncaoIR* g) {
+    int n = 0;
+    for (int i = 0; i < g->num_blocos; i++) {
+        for (InstrucaoIR* ins = g->blocos[i]->primeira; ins; ins = ins->proxima) n++;
+        n++;
+    }
+    return n;
+}
+
+static int chama_a_si_mesma(const FuncaoIR* g) {
+    for (int i = 0; i < g->num_blocos; i++) {
+        for (InstrucaoIR* ins = g->blocos[i]->primeira; ins; ins = ins->proxima) {
+            if (ins->op == IR_CHAMADA && ins->funcao == g->vinculo) return 1;
+        }
+    }
+    return 0;
+}
+
+// O nome de uma variável copiada é "funcao.variavel" (só aparece nas listagens: a variável
+// nova é outro vínculo, então não se confunde com uma de mesmo nome do chamador).
+static Atomo nome_copiado(const Vinculo* v) {
+    char nome[256];
+    int n = snprintf(nome, sizeof(nome), "%s.%s", texto_atomo(copiada->vinculo->nome), texto_atomo(v->nome));
+    if (n >= (int)sizeof(nome)) n = sizeof(nome) - 1;
+    return interna(nome, n);
+}
+
+static Operando renomeia(Operando o) {
+    if (o.tipo == OPERANDO_TEMP) {
+        o.valor += base_temporarios;
+    } else if (o.tipo == OPERANDO_VAR) {
+        // As globais continuam as mesmas; as variáveis da função copiada trocam pelas novas.
+        for (int i = 0; i < copiada->num_variaveis; i++) {
+            if (copiada->variaveis[i] == o.var) {
+                o.var = variaveis_novas[i];
+                break;
+            }
+        }
+    }
+    return o;
+}
+
+// Troca "destino = chame g" (e os argumentos que a precedem) pelo corpo de g. O que vinha depois
+// da chamada no bloco passa para um bloco de continuação, que é devolvido.
+static BlocoBasico* expande_chamada(BlocoBasico* bloco, InstrucaoIR* chamada, FuncaoIR* g) {
+    copiada = g;
+    variaveis_novas = aloca_zerado(g->num_variaveis, sizeof(Vinculo*));
+    for (int i = 0; i < g->num_variaveis; i++) {
+        variaveis_novas[i] = ir_nova_variavel(funcao, g->variaveis[i], nome_copiado(g->variaveis[i]));
+    }
+    base_temporarios = funcao->num_temporarios;
+    funcao->num_temporarios += g->num_temporarios;
+
+    // A continuação herda o resto do bloco e o terminador dele.
+    BlocoBasico* depois = ir_novo_bloco(programa);
+    depois->profundidade_laco = bloco->profundidade_laco;
+    while (chamada->proxima) {
+        InstrucaoIR* ins = chamada->proxima;
+        ir_duplica(depois, ins);
+        ir_remove_instrucao(bloco, ins);
+    }
+    depois->terminador = bloco->terminador;
+    depois->valor = bloco->valor;
+    depois->comparacao = bloco->comparacao;
+    depois->valor2 = bloco->valor2;
+    depois->sucessores[0] = bloco->sucessores[0];
+    depois->sucessores[1] = bloco->sucessores[1];
+
+    // Os argumentos (do último ao primeiro, logo antes da chamada) viram cópias para os
+    // parâmetros, que são as primeiras variáveis da função.
+    InstrucaoIR* ins = chamada->anterior;
+    for (int n = 0; n < chamada->num_args && ins && ins->op == IR_ARGUMENTO; n++, ins = ins->anterior) {
+        ins->op = IR_COPIA;
+        ins->destino = ir_var(variaveis_novas[ins->posicao]);
+    }
+    Operando destino = chamada->destino;
+    ir_remove_instrucao(bloco, chamada);
+
+    BlocoBasico** copias = aloca_zerado(g->num_blocos, sizeof(BlocoBasico*));
+    for (int i = 0; i < g->num_blocos; i++) {
+        copias[i] = ir_novo_bloco(programa);
+        copias[i]->profundidade_laco = bloco->profundidade_laco + g->blocos[i]->profundidade_laco;
+    }
+    for (int i = 0; i < g->num_blocos; i++) {
+        BlocoBasico* original = g->blocos[i];
+        BlocoBasico* copia = copias[i];
+        for (InstrucaoIR* o = original->primeira; o; o = o->proxima) {
+            InstrucaoIR* c = ir_duplica(copia, o);
+            c->destino = renomeia(o->destino);
+            c->a = renomeia(o->a);
+            c->b = renomeia(o->b);
+            estatisticas.instrucoes_copiadas++;
+        }
+        switch (original->terminador) {
+            case TERM_SALTO:
+                ir_salto(copia, copias[original->sucessores[0]->indice]);
+                break;
+            case TERM_DESVIO:
+                ir_desvio_comparacao(copia, original->comparacao, renomeia(original->valor),
+                                     renomeia(original->valor2), copias[original->sucessores[0]->indice],
+                                     copias[original->sucessores[1]->indice]);
+                break;
+            default:
+                // Cada 'retorne', esteja onde estiver no corpo, entrega o valor e segue depois da
+                // chamada. Sem valor (saída pelo fim do corpo), o destino fica com 0.
+                if (destino.tipo != OPERANDO_NENHUM) {
+                    ir_copia(copia, destino, original->valor.tipo != OPERANDO_NENHUM ?
+                             renomeia(original->valor) : ir_const(0));
+                }
+                ir_salto(copia, depois);
+                break;
+        }
+        estatisticas.instrucoes_copiadas++;
+    }
+
+    // O corpo copiado entra logo depois do bloco da chamada, seguido da continuação.
+    ir_salto(bloco, copias[0]);
+    for (int i = 0; i < g->num_blocos; i++) ir_posiciona_bloco(funcao, copias[i], bloco->indice + 1 + i);
+    ir_posiciona_bloco(funcao, depois, bloco->indice + 1 + g->num_blocos);
+
+    free(copias);
+    free(variaveis_novas);
+    variaveis_novas = NULL;
+    copiada = NULL;
+    return depois;
+}
+
+// Decide se a chamada é expandida (e diz por quê, na depuração).
+static int deve_expandir(const InstrucaoIR* chamada, const FuncaoIR* g) {
+    const char* chamador = funcao->vinculo ? texto_atomo(funcao->vinculo->nome) : "principal";
+    const char* motivo = NULL;
+    int n = tamanho(g);
+    if (chama_a_si_mesma(g)) motivo = "é recursiva";
+    else if (n > orcamento) motivo = "excede o orçamento";
+    if (depuracao) {
+        printf("Chamada a '%s' em '%s' (%d instruções): %s%s.\n", texto_atomo(chamada->funcao->nome), chamador, n,
+               motivo ? "mantida, " : "expandida em linha", motivo ? motivo : "");
+    }
+    return motivo == NULL;
+}
+
+static void expande_na_funcao(void) {
+    int expandiu = 0;
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* bloco = funcao->blocos[i];
+        for (InstrucaoIR* ins = bloco->primeira; ins; ins = ins->proxima) {
+            if (ins->op != IR_CHAMADA) continue;
+            FuncaoIR* g = funcao_do_vinculo(ins->funcao);
+            if (!g) continue;
+            if (!deve_expandir(ins, g)) {
+                estatisticas.chamadas_mantidas++;
+                continue;
+            }
+            // O corpo copiado já teve as próprias chamadas decididas: o percurso segue pela
+            // continuação.
+            i = expande_chamada(bloco, ins, g)->indice - 1;
+            estatisticas.chamadas_expandidas++;
+            expandiu = 1;
+            break;
+        }
+    }
+    if (expandiu) ir_atualiza_grafo(funcao);
+}
+
+EstatisticasExpansao expande_funcoes(ProgramaIR* p, int orcamento_instrucoes, int modo_depuracao) {
+    EstatisticasExpansao zeradas = {0};
+    estatisticas = zeradas;
+    programa = p;
+    orcamento = orcamento_instrucoes;
+    depuracao = modo_depuracao;
+    for (int f = 0; f < programa->num_funcoes; f++) {
+        funcao = programa->funcoes[f];
+        expande_na_funcao();
+    }
+    programa = NULL;
+    funcao = NULL;
+    return estatisticas;
+}
+
+void imprime_estatisticas_expansao(void) {
+    printf("Expansão em linha: %d chamada(s) expandida(s), %d mantida(s), %d instrução(ões) copiada(s).\n",
+           estatisticas.chamadas_expandidas, estatisticas.chamadas_mantidas, estatisticas.instrucoes_copiadas);
+}
+
+
+// --- Variáveis das Cópias ---
+// Cada cópia de um corpo ganha variáveis próprias, e as otimizações seguintes costumam deixar
+// muitas delas sem uso. Depois delas, esta passada refaz a vivacidade das variáveis da função:
+// as escritas que ninguém lê saem, as variáveis que nenhuma instrução usa mais são descartadas
+// e as cópias que nunca estão vivas ao mesmo tempo (as de chamadas diferentes, em geral) passam
+// a ser uma só, com uma só posição na memória. No bloco principal todas as variáveis entram
+// (nenhuma outra função as vê); nas funções, só as criadas pelas cópias, que ocupam o fim do
+// quadro e são reposicionadas.
+
+static EstatisticasVariaveis estatisticas_variaveis;
+
+// Variáveis examinadas: funcao->variaveis[primeira...]. As de índice a partir de 'primeira_copia'
+// podem ser juntadas. Durante a passada, Vinculo.numero_ssa guarda 1 + o índice (0 = fora).
+static int primeira;
+static int primeira_copia;
+static int num_candidatas;
+static int palavras;
+static unsigned int* vivas;     // Por bloco: vivas na entrada e, em seguida, na saída.
+
+static unsigned int* entrada(int bloco) { return vivas + (size_t)2 * bloco * palavras; }
+static unsigned int* saida(int bloco) { return vivas + ((size_t)2 * bloco + 1) * palavras; }
+
+static int candidata(Operando o) {
+    return o.tipo == OPERANDO_VAR && o.var->numero_ssa ? o.var->numero_ssa - 1 : -1;
+}
+
+static int pertence(const unsigned int* conjunto, int c) {
+    return (conjunto[c / 32] >> (c % 32)) & 1;
+}
+
+static void inclui(unsigned int* conjunto, Operando o) {
+    int c = candidata(o);
+    if (c >= 0) conjunto[c / 32] |= 1u << (c % 32);
+}
+
+static void exclui(unsigned int* conjunto, Operando o) {
+    int c = candidata(o);
+    if (c >= 0) conjunto[c / 32] &= ~(1u << (c % 32));
+}
+
+// Vivas na saída do bloco, mais as lidas pelo terminador.
+static void vivas_no_fim(const BlocoBasico* b, unsigned int* conjunto) {
+    memcpy(conjunto, saida(b->indice), palavras * sizeof(unsigned int));
+    inclui(conjunto, b->valor);
+    inclui(conjunto, b->valor2);
+}
+
+static void calcula_vivas(unsigned int* conjunto) {
+    memset(vivas, 0, (size_t)2 * funcao->num_blocos * palavras * sizeof(unsigned int));
+    int mudou = 1;
+    while (mudou) {
+        mudou = 0;
+        for (int i = funcao->num_blocos - 1; i >= 0; i--) {
+            BlocoBasico* b = funcao->blocos[i];
+            for (int s = 0; s < 2; s++) {
+                if (!b->sucessores[s]) continue;
+                const unsigned int* e = entrada(b->sucessores[s]->indice);
+                for (int w = 0; w < palavras; w++) saida(i)[w] |= e[w];
+            }
+            vivas_no_fim(b, conjunto);
+            for (InstrucaoIR* ins = b->ultima; ins; ins = ins->anterior) {
+                exclui(conjunto, ins->destino);
+                inclui(conjunto, ins->a);
+                inclui(conjunto, ins->b);
+            }
+            if (memcmp(conjunto, entrada(i), palavras * sizeof(unsigned int)) != 0) {
+                memcpy(entrada(i), conjunto, palavras * sizeof(unsigned int));
+                mudou = 1;
+            }
+        }
+    }
+}
+
+// Só as cópias e as contas que não podem falhar saem quando o valor escrito não é lido.
+static int sem_efeitos(const InstrucaoIR* ins) {
+    return ins->op == IR_COPIA || (ins->op == IR_BINARIO && ins->operador != OPR_DIVISAO);
+}
+
+static int remove_escritas_mortas(unsigned int* conjunto) {
+    int removidas = 0;
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        vivas_no_fim(b, conjunto);
+        for (InstrucaoIR* ins = b->ultima, *anterior; ins; ins = anterior) {
+            anterior = ins->anterior;
+            int d = candidata(ins->destino);
+            if (d >= 0 && !pertence(conjunto, d) && sem_efeitos(ins)) {
+                ir_remove_instrucao(b, ins);
+                removidas++;
+                continue;
+            }
+            exclui(conjunto, ins->destino);
+            inclui(conjunto, ins->a);
+            inclui(conjunto, ins->b);
+        }
+    }
+    return removidas;
+}
+
+// Matriz de interferência (de bits): duas variáveis interferem se uma é escrita onde a outra
+// está viva. As vivas na entrada da função (lidas antes de escritas) interferem com todas.
+static unsigned int* interferencia;
+
+static void interfere(int x, int y) {
+    interferencia[(size_t)x * palavras + y / 32] |= 1u << (y % 32);
+    interferencia[(size_t)y * palavras + x / 32] |= 1u << (x % 32);
+}
+
+static void calcula_interferencia(unsigned int* conjunto, int* usada) {
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        vivas_no_fim(b, conjunto);
+        if (candidata(b->valor) >= 0) usada[candidata(b->valor)] = 1;
+        if (candidata(b->valor2) >= 0) usada[candidata(b->valor2)] = 1;
+        for (InstrucaoIR* ins = b->ultima; ins; ins = ins->anterior) {
+            int d = candidata(ins->destino);
+            if (d >= 0) {
+                usada[d] = 1;
+                for (int c = 0; c < num_candidatas; c++) {
+                    if (c != d && pertence(conjunto, c)) interfere(d, c);
+                }
+            }
+            exclui(conjunto, ins->destino);
+            inclui(conjunto, ins->a);
+            inclui(conjunto, ins->b);
+            if (candidata(ins->a) >= 0) usada[candidata(ins->a)] = 1;
+            if (candidata(ins->b) >= 0) usada[candidata(ins->b)] = 1;
+        }
+    }
+    const unsigned int* na_entrada = entrada(0);
+    for (int c = 0; c < num_candidatas; c++) {
+        if (!pertence(na_entrada, c)) continue;
+        for (int x = 0; x < num_candidatas; x++) {
+            if (x != c) interfere(c, x);
+        }
+    }
+}
+
+static Operando troca_variavel(Operando o, Vinculo* const* representante) {
+    int c = candidata(o);
+    if (c >= 0 && representante[c] != o.var) o.var = representante[c];
+    return o;
+}
+
+static void junta_na_funcao(void) {
+    primeira = funcao->vinculo ? funcao->num_variaveis - funcao->num_criadas : 0;
+    primeira_copia = funcao->num_variaveis - funcao->num_criadas - primeira;
+    num_candidatas = funcao->num_variaveis - primeira;
+    if (num_candidatas == 0) return;
+    palavras = (num_candidatas + 31) / 32;
+    Vinculo** variaveis = funcao->variaveis + primeira;
+    for (int c = 0; c < num_candidatas; c++) variaveis[c]->numero_ssa = c + 1;
+
+    vivas = aloca_zerado(2 * funcao->num_blocos * palavras, sizeof(unsigned int));
+    unsigned int* conjunto = aloca_zerado(palavras, sizeof(unsigned int));
+    int removidas;
+    do {
+        calcula_vivas(conjunto);
+        removidas = remove_escritas_mortas(conjunto);
+        estatisticas_variaveis.escritas_removidas += removidas;
+    } while (removidas > 0);
+    interferencia = aloca_zerado(num_candidatas * palavras, sizeof(unsigned int));
+    int* usada = aloca_zerado(num_candidatas, sizeof(int));
+    calcula_interferencia(conjunto, usada);
+
+    // Cada cópia usada vai para a primeira anterior do mesmo tipo com que não interfere (a linha
+    // da escolhida passa a somar as interferências das duas) ou fica com a sua posição.
+    Vinculo** representante = aloca_zerado(num_candidatas, sizeof(Vinculo*));
+    for (int c = 0; c < num_candidatas; c++) {
+        representante[c] = variaveis[c];
+        if (c < primeira_copia || !usada[c]) continue;
+        for (int r = primeira_copia; r < c; r++) {
+            if (representante[r] != variaveis[r] || !usada[r] || variaveis[r]->tipo_dado != variaveis[c]->tipo_dado ||
+                pertence(interferencia + (size_t)r * palavras, c)) continue;
+            representante[c] = variaveis[r];
+            for (int x = 0; x < num_candidatas; x++) {
+                if (pertence(interferencia + (size_t)c * palavras, x)) interfere(r, x);
+            }
+            estatisticas_variaveis.variaveis_juntadas++;
+            break;
+        }
+    }
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        for (InstrucaoIR* ins = b->primeira; ins; ins = ins->proxima) {
+            ins->destino = troca_variavel(ins->destino, representante);
+            ins->a = troca_variavel(ins->a, representante);
+            ins->b = troca_variavel(ins->b, representante);
+        }
+        b->valor = troca_variavel(b->valor, representante);
+        b->valor2 = troca_variavel(b->valor2, representante);
+    }
+
+    // Ficam as variáveis usadas que não foram juntadas a outra. No quadro, as cópias que restam
+    // são postas de novo, em sequência, depois das declaradas.
+    int base = funcao->vinculo ? funcao->vinculo->tamanho_quadro - 4 * funcao->num_criadas : 0;
+    int n = 0, criadas = 0;
+    for (int c = 0; c < num_candidatas; c++) {
+        variaveis[c]->numero_ssa = 0;
+        if (!usada[c]) {
+            estatisticas_variaveis.variaveis_descartadas++;
+            continue;
+        }
+        if (representante[c] != variaveis[c]) continue;
+        if (c >= primeira_copia) {
+            criadas++;
+            if (funcao->vinculo) variaveis[c]->deslocamento = -(base + 4 * criadas);
+        }
+        variaveis[n++] = variaveis[c];
+    }
+    funcao->num_variaveis = primeira + n;
+    funcao->num_criadas = criadas;
+    if (funcao->vinculo) funcao->vinculo->tamanho_quadro = base + 4 * criadas;
+
+    free(representante);
+    free(usada);
+    free(interferencia);
+    free(conjunto);
+    free(vivas);
+    interferencia = vivas = NULL;
+}
+
+EstatisticasVariaveis junta_variaveis_copiadas(ProgramaIR* p) {
+    EstatisticasVariaveis zeradas = {0};
+    estatisticas_variaveis = zeradas;
+    for (int f = 0; f < p->num_funcoes; f++) {
+        funcao = p->funcoes[f];
+        junta_na_funcao();
+    }
+    funcao = NULL;
+    return estatisticas_variaveis;
+}
+
+void imprime_estatisticas_variaveis_copiadas(void) {
+    printf("Variáveis das cópias: %d escrita(s) sem leitura removida(s), %d variável(is) descartada(s), "
+           "%d juntada(s) a outra.\n", estatisticas_variaveis.escritas_removidas,
+           estatisticas_variaveis.variaveis_descartadas, estatisticas_variaveis.variaveis_juntadas);
+}
@@ -0,0 +1,50 @@
+#ifndef EXPANSAO_H
+#define EXPANSAO_H
+
+#include "ir.h"
+
+// --- Expansão de Funções em Linha (-O2) ---
+// Passada sobre o código intermediário, logo depois da sua geração. Cada chamada a uma função
+// do programa que não chama a si mesma e cujo corpo cabe no orçamento (em instruções do código
+// intermediário, contando os terminadores) é trocada por uma cópia desse corpo:
+//  - os parâmetros e as variáveis da função chamada viram variáveis novas de quem chama, e os
+//    temporários são renumerados, de modo que a cópia não se mistura com os nomes do chamador;
+//  - os argumentos passam a ser cópias para os parâmetros novos;
+//  - cada 'retorne' da cópia (inclusive os de dentro de 'se' aninhados) vira uma cópia do valor
+//    retornado para o destino da chamada e um salto para o que vinha depois dela.
+// As funções são visitadas na ordem do programa: como uma função só chama as declaradas antes
+// dela (ou a si mesma), as chamadas de dentro de um corpo já foram expandidas quando ele é copiado.
+
+// Orçamento usado quando a expansão vem ligada pelo nível de otimização.
+#define ORCAMENTO_EXPANSAO_PADRAO 20
+
+// Contadores do que a passada fez (para o relatório).
+typedef struct EstatisticasExpansao {
+    int chamadas_expandidas;    // Chamadas trocadas pelo corpo da função.
+    int chamadas_mantidas;      // Chamadas a funções do programa que ficaram como estavam.
+    int instrucoes_copiadas;    // Instruções (e terminadores) das cópias.
+} EstatisticasExpansao;
+
+// Expande as chamadas de todas as funções do programa e devolve o que foi feito. Com
+// 'depuracao', imprime a decisão tomada em cada chamada.
+EstatisticasExpansao expande_funcoes(ProgramaIR* programa, int orcamento, int depuracao);
+
+// Imprime o relatório da última execução.
+void imprime_estatisticas_expansao(void);
+
+// Contadores da passada sobre as variáveis das cópias (para o relatório).
+typedef struct EstatisticasVariaveis {
+    int escritas_removidas;     // Escritas em variáveis que ninguém lê depois.
+    int variaveis_descartadas;  // Variáveis que nenhuma instrução usa mais.
+    int variaveis_juntadas;     // Cópias que passaram a usar a posição de outra.
+} EstatisticasVariaveis;
+
+// Depois das demais otimizações: tira as escritas sem leitura e as variáveis sem uso deixadas
+// pelas cópias e faz as cópias que nunca estão vivas ao mesmo tempo dividirem a mesma posição
+// (no bloco principal, a mesma palavra da área global). Devolve o que foi feito.
+EstatisticasVariaveis junta_variaveis_copiadas(ProgramaIR* programa);
+
+// Imprime o relatório da última execução.
+void imprime_estatisticas_variaveis_copiadas(void);
+
+#endif // EXPANSAO_H
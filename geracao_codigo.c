@@ -1,532 +1,1000 @@
 #include <stdio.h>      // Para operações de entrada e saída (ex: fprintf, fopen).
 #include <stdlib.h>     // Para alocação de memória e outras funções padrão (ex: malloc, exit).
-#include <string.h>     // Para manipulação de strings (ex: strcmp, strcpy).
+#include <string.h>     // Para strlen.
 
 // Inclusão dos arquivos de cabeçalho do projeto.
 #include "geracao_codigo.h"  // Provavelmente contém o protótipo da função principal gerar_codigo.
-#include "arvore.h"          // Contém as definições da estrutura da Árvore Sintática Abstrata (No).
-#include "tabela_simbolos.h" // Contém as definições da Tabela de Símbolos e da Pilha de Escopos.
+#include "ir.h"              // Código intermediário (blocos básicos de instruções de três endereços).
+#include "alocacao.h"        // Distribuição dos temporários do código intermediário pelos registradores.
+#include "tabela_simbolos.h" // Contém a definição dos vínculos (onde cada variável vive).
+#include "emissor.h"         // Registros de instrução MIPS acumulados em memória.
+#include "peephole.h"        // Otimização de janela sobre as instruções acumuladas.
+#include "biblioteca.h"      // Rotinas de entrada e saída com buffer.
 
 // --- Estruturas e Variáveis Globais ---
 
-// Estrutura para criar uma lista encadeada de literais de string.
-// Isso é usado para coletar todas as strings do código fonte e declará-las
-// na seção .data do arquivo Assembly.
-typedef struct StringLiteral {
-    char label[20];                // Rótulo único para a string no assembly (ex: "str_0").
-    char* content;                 // Ponteiro para o conteúdo da string (ex: "\"Olá, Mundo!\"").
-    struct StringLiteral* next;    // Ponteiro para o próximo elemento na lista.
-} StringLiteral;
-
 // Variáveis Globais Estáticas. 'static' significa que são visíveis apenas dentro deste arquivo.
-static FILE* arquivo_saida;                  // Ponteiro para o arquivo .asm de saída onde o código MIPS será escrito.
-static int contador_label = 0;               // Contador para gerar rótulos (labels) únicos para desvios (if, while).
-static int contador_string = 0;              // Contador para gerar rótulos únicos para as strings.
-static PilhaDeTabelas pilha_escopos_gc;      // A pilha de tabelas de símbolos para gerenciar escopos (global, funções).
-static int offset_global = 0;                // Deslocamento (offset) para alocação de variáveis globais na pilha.
-static int offset_local = 0;                 // Deslocamento para alocação de variáveis locais no frame da função atual.
-static Simbolo* funcao_atual_gc = NULL;      // Ponteiro para o símbolo da função que está sendo processada.
-static StringLiteral* lista_strings = NULL;  // Cabeça da lista encadeada de literais de string.
-
-// Protótipos de funções internas deste arquivo.
-void visita_no_gc(No* no);       // Função principal que percorre a árvore (visitor pattern).
-void coletar_strings(No* no);    // Função para pré-processar a árvore e encontrar todas as strings.
+static CodigoMips codigo;                    // Instruções geradas, mantidas em memória até o fim da geração.
+static OpcoesGeracao opcoes;                 // Opções recebidas por gerar_codigo.
+static const ProgramaIR* programa_atual;     // Programa que está sendo traduzido.
+static FuncaoIR* funcao_atual = NULL;        // Função que está sendo traduzida.
+static Alocacao alocacao;                    // Registradores dos temporários da função atual.
+static int rotinas_usadas[NUM_ROTINAS];      // Rotinas da biblioteca chamadas pelo código gerado.
+
+// Quadro da função atual. As variáveis vivem onde a análise semântica decidiu; abaixo delas
+// (a partir de 'inicio_slots' bytes da base) ficam os temporários que não couberam em
+// registradores e as posições onde os $t vivos são guardados durante as chamadas.
+static Registrador base_quadro;              // $fp (no bloco principal, só para os temporários).
+static int inicio_slots;
+static int num_slots_salvamento;
+static int slot_salvamento[NUM_REGISTRADORES]; // Posição onde cada $t é guardado nas chamadas (-1 = nunca).
+
+// Os registradores $t8 e $t9 não são alocados: servem para carregar operandos que estão na memória.
+#define AUXILIAR_1 REG_T8
+#define AUXILIAR_2 REG_T9
 
 
 // --- Funções Auxiliares ---
 
-// Gera um número de rótulo único e o incrementa.
-// Usado para criar labels como L_ELSE_1, L_FIM_IF_2, etc.
-int novo_label() {
-    return contador_label++;
-}
-
-// Converte um operador da linguagem fonte para a instrução MIPS correspondente.
-// Recebe uma string como "+" e retorna a string "add".
-const char* get_op_mips(const char* op) {
-    if (strcmp(op, "+") == 0) return "add";   // Adição
-    if (strcmp(op, "-") == 0) return "sub";   // Subtração
-    if (strcmp(op, "*") == 0) return "mul";   // Multiplicação
-    if (strcmp(op, "/") == 0) return "div";   // Divisão
-    if (strcmp(op, "e") == 0) return "and";   // E lógico (bitwise)
-    if (strcmp(op, "ou") == 0) return "or";   // OU lógico (bitwise)
-    if (strcmp(op, "==") == 0) return "seq";  // Set if equal
-    if (strcmp(op, "!=") == 0) return "sne";  // Set if not equal
-    if (strcmp(op, "<") == 0) return "slt";   // Set if less than
-    if (strcmp(op, "<=") == 0) return "sle";  // Set if less than or equal
-    if (strcmp(op, ">") == 0) return "sgt";   // Set if greater than
-    if (strcmp(op, ">=") == 0) return "sge";  // Set if greater than or equal
-    return ""; // Retorna string vazia se o operador não for encontrado.
-}
-
-// Calcula e carrega o endereço de uma variável no registrador $t0.
-void get_endereco_var(const char* nome) {
-    // Busca o símbolo da variável em todos os escopos, do mais interno para o mais externo.
-    Simbolo* s = buscar_em_todos_escopos(&pilha_escopos_gc, nome);
-    if (!s) {
-        // Se a variável não for encontrada, é um erro semântico que deveria ter sido pego antes.
-        fprintf(stderr, "Erro de Geração: Variável '%s' não encontrada.\n", nome);
-        exit(1);
+// Converte um operador do código intermediário para a instrução MIPS correspondente.
+static Opcode get_op_mips(OperadorIR op) {
+    switch (op) {
+        case OPR_SOMA:          return OP_ADD;  // Adição
+        case OPR_SUBTRACAO:     return OP_SUB;  // Subtração
+        case OPR_MULTIPLICACAO: return OP_MUL;  // Multiplicação
+        case OPR_DIVISAO:       return OP_DIV;  // Divisão
+        case OPR_IGUAL:         return OP_SEQ;  // Set if equal
+        case OPR_DIFERENTE:     return OP_SNE;  // Set if not equal
+        case OPR_MENOR:         return OP_SLT;  // Set if less than
+        case OPR_MENOR_IGUAL:   return OP_SLE;  // Set if less than or equal
+        case OPR_MAIOR:         return OP_SGT;  // Set if greater than
+        case OPR_MAIOR_IGUAL:   return OP_SGE;  // Set if greater than or equal
+        case OPR_DESLOCA_ESQUERDA:       return OP_SLL; // Shift left logical
+        case OPR_DESLOCA_DIREITA:        return OP_SRA; // Shift right arithmetic
+        case OPR_DESLOCA_DIREITA_LOGICO: return OP_SRL; // Shift right logical
+        case OPR_SOMA_MODULAR:           return OP_ADDU; // Add unsigned (no overflow trap)
+        case OPR_SUBTRACAO_MODULAR:      return OP_SUBU; // Subtract unsigned (no overflow trap)
+        default:
+            fprintf(stderr, "Erro de Geração: Operador %d desconhecido.\n", op);
+            exit(1);
     }
-    // Verifica se a variável é global (escopo 0).
-    if (s->escopo == 0) {
-        // Variáveis globais são acessadas a partir de um ponteiro base para a área global ($s1).
-        // O endereço é ($s1 + offset). O offset está em s->num_params por reutilização do campo.
-        fprintf(arquivo_saida, "  addi $t0, $s1, %d\n", s->num_params);
-    } else {
-        // Variáveis locais e parâmetros são acessados a partir do frame pointer ($fp).
-        // O endereço é ($fp + offset). O offset está em s->num_params.
-        fprintf(arquivo_saida, "  addi $t0, $fp, %d\n", s->num_params);
+}
+
+// Desvio condicional que salta quando a comparação vale.
+static Opcode get_desvio_mips(OperadorIR op) {
+    switch (op) {
+        case OPR_IGUAL:         return OP_BEQ;
+        case OPR_DIFERENTE:     return OP_BNE;
+        case OPR_MENOR:         return OP_BLT;
+        case OPR_MENOR_IGUAL:   return OP_BLE;
+        case OPR_MAIOR:         return OP_BGT;
+        case OPR_MAIOR_IGUAL:   return OP_BGE;
+        default:
+            fprintf(stderr, "Erro de Geração: Operador %d não é uma comparação.\n", op);
+            exit(1);
     }
 }
 
+// Rótulo do início de um bloco básico (o mesmo nome da listagem do código intermediário).
+static Rotulo rotulo_bloco(const BlocoBasico* b) {
+    return rotulo_numerado("B", b->id);
+}
+
+// Retorna o registrador base do endereço de uma variável (o deslocamento está no vínculo).
+// Variáveis globais (e as do bloco principal) são acessadas a partir do início da área global
+// na seção .data ($gp); variáveis locais e parâmetros, a partir do frame pointer ($fp).
+static Registrador base_da_variavel(const Vinculo* v) {
+    return v->classe == ARMAZ_GLOBAL ? REG_GP : REG_FP;
+}
 
-// --- Funções de Geração de Código por Nó da Árvore ---
+// Na área global, uma variável 'car' ocupa um só byte (no quadro, tudo ocupa 4 bytes).
+static int ocupa_um_byte(const Vinculo* v) {
+    return v->classe == ARMAZ_GLOBAL && v->tipo_dado == TIPO_CAR;
+}
 
-// Gera código para uma declaração de função.
-void gc_declaracao_funcao(No* no) {
-    // Extrai o nome da função do nó da árvore.
-    char* nome_funcao = no->lexema;
-    
-    // Cria um símbolo para a função para inserí-lo na tabela de símbolos do escopo global.
-    Simbolo s_funcao;
-    strcpy(s_funcao.nome, nome_funcao);
-    s_funcao.categoria = CAT_FUNCAO;
-    s_funcao.params = no->filho2; // Referência aos nós dos parâmetros na árvore.
-    int n_params = 0; // Conta o número de parâmetros.
-    for (No* p = no->filho2; p != NULL; p = p->proximo) n_params++;
-    s_funcao.num_params = n_params;
-    inserir_na_pilha(&pilha_escopos_gc, s_funcao); // Insere no escopo atual (global).
-    
-    // Define a função atual para referência interna (ex: para a instrução de retorno).
-    funcao_atual_gc = buscar_no_escopo_atual(&pilha_escopos_gc, nome_funcao);
+static int deslocamento_slot(int slot) {
+    return -(inicio_slots + 4 * (slot + 1));
+}
 
-    // Inicia a seção de código para a função no arquivo .asm.
-    fprintf(arquivo_saida, "\n# ---- Funcao: %s ----\n", nome_funcao);
-    fprintf(arquivo_saida, "%s:\n", nome_funcao); // Cria o rótulo (label) da função.
-
-    // Gera o Prólogo da função: prepara a pilha para a execução da função.
-    fprintf(arquivo_saida, "  # Prólogo\n");
-    fprintf(arquivo_saida, "  addiu $sp, $sp, -4\n"); // Abre espaço na pilha.
-    fprintf(arquivo_saida, "  sw $ra, 0($sp)\n");      // Salva o endereço de retorno ($ra).
-    fprintf(arquivo_saida, "  addiu $sp, $sp, -4\n"); // Abre espaço na pilha.
-    fprintf(arquivo_saida, "  sw $fp, 0($sp)\n");      // Salva o frame pointer antigo ($fp).
-    fprintf(arquivo_saida, "  move $fp, $sp\n");       // O novo $fp aponta para o topo da pilha.
-
-    // Cria um novo escopo para a função (parâmetros e variáveis locais).
-    empilhar(&pilha_escopos_gc);
-    
-    // Processa os parâmetros da função, inserindo-os na tabela de símbolos do novo escopo.
-    int offset_param = 8; // Offset inicial para o primeiro parâmetro relativo ao $fp.
-    for (No* p = no->filho2; p != NULL; p = p->proximo) {
-        Simbolo s_param;
-        strcpy(s_param.nome, p->filho1->lexema); // Nome do parâmetro.
-        s_param.categoria = CAT_PARAMETRO;
-        s_param.tipo_dado = string_para_tipo(p->lexema); // Tipo do parâmetro.
-        s_param.num_params = offset_param; // Armazena o offset do parâmetro.
-        inserir_na_pilha(&pilha_escopos_gc, s_param);
-        offset_param += 4; // Move para o próximo offset de parâmetro (cada um ocupa 4 bytes).
-    }
-
-    // Aloca espaço na pilha para as variáveis locais.
-    offset_local = 0; // Reseta o offset local para esta função.
-    int espaco_locais = 0;
-    // Calcula o espaço total necessário para as variáveis locais.
-    if (no->filho3 && no->filho3->filho1) { // Verifica se há um bloco de declarações.
-        for(No* decl = no->filho3->filho1; decl != NULL; decl = decl->proximo) {
-            espaco_locais += 4; // Adiciona 4 bytes por variável.
+
+// --- Promoção de Variáveis para Registradores ---
+// Com a opção 'promover_registradores', as variáveis mais usadas de cada função (e do bloco
+// principal) passam a viver em $s2-$s7 em vez da pilha: cada leitura vira o próprio registrador
+// e cada escrita um 'move'. Só são candidatas as variáveis locais e os parâmetros, que nenhuma
+// outra função enxerga; as globais continuam na memória. Os registradores $s são preservados
+// pelas funções chamadas ("callee-saved"), então o prólogo salva os que a função usar e o
+// epílogo os restaura.
+#define NUM_PROMOVIVEIS 6
+static const Registrador registradores_promocao[NUM_PROMOVIVEIS] = {
+    REG_S2, REG_S3, REG_S4, REG_S5, REG_S6, REG_S7
+};
+#define PROFUNDIDADE_MAXIMA_PESO 5 // Limita o peso (8^5) para não transbordar em laços muito aninhados.
+
+static int funcao_folha = 0;         // A função atual não muda $ra: não chama outras (ver gc_funcao).
+static int funcao_sem_quadro = 0;    // A função atual é folha e não monta quadro.
+static int num_promovidas = 0;        // Quantas variáveis da função atual estão em $s2-$s7.
+// Quantos registradores de registradores_promocao a função usa (as promovidas vêm primeiro; os
+// seguintes são os que a alocação deu a temporários que atravessam chamadas).
+static int num_registradores_s = 0;
+
+static void soma_uso(Operando o, int peso) {
+    if (o.tipo == OPERANDO_VAR) o.var->peso_uso += peso;
+}
+
+// Soma os usos de cada variável no código da função. Um uso dentro de 'profundidade' laços
+// vale 8^profundidade, já que deve ser executado muitas vezes. (Os pesos de variáveis que não
+// são candidatas são ignorados.)
+static void conta_usos(FuncaoIR* funcao) {
+    for (int i = 0; i < funcao->num_variaveis; i++) funcao->variaveis[i]->peso_uso = 0;
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        int p = b->profundidade_laco < PROFUNDIDADE_MAXIMA_PESO ? b->profundidade_laco : PROFUNDIDADE_MAXIMA_PESO;
+        int peso = 1 << (3 * p);
+        for (InstrucaoIR* ins = b->primeira; ins; ins = ins->proxima) {
+            soma_uso(ins->destino, peso);
+            soma_uso(ins->a, peso);
+            soma_uso(ins->b, peso);
         }
+        soma_uso(b->valor, peso);
+        soma_uso(b->valor2, peso);
     }
-    if (espaco_locais > 0) {
-        // Subtrai do stack pointer ($sp) o espaço calculado.
-        fprintf(arquivo_saida, "  addiu $sp, $sp, -%d # Aloca espaço para var(es) local(is)\n", espaco_locais);
+}
+
+static int argumentos_empilhados(const Vinculo* f) {
+    return f->num_params > PARAMETROS_EM_REGISTRADORES ? f->num_params - PARAMETROS_EM_REGISTRADORES : 0;
+}
+
+// Indica se 'ins' é uma chamada de cauda (ver gc_chamada_de_cauda): a última instrução de um
+// bloco que devolve o valor dela, para uma função que recebe tantos argumentos empilhados
+// quanto a atual (eles ocupam o lugar dos recebidos).
+static int eh_chamada_de_cauda(const BlocoBasico* b, const InstrucaoIR* ins) {
+    return opcoes.chamadas_de_cauda && funcao_atual->vinculo && ins->op == IR_CHAMADA &&
+           ins->proxima == NULL && b->terminador == TERM_RETORNO &&
+           (ins->destino.tipo == OPERANDO_TEMP || ins->destino.tipo == OPERANDO_NENHUM) &&
+           b->valor.tipo == ins->destino.tipo && b->valor.valor == ins->destino.valor &&
+           argumentos_empilhados(ins->funcao) == argumentos_empilhados(funcao_atual->vinculo);
+}
+
+// Com a saída com buffer, a entrada e a saída são chamadas às rotinas da biblioteca.
+static int chama_a_biblioteca(const InstrucaoIR* ins) {
+    return opcoes.saida_com_buffer && (ins->op == IR_LEIA || ins->op == IR_ESCREVA ||
+                                       ins->op == IR_ESCREVA_CADEIA || ins->op == IR_NOVALINHA);
+}
+
+// Uma chamada de cauda não muda $ra (é um salto): só as demais contam.
+static int faz_chamadas(const FuncaoIR* funcao) {
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        for (InstrucaoIR* ins = b->primeira; ins; ins = ins->proxima) {
+            if ((ins->op == IR_CHAMADA && !eh_chamada_de_cauda(b, ins)) || chama_a_biblioteca(ins)) return 1;
+        }
     }
-    
-    // Gera o código para o corpo da função (bloco de comandos).
-    visita_no_gc(no->filho3);
+    return 0;
+}
 
-    // Gera o Epílogo da função: restaura a pilha e retorna ao chamador.
-    fprintf(arquivo_saida, "\n%s_epilogo:\n", nome_funcao); // Rótulo para o epílogo (usado pelo 'retorna').
-    fprintf(arquivo_saida, "  # Epílogo\n");
-    fprintf(arquivo_saida, "  move $sp, $fp\n");       // Restaura o $sp para a posição do $fp.
-    fprintf(arquivo_saida, "  lw $fp, 0($sp)\n");      // Restaura o $fp antigo.
-    fprintf(arquivo_saida, "  lw $ra, 4($sp)\n");      // Restaura o endereço de retorno $ra.
-    fprintf(arquivo_saida, "  addiu $sp, $sp, 8\n");   // Libera o espaço do $fp e $ra salvos.
-    fprintf(arquivo_saida, "  addiu $sp, $sp, %d\n", 4 * n_params); // Libera o espaço dos argumentos passados.
-    fprintf(arquivo_saida, "  jr $ra\n");              // Retorna para o endereço em $ra (jump register).
-
-    // Destrói o escopo da função.
-    desempilhar(&pilha_escopos_gc);
-    // Indica que não estamos mais dentro de uma função.
-    funcao_atual_gc = NULL;
-}
-
-// Gera código para uma declaração de variável.
-void gc_declaracao_var(No* no) {
-    char* nome_var = no->filho1->lexema; // Nome da variável.
-    Simbolo s;
-    strcpy(s.nome, nome_var);
-    s.tipo_dado = string_para_tipo(no->lexema); // Tipo da variável.
-    
-    // Verifica se é uma variável global (declarada fora de qualquer função).
-    if (funcao_atual_gc == NULL) { // Estamos no escopo global.
-        s.escopo = 0; // Marca como escopo global.
-        offset_global -= 4; // Decrementa o offset global (pilha cresce para baixo).
-        s.num_params = offset_global; // Armazena o offset (reutilizando campo).
-        inserir_na_pilha(&pilha_escopos_gc, s);
-        // Aloca espaço na "área global" da pilha.
-        fprintf(arquivo_saida, "  addiu $sp, $sp, -4\n");
-    } else { // É uma variável local.
-        offset_local -= 4; // Decrementa o offset local (relativo ao $fp).
-        s.num_params = offset_local; // Armazena o offset.
-        inserir_na_pilha(&pilha_escopos_gc, s);
-        // O espaço para variáveis locais já foi alocado no prólogo da função.
-    }
-}
-
-// Gera código para uma chamada de função.
-void gc_chamada_funcao(No* no) {
-    const char* nome_funcao = no->lexema;
-
-    // Tratamento especial para a função "escreva".
-    if (strcmp(nome_funcao, "escreva") == 0) {
-        No* arg = no->filho1; // Pega o argumento.
-        
-        // Verifica se o argumento é uma constante string (contém aspas).
-        if (arg->tipo_no == NO_CONST_CAR && strchr(arg->lexema, '"')) {
-            // Procura a string na lista de strings pré-coletadas.
-            StringLiteral* current = lista_strings;
-            while(current) {
-                if (strcmp(current->content, arg->lexema) == 0) break;
-                current = current->next;
+// Maior número de argumentos passados em registradores numa chamada (de cauda, numa folha).
+static int maior_argumento_em_registrador(const FuncaoIR* funcao) {
+    int maior = 0;
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        for (InstrucaoIR* ins = funcao->blocos[i]->primeira; ins; ins = ins->proxima) {
+            if (ins->op == IR_ARGUMENTO && ins->posicao < PARAMETROS_EM_REGISTRADORES && ins->posicao >= maior) {
+                maior = ins->posicao + 1;
+            }
+        }
+    }
+    return maior;
+}
+
+// Indica se algum argumento de posição menor que 'posicao' lê a variável. Os argumentos são
+// passados do último para o primeiro: esses vêm depois que o de 'posicao' mudou o seu $a.
+static int lida_depois_do_argumento(const FuncaoIR* funcao, const Vinculo* v, int posicao) {
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        for (InstrucaoIR* ins = funcao->blocos[i]->primeira; ins; ins = ins->proxima) {
+            if (ins->op == IR_ARGUMENTO && ins->posicao < posicao && ins->a.tipo == OPERANDO_VAR && ins->a.var == v) {
+                return 1;
             }
-            // Gera código para imprimir uma string.
-            fprintf(arquivo_saida, "  la $a0, %s\n", current->label); // Carrega o endereço da string em $a0.
-            fprintf(arquivo_saida, "  li $v0, 4\n");                 // Código de serviço 4 (print_string).
-            fprintf(arquivo_saida, "  syscall\n");                   // Executa a chamada de sistema.
-        } else {
-            // Se não for uma string, avalia a expressão do argumento.
-            visita_no_gc(arg);
-            // O resultado da avaliação está em $s0. Move para $a0 (argumento da syscall).
-            fprintf(arquivo_saida, "  move $a0, $s0\n");
-            
-            // Verifica o tipo do argumento para usar a syscall correta.
-            if (arg->tipo_dado == TIPO_CAR) {
-                fprintf(arquivo_saida, "  li $v0, 11\n"); // Código 11 (print_character).
-            } else { // Assume TIPO_INT.
-                fprintf(arquivo_saida, "  li $v0, 1\n");  // Código 1 (print_integer).
+        }
+    }
+    return 0;
+}
+
+static int escreve_algo(const FuncaoIR* funcao) {
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        for (InstrucaoIR* ins = funcao->blocos[i]->primeira; ins; ins = ins->proxima) {
+            if (ins->op == IR_ESCREVA || ins->op == IR_ESCREVA_CADEIA || ins->op == IR_NOVALINHA) return 1;
+        }
+    }
+    return 0;
+}
+
+// Registrador em que chega o parâmetro 'v', ou REG_ZERO se ele é empilhado pelo chamador.
+static Registrador registrador_do_parametro(const Vinculo* v) {
+    if (v->classe != ARMAZ_PARAMETRO || v->deslocamento > 0) return REG_ZERO;
+    int posicao = 0;
+    for (No* p = funcao_atual->vinculo->params; p->vinculo != v; p = p->proximo) posicao++;
+    return REG_A0 + posicao;
+}
+
+// Instruções depois das quais os registradores $a0-$a3 já não têm os argumentos recebidos.
+static int muda_registradores_argumento(const InstrucaoIR* ins) {
+    return ins->op == IR_ARGUMENTO || ins->op == IR_CHAMADA || ins->op == IR_ESCREVA ||
+           ins->op == IR_ESCREVA_CADEIA || ins->op == IR_NOVALINHA;
+}
+
+static int conta_ocorrencias(Operando o, const Vinculo* v) {
+    return o.tipo == OPERANDO_VAR && o.var == v;
+}
+
+// Um parâmetro que chega num registrador pode continuar nele, sem ser guardado no quadro, se
+// nunca é escrito e todas as suas leituras vêm no bloco de entrada antes que os registradores
+// $a mudem. É o caso da forma SSA, que lê cada parâmetro uma vez, no início da função.
+// Numa função folha, só as escritas (que usam $a0) e os argumentos de uma chamada de cauda mudam
+// esses registradores: o parâmetro pode ficar neles a função toda.
+static void mantem_parametros_nos_registradores(FuncaoIR* funcao) {
+    if (!funcao->vinculo) return;
+    for (No* p = funcao->vinculo->params; p != NULL; p = p->proximo) {
+        Vinculo* v = p->vinculo;
+        if (registrador_do_parametro(v) == REG_ZERO) continue;
+        Registrador chegada = registrador_do_parametro(v);
+        if (funcao_folha && (chegada != REG_A0 || !escreve_algo(funcao)) &&
+            !lida_depois_do_argumento(funcao, v, chegada - REG_A0)) {
+            v->registrador = registrador_do_parametro(v);
+            continue;
+        }
+        if (funcao->blocos[0]->num_predecessores > 0) continue;
+        int leituras = 0, leituras_no_inicio = 0, escrito = 0;
+        for (int i = 0; i < funcao->num_blocos; i++) {
+            BlocoBasico* b = funcao->blocos[i];
+            int no_inicio = i == 0;
+            for (InstrucaoIR* ins = b->primeira; ins; ins = ins->proxima) {
+                int n = conta_ocorrencias(ins->a, v) + conta_ocorrencias(ins->b, v);
+                leituras += n;
+                if (no_inicio) leituras_no_inicio += n;
+                if (conta_ocorrencias(ins->destino, v)) escrito = 1;
+                if (muda_registradores_argumento(ins)) no_inicio = 0;
             }
-            fprintf(arquivo_saida, "  syscall\n");
+            int n = conta_ocorrencias(b->valor, v) + conta_ocorrencias(b->valor2, v);
+            leituras += n;
+            if (no_inicio) leituras_no_inicio += n;
         }
-        return; // Finaliza o tratamento de "escreva".
+        if (!escrito && leituras == leituras_no_inicio) v->registrador = registrador_do_parametro(v);
     }
+}
 
-    // Tratamento especial para a função "leia".
-    if (strcmp(nome_funcao, "leia") == 0) {
-        fprintf(arquivo_saida, "  li $v0, 5\n");      // Código de serviço 5 (read_integer).
-        fprintf(arquivo_saida, "  syscall\n");        // O inteiro lido fica em $v0.
-        get_endereco_var(no->filho1->lexema);         // Pega o endereço da variável de destino em $t0.
-        fprintf(arquivo_saida, "  sw $v0, 0($t0)\n"); // Armazena o valor lido ($v0) no endereço em $t0.
-        return;
+// Uma função folha (que não chama outras) pode guardar variáveis, sem custo, nos registradores
+// que ninguém espera que ela preserve e que nada destrói durante a sua execução: $v1 e os
+// $a0-$a3 que não trazem parâmetros nem argumentos de chamadas de cauda ($a0 só se ela não
+// escreve, pois as escritas o usam).
+static int registradores_livres_da_folha(const FuncaoIR* funcao, Registrador* livres) {
+    int n = 0;
+    livres[n++] = REG_V1;
+    int ocupados = funcao->vinculo->num_params;
+    if (maior_argumento_em_registrador(funcao) > ocupados) ocupados = maior_argumento_em_registrador(funcao);
+    for (int k = PARAMETROS_EM_REGISTRADORES - 1; k >= ocupados; k--) {
+        if (k > 0 || !escreve_algo(funcao)) livres[n++] = REG_A0 + k;
     }
+    return n;
+}
 
-    // Tratamento especial para a função "novalinha".
-    if (strcmp(nome_funcao, "novalinha") == 0) {
-        fprintf(arquivo_saida, "  li $a0, '\\n'\n");   // Carrega o caractere de nova linha em $a0.
-        fprintf(arquivo_saida, "  li $v0, 11\n");      // Código de serviço 11 (print_character).
-        fprintf(arquivo_saida, "  syscall\n");         // Executa.
-        return;
+// A variável ainda na memória com o maior peso acima do custo de promovê-la ('com_custo' = 0
+// para registradores que não precisam ser salvos), ou NULL.
+static Vinculo* mais_usada(const FuncaoIR* funcao, int com_custo) {
+    Vinculo* melhor = NULL;
+    for (int i = 0; i < funcao->num_variaveis; i++) {
+        Vinculo* v = funcao->variaveis[i];
+        int custo = !com_custo ? 0 : v->classe != ARMAZ_PARAMETRO ? 2 : registrador_do_parametro(v) != REG_ZERO ? 1 : 3;
+        if (!v->registrador && v->peso_uso > custo && (!melhor || v->peso_uso > melhor->peso_uso)) {
+            melhor = v;
+        }
+    }
+    return melhor;
+}
+
+// Escolhe as variáveis de uma função (ou do bloco principal) que ficarão em registradores.
+// Uma promoção só compensa se os usos economizados superarem o custo fixo: salvar e restaurar
+// o registrador $s (2 acessos) e, para parâmetros empilhados, carregar o argumento (mais 1).
+// Um parâmetro recebido num registrador teria de ser guardado no quadro de qualquer jeito.
+// Numa função folha, os registradores livres vêm antes, e qualquer uso já compensa.
+static void escolhe_promovidas(FuncaoIR* funcao) {
+    num_promovidas = 0;
+    if (!opcoes.promover_registradores) return;
+    conta_usos(funcao);
+
+    // Seleção simples dos maiores pesos (são no máximo NUM_PROMOVIVEIS rodadas).
+    Vinculo* melhor;
+    if (funcao_folha) {
+        Registrador livres[1 + PARAMETROS_EM_REGISTRADORES];
+        int num_livres = registradores_livres_da_folha(funcao, livres);
+        for (int k = 0; k < num_livres && (melhor = mais_usada(funcao, 0)) != NULL; k++) {
+            melhor->registrador = livres[k];
+        }
+    }
+    while (num_promovidas < NUM_PROMOVIVEIS && (melhor = mais_usada(funcao, 1)) != NULL) {
+        melhor->registrador = registradores_promocao[num_promovidas++];
     }
 
-    // --- Tratamento para chamadas de funções definidas pelo usuário ---
-    
-    // Coleta todos os argumentos em um array.
-    No* args[20]; // Supõe um máximo de 20 argumentos.
-    int n_args = 0;
-    for (No* arg = no->filho1; arg != NULL; arg = arg->proximo) {
-        args[n_args++] = arg;
-    }
-
-    // Empilha os argumentos na ordem inversa (da direita para a esquerda).
-    for (int i = n_args - 1; i >= 0; i--) {
-        No* arg_atual = args[i];
-        // Temporariamente 'desconecta' o nó para visitar apenas ele.
-        No* proximo_temp = arg_atual->proximo; 
-        arg_atual->proximo = NULL;
-        visita_no_gc(arg_atual); // Avalia a expressão do argumento, resultado em $s0.
-        arg_atual->proximo = proximo_temp; // 'Reconecta' o nó.
-
-        // Empilha o resultado da avaliação do argumento.
-        fprintf(arquivo_saida, "  addiu $sp, $sp, -4\n"); // Abre espaço na pilha.
-        fprintf(arquivo_saida, "  sw $s0, 0($sp)\n");      // Salva o resultado ($s0) na pilha.
-    }
-    
-    // Chama a função.
-    fprintf(arquivo_saida, "  jal %s\n", nome_funcao); // Jump And Link: salta para a função e salva o endereço de retorno em $ra.
-}
-
-
-// Gera código para uma operação de atribuição.
-void gc_atribuicao(No* no) {
-    // Avalia o lado direito da atribuição. O resultado vai para $s0.
-    visita_no_gc(no->filho2);
-    // Pega o endereço da variável do lado esquerdo. O endereço vai para $t0.
-    get_endereco_var(no->filho1->lexema);
-    // Armazena o resultado ($s0) no endereço da variável ($t0).
-    fprintf(arquivo_saida, "  sw $s0, 0($t0)\n");
-}
-
-
-// Gera código para uma operação binária (aritmética, lógica, relacional).
-void gc_op_binaria(No* no) {
-    // Avalia a expressão da esquerda. Resultado em $s0.
-    visita_no_gc(no->filho1);
-    // Salva o resultado da esquerda na pilha temporariamente.
-    fprintf(arquivo_saida, "  addiu $sp, $sp, -4\n");
-    fprintf(arquivo_saida, "  sw $s0, 0($sp)\n");
-    // Avalia a expressão da direita. Resultado em $s0.
-    visita_no_gc(no->filho2);
-    // Recupera o resultado da esquerda da pilha para $t1.
-    fprintf(arquivo_saida, "  lw $t1, 0($sp)\n");
-    fprintf(arquivo_saida, "  addiu $sp, $sp, 4\n");
-    // Executa a operação MIPS. Ex: add $s0, $t1, $s0  ($s0 = $t1 + $s0)
-    fprintf(arquivo_saida, "  %s $s0, $t1, $s0\n", get_op_mips(no->lexema));
-    // O resultado de uma operação é sempre um inteiro (ou booleano, que é 0 ou 1).
-    no->tipo_dado = TIPO_INT; 
-}
-
-// Gera código para a instrução 'retorna'.
-void gc_retorno(No* no) {
-    if (no->filho1) {
-        // Se houver uma expressão de retorno, avalia-a.
-        // O valor de retorno, por convenção, deve ser colocado em $v0, mas aqui
-        // o código o coloca em $s0. O epílogo pode mover de $s0 para $v0 se necessário,
-        // ou o chamador pode esperar o resultado em $s0. (Neste código, o resultado da função
-        // parece ser implicitamente deixado em $s0, e o chamador o usa a partir daí).
-        visita_no_gc(no->filho1);
-    }
-    // Salta para o epílogo da função para restaurar a pilha e retornar.
-    fprintf(arquivo_saida, "  j %s_epilogo\n", funcao_atual_gc->nome);
-}
-
-// Gera código para um bloco de comandos.
-void gc_bloco(No* no) {
-    // Visita a lista de declarações (se houver).
-    visita_no_gc(no->filho1);
-    // Visita a lista de comandos.
-    visita_no_gc(no->filho2);
-}
-
-// Gera código para uma estrutura condicional 'se' (if).
-void gc_if(No* no) {
-    int l_else = novo_label(); // Cria um rótulo para o bloco 'senao'.
-    int l_fim = novo_label();  // Cria um rótulo para o final do 'se'.
-    
-    // Avalia a condição. O resultado (0 para falso, não-zero para verdadeiro) fica em $s0.
-    visita_no_gc(no->filho1);
-    
-    // Se o resultado for zero (falso), salta para o bloco 'senao'.
-    fprintf(arquivo_saida, "  beqz $s0, L_ELSE_%d\n", l_else);
-    
-    // Gera código para o bloco 'entao' (corpo do if).
-    visita_no_gc(no->filho2);
-    
-    // Salta incondicionalmente para o final do 'se' para não executar o 'senao'.
-    fprintf(arquivo_saida, "  j L_FIM_IF_%d\n", l_fim);
-    
-    // Imprime o rótulo do bloco 'senao'.
-    fprintf(arquivo_saida, "L_ELSE_%d:\n", l_else);
-    if (no->filho3) {
-        // Se existir um bloco 'senao', gera o código para ele.
-        visita_no_gc(no->filho3);
-    }
-    
-    // Imprime o rótulo do final do 'se'.
-    fprintf(arquivo_saida, "L_FIM_IF_%d:\n", l_fim);
-}
-
-// Gera código para um laço 'enquanto' (while).
-void gc_while(No* no) {
-    int l_inicio = novo_label(); // Cria rótulo para o início do laço (teste da condição).
-    int l_fim = novo_label();    // Cria rótulo para o fim do laço.
-    
-    // Imprime o rótulo de início.
-    fprintf(arquivo_saida, "L_WHILE_%d:\n", l_inicio);
-    
-    // Avalia a condição do laço. Resultado em $s0.
-    visita_no_gc(no->filho1);
-    
-    // Se a condição for falsa (resultado é 0), salta para o fim do laço.
-    fprintf(arquivo_saida, "  beqz $s0, L_FIM_WHILE_%d\n", l_fim);
-    
-    // Gera código para o corpo do laço.
-    visita_no_gc(no->filho2);
-    
-    // Salta de volta para o início do laço para reavaliar a condição.
-    fprintf(arquivo_saida, "  j L_WHILE_%d\n", l_inicio);
-    
-    // Imprime o rótulo de fim do laço.
-    fprintf(arquivo_saida, "L_FIM_WHILE_%d:\n", l_fim);
-}
-
-// Função principal de visitação da árvore (Dispatcher).
-// Ela verifica o tipo de cada nó e chama a função de geração de código apropriada.
-void visita_no_gc(No* no) {
-    if (!no) return; // Condição de parada da recursão.
-    
-    switch (no->tipo_no) {
-        case NO_PROGRAMA:
-            // Visita as declarações globais (variáveis e funções).
-            visita_no_gc(no->filho1);
-            // Inicia o ponto de entrada principal do programa.
-            fprintf(arquivo_saida, "\n# ---- Bloco Principal (programa) ----\n");
-            fprintf(arquivo_saida, "main:\n");
-            // Salva o ponteiro de pilha inicial em $s1 para ser a base das variáveis globais.
-            fprintf(arquivo_saida, "  move $s1, $sp\n");
-            // Visita o bloco de comandos principal do programa.
-            visita_no_gc(no->filho2);
-            // Salta para o final do programa para encerrar a execução.
-            fprintf(arquivo_saida, "  j end_main\n");
+    if (opcoes.depuracao) {
+        int cabecalho = 0;
+        for (int i = 0; i < funcao->num_variaveis; i++) {
+            Vinculo* v = funcao->variaveis[i];
+            if (!v->registrador) continue;
+            if (!cabecalho++) printf("Variáveis em registradores:");
+            printf(" %s->%s", texto_atomo(v->nome), nome_registrador(v->registrador));
+        }
+        if (cabecalho) printf("\n");
+    }
+}
+
+
+// --- Operandos ---
+// Um operando pode estar num registrador (temporário alocado ou variável promovida), na
+// memória (temporário descarregado ou variável) ou ser uma constante.
+
+// Carrega o valor do operando no registrador 'r'.
+static void carrega_em(Operando o, Registrador r) {
+    switch (o.tipo) {
+        case OPERANDO_CONST:
+            emite_li(&codigo, r, o.valor);
             break;
-            
-        // Casos que chamam as funções 'gc_' específicas.
-        case NO_DECL_VAR:       gc_declaracao_var(no); break;
-        case NO_DECL_FUNCAO:    gc_declaracao_funcao(no); break;
-        case NO_BLOCO:          gc_bloco(no); break;
-        case NO_ATRIBUICAO:     gc_atribuicao(no); break;
-        case NO_IF:             gc_if(no); break;
-        case NO_WHILE:          gc_while(no); break;
-        case NO_CHAMADA_FUNCAO: gc_chamada_funcao(no); break;
-        case NO_RETORNO:        gc_retorno(no); break;
-        
-        // Operadores são todos tratados pela mesma função.
-        case NO_OP_ARITMETICO:
-        case NO_OP_LOGICO:
-        case NO_OP_RELACIONAL:
-            gc_op_binaria(no); break;
-            
-        case NO_NEGACAO: // Operador 'nao'
-            visita_no_gc(no->filho1); // Avalia a expressão.
-            // Compara o resultado com zero. Se for igual a zero, $s0 = 1, senão $s0 = 0.
-            // Isso inverte o valor booleano.
-            fprintf(arquivo_saida, "  seq $s0, $s0, $zero\n"); break;
-            
-        case NO_IDENTIFICADOR: // Uso de uma variável em uma expressão.
-            { // Bloco para permitir a declaração de variável local 's'.
-                // Pega o endereço da variável e coloca em $t0.
-                get_endereco_var(no->lexema);
-                // Carrega o valor que está no endereço ($t0) para o registrador $s0.
-                fprintf(arquivo_saida, "  lw $s0, 0($t0)\n");
-                // Atualiza o tipo do nó na árvore com o tipo da variável (para checagens futuras).
-                Simbolo* s = buscar_em_todos_escopos(&pilha_escopos_gc, no->lexema);
-                if (s) no->tipo_dado = s->tipo_dado;
+        case OPERANDO_TEMP:
+            if (alocacao.registrador[o.valor] != REG_ZERO) {
+                if (alocacao.registrador[o.valor] != r) emite_move(&codigo, r, alocacao.registrador[o.valor]);
+            } else {
+                emite_mem(&codigo, OP_LW, r, deslocamento_slot(alocacao.slot[o.valor]), base_quadro);
             }
             break;
-            
-        case NO_CONST_INT: // Uma constante inteira.
-            // Carrega o valor literal inteiro no registrador $s0.
-            fprintf(arquivo_saida, "  li $s0, %s\n", no->lexema);
-            no->tipo_dado = TIPO_INT; // Define o tipo do nó.
+        case OPERANDO_VAR:
+            if (o.var->registrador) {
+                if ((Registrador)o.var->registrador != r) emite_move(&codigo, r, o.var->registrador);
+            } else {
+                emite_mem(&codigo, ocupa_um_byte(o.var) ? OP_LBU : OP_LW, r, o.var->deslocamento,
+                          base_da_variavel(o.var));
+            }
+            break;
+        case OPERANDO_NENHUM:
+            break;
+    }
+}
+
+// Devolve um registrador com o valor do operando: o próprio registrador onde ele já está ou,
+// se for preciso carregá-lo, 'auxiliar'. O registrador devolvido só pode ser lido.
+static Registrador le_operando(Operando o, Registrador auxiliar) {
+    if (o.tipo == OPERANDO_CONST && o.valor == 0) return REG_ZERO;
+    if (o.tipo == OPERANDO_TEMP && alocacao.registrador[o.valor] != REG_ZERO) return alocacao.registrador[o.valor];
+    if (o.tipo == OPERANDO_VAR && o.var->registrador) return o.var->registrador;
+    carrega_em(o, auxiliar);
+    return auxiliar;
+}
+
+// Registrador onde deve ser calculado um valor que vai para 'destino' (o próprio registrador do
+// destino ou, se ele estiver na memória, um auxiliar que armazena_em grava depois).
+static Registrador registrador_destino(Operando destino) {
+    if (destino.tipo == OPERANDO_TEMP && alocacao.registrador[destino.valor] != REG_ZERO) {
+        return alocacao.registrador[destino.valor];
+    }
+    if (destino.tipo == OPERANDO_VAR && destino.var->registrador) return destino.var->registrador;
+    return AUXILIAR_1;
+}
+
+// Grava o valor de 'r' no destino (no seu registrador ou na memória).
+static void armazena_em(Operando destino, Registrador r) {
+    Registrador rd = registrador_destino(destino);
+    if (rd != AUXILIAR_1) {
+        if (rd != r) emite_move(&codigo, rd, r);
+    } else if (destino.tipo == OPERANDO_TEMP) {
+        emite_mem(&codigo, OP_SW, r, deslocamento_slot(alocacao.slot[destino.valor]), base_quadro);
+    } else {
+        emite_mem(&codigo, ocupa_um_byte(destino.var) ? OP_SB : OP_SW, r, destino.var->deslocamento,
+                  base_da_variavel(destino.var));
+    }
+}
+
+
+// --- Instruções ---
+
+// Os $t podem ser usados livremente pela função chamada; os $s ela preserva.
+static int destruido_na_chamada(Registrador r) {
+    return r >= REG_T0 && r <= REG_T7;
+}
+
+// Uma chamada destrói os registradores $t: os temporários que continuam vivos depois dela são
+// guardados no quadro antes do 'jal' e recarregados em seguida.
+static void gc_chamada(const InstrucaoIR* ins) {
+    Registrador salvos[NUM_REGISTRADORES_ALOCAVEIS];
+    int n_salvos = 0;
+    for (int t = 0; t < alocacao.num_temporarios; t++) {
+        Registrador r = alocacao.registrador[t];
+        if (destruido_na_chamada(r) && vivo_atraves(&alocacao, t, ins->numero)) salvos[n_salvos++] = r;
+    }
+    for (int i = 0; i < n_salvos; i++) {
+        emite_mem(&codigo, OP_SW, salvos[i], deslocamento_slot(slot_salvamento[salvos[i]]), base_quadro);
+    }
+
+    // Os argumentos já estão em $a0-$a3 (e os demais na pilha, que a função chamada desempilha no epílogo).
+    emite_desvio(&codigo, OP_JAL, rotulo_nome(texto_atomo(ins->funcao->nome)));
+
+    for (int i = 0; i < n_salvos; i++) {
+        emite_mem(&codigo, OP_LW, salvos[i], deslocamento_slot(slot_salvamento[salvos[i]]), base_quadro);
+    }
+    // O valor de retorno chega em $v0.
+    if (ins->destino.tipo != OPERANDO_NENHUM) armazena_em(ins->destino, REG_V0);
+}
+
+// Chamada a uma rotina da biblioteca. Ela preserva os $t0-$t7: não há o que guardar.
+static void chama_rotina(RotinaBiblioteca rotina) {
+    rotinas_usadas[rotina] = 1;
+    emite_desvio(&codigo, OP_JAL, rotulo_rotina(rotina));
+}
+
+// Indica se o espaço dos argumentos empilhados da próxima chamada já foi aberto.
+static int argumentos_abertos;
+
+// Indica se os argumentos empilhados em curso são de uma chamada de cauda e vão direto para o
+// lugar dos que a função recebeu (ver argumentos_no_lugar).
+static int argumentos_da_cauda;
+
+// Lugar do parâmetro recebido na pilha nessa posição: em relação ao $sp numa função sem quadro
+// ou, somados 8 (o $fp e o $ra salvos), em relação ao $fp.
+static int deslocamento_recebido(int posicao) {
+    return 4 * (posicao - PARAMETROS_EM_REGISTRADORES);
+}
+
+// Indica se 'o' é o parâmetro da função atual recebido na pilha na mesma posição e lido de lá:
+// passá-lo adiante na chamada de cauda não muda nada.
+static int eh_o_parametro_recebido(Operando o, int posicao) {
+    return o.tipo == OPERANDO_VAR && o.var->classe == ARMAZ_PARAMETRO && !o.var->registrador &&
+           o.var->deslocamento == 8 + deslocamento_recebido(posicao);
+}
+
+static void gc_instrucao(const InstrucaoIR* ins) {
+    switch (ins->op) {
+        case IR_COPIA: {
+            Registrador rd = registrador_destino(ins->destino);
+            if (rd != AUXILIAR_1) {
+                carrega_em(ins->a, rd);
+            } else {
+                armazena_em(ins->destino, le_operando(ins->a, AUXILIAR_1));
+            }
             break;
-            
-        case NO_CONST_CAR: // Uma constante caractere ou string.
-            // Verifica se é uma string (contém aspas).
-            if (strchr(no->lexema, '"')) {
-                // Se for string, o código é gerado na chamada de "escreva", não aqui.
+        }
+        case IR_BINARIO: {
+            // Ex: t2 = t0 + x  ->  add $t2, $t0, $s2.
+            Registrador ra = le_operando(ins->a, AUXILIAR_1);
+            Registrador rd = registrador_destino(ins->destino);
+            Opcode op = get_op_mips(ins->operador);
+            if (op == OP_SLL || op == OP_SRA || op == OP_SRL) {
+                // Deslocamentos têm sempre um número constante de bits: t1 = t0 << 2  ->  sll $t1, $t0, 2.
+                emite_i(&codigo, op, rd, ra, ins->b.valor);
             } else {
-                // Se for um caractere (ex: 'a'), carrega seu valor ASCII em $s0.
-                fprintf(arquivo_saida, "  li $s0, %s\n", no->lexema);
-                no->tipo_dado = TIPO_CAR; // Define o tipo do nó.
+                emite_r(&codigo, op, rd, ra, le_operando(ins->b, AUXILIAR_2));
             }
+            armazena_em(ins->destino, rd);
             break;
-            
-        default: // Caso padrão para nós não listados (ex: listas).
-            // Apenas continua a visitação recursiva pelos filhos.
-            visita_no_gc(no->filho1); visita_no_gc(no->filho2);
-            visita_no_gc(no->filho3); visita_no_gc(no->filho4); break;
-    }
-    // Continua a visitação para o próximo nó na mesma lista (nós irmãos).
-    visita_no_gc(no->proximo);
-}
-
-// Percorre a árvore (antes da geração de código) para encontrar todos os literais de string.
-void coletar_strings(No* no) {
-    if (!no) return; // Condição de parada da recursão.
-    
-    // Procura por chamadas da função 'escreva' com argumento string.
-    if (no->tipo_no == NO_CHAMADA_FUNCAO && strcmp(no->lexema, "escreva") == 0) {
-        if (no->filho1 && no->filho1->tipo_no == NO_CONST_CAR && strchr(no->filho1->lexema, '"')) {
-            
-            // Verifica se a string já foi adicionada à lista para evitar duplicatas.
-            StringLiteral* current = lista_strings; int encontrada = 0;
-            while(current) {
-                if (strcmp(current->content, no->filho1->lexema) == 0) { encontrada = 1; break; }
-                current = current->next;
+        }
+        case IR_ARGUMENTO: {
+            // Os primeiros argumentos vão em $a0-$a3; os demais, na pilha. Eles vêm do último ao
+            // primeiro: o último empilhado abre de uma vez o espaço de todos, e cada um é guardado
+            // na sua posição (o quinto em 0($sp)).
+            if (ins->posicao < PARAMETROS_EM_REGISTRADORES) {
+                carrega_em(ins->a, REG_A0 + ins->posicao);
+                break;
             }
-            
-            // Se não encontrou, adiciona a nova string à lista.
-            if (!encontrada) {
-                StringLiteral* nova_str = (StringLiteral*) malloc(sizeof(StringLiteral));
-                sprintf(nova_str->label, "str_%d", contador_string++); // Cria um rótulo "str_N".
-                nova_str->content = no->filho1->lexema; // Aponta para o conteúdo.
-                nova_str->next = lista_strings; // Insere no início da lista.
-                lista_strings = nova_str;
+            if (argumentos_da_cauda) {
+                if (eh_o_parametro_recebido(ins->a, ins->posicao)) break;
+                Registrador r = le_operando(ins->a, AUXILIAR_1);
+                if (funcao_sem_quadro) emite_mem(&codigo, OP_SW, r, deslocamento_recebido(ins->posicao), REG_SP);
+                else emite_mem(&codigo, OP_SW, r, 8 + deslocamento_recebido(ins->posicao), REG_FP);
+                break;
             }
+            if (!argumentos_abertos) {
+                emite_i(&codigo, OP_ADDIU, REG_SP, REG_SP,
+                        -4 * (ins->posicao - PARAMETROS_EM_REGISTRADORES + 1)); // Abre espaço na pilha.
+                argumentos_abertos = 1;
+            }
+            Registrador r = le_operando(ins->a, AUXILIAR_1);
+            emite_mem(&codigo, OP_SW, r, 4 * (ins->posicao - PARAMETROS_EM_REGISTRADORES), REG_SP);
+            break;
         }
+        case IR_CHAMADA:
+            argumentos_abertos = 0;
+            gc_chamada(ins);
+            break;
+        case IR_LEIA:
+            if (opcoes.saida_com_buffer) {
+                chama_rotina(ROTINA_LEIA_INTEIRO);        // O inteiro lido fica em $v0.
+                armazena_em(ins->destino, REG_V0);
+                break;
+            }
+            emite_li(&codigo, REG_V0, 5);                 // Código de serviço 5 (read_integer).
+            emite_syscall(&codigo);                       // O inteiro lido fica em $v0.
+            armazena_em(ins->destino, REG_V0);
+            break;
+        case IR_ESCREVA:
+            carrega_em(ins->a, REG_A0);                   // O valor a escrever vai em $a0.
+            if (opcoes.saida_com_buffer) {
+                chama_rotina(ins->tipo == TIPO_CAR ? ROTINA_ESCREVA_CARACTERE : ROTINA_ESCREVA_INTEIRO);
+                break;
+            }
+            // O tipo do valor decide o serviço: 11 (print_character) ou 1 (print_integer).
+            emite_li(&codigo, REG_V0, ins->tipo == TIPO_CAR ? 11 : 1);
+            emite_syscall(&codigo);
+            break;
+        case IR_ESCREVA_CADEIA:
+            emite_la(&codigo, REG_A0, rotulo_numerado("str_", ins->cadeia)); // Carrega o endereço da string em $a0.
+            if (opcoes.saida_com_buffer) {
+                // O comprimento do texto entre as aspas (as sequências de escape contam a mais).
+                emite_li(&codigo, REG_A1, (int)strlen(texto_atomo(programa_atual->cadeias[ins->cadeia])) - 2);
+                chama_rotina(ROTINA_ESCREVA_CADEIA);
+                break;
+            }
+            emite_li(&codigo, REG_V0, 4);                 // Código de serviço 4 (print_string).
+            emite_syscall(&codigo);
+            break;
+        case IR_NOVALINHA:
+            emite_li(&codigo, REG_A0, '\n');              // Carrega o caractere de nova linha em $a0.
+            if (opcoes.saida_com_buffer) {
+                chama_rotina(ROTINA_ESCREVA_CARACTERE);
+                break;
+            }
+            emite_li(&codigo, REG_V0, 11);                // Código de serviço 11 (print_character).
+            emite_syscall(&codigo);
+            break;
+        case IR_FI:                                       // A otimização SSA os desfaz antes.
+            break;
+    }
+}
+
+// Salta para 'destino' se "x op y" valer, com uma única instrução de desvio sobre os dois
+// operandos. Uma constante vai como imediato; comparar com zero usa beqz/bnez ou $zero.
+static void emite_desvio_se(OperadorIR op, Operando x, Operando y, Rotulo destino) {
+    if (x.tipo == OPERANDO_CONST) {
+        Operando troca = x;
+        x = y;
+        y = troca;
+        op = ir_espelha_comparacao(op);
+    }
+    Registrador rs = le_operando(x, AUXILIAR_1);
+    if (y.tipo == OPERANDO_CONST && y.valor == 0 && (op == OPR_IGUAL || op == OPR_DIFERENTE)) {
+        if (op == OPR_IGUAL) emite_beqz(&codigo, rs, destino);
+        else emite_bnez(&codigo, rs, destino);
+    } else if (y.tipo == OPERANDO_CONST && y.valor != 0) {
+        emite_desvio_comparacao_i(&codigo, get_desvio_mips(op), rs, y.valor, destino);
+    } else {
+        emite_desvio_comparacao(&codigo, get_desvio_mips(op), rs, le_operando(y, AUXILIAR_2), destino);
+    }
+}
+
+// Gera o terminador do bloco. 'seguinte' é o bloco emitido logo depois (NULL no último): um
+// salto para ele é desnecessário, e num desvio ele é o caminho em que o desvio não é tomado.
+static void gc_terminador(const BlocoBasico* b, const BlocoBasico* seguinte) {
+    switch (b->terminador) {
+        case TERM_SALTO:
+            if (b->sucessores[0] != seguinte) emite_desvio(&codigo, OP_J, rotulo_bloco(b->sucessores[0]));
+            break;
+        case TERM_DESVIO:
+            if (b->sucessores[1] == seguinte) {
+                emite_desvio_se(b->comparacao, b->valor, b->valor2, rotulo_bloco(b->sucessores[0]));
+            } else {
+                // Se a comparação for falsa, salta (com o desvio oposto); senão continua (ou salta)
+                // para o bloco verdadeiro.
+                emite_desvio_se(ir_nega_comparacao(b->comparacao), b->valor, b->valor2,
+                                rotulo_bloco(b->sucessores[1]));
+                if (b->sucessores[0] != seguinte) emite_desvio(&codigo, OP_J, rotulo_bloco(b->sucessores[0]));
+            }
+            break;
+        case TERM_RETORNO:
+            // Por convenção, o valor de retorno vai em $v0. O epílogo vem logo depois do último bloco.
+            if (b->valor.tipo != OPERANDO_NENHUM) carrega_em(b->valor, REG_V0);
+            if (seguinte) {
+                emite_desvio(&codigo, OP_J, funcao_atual->vinculo
+                             ? rotulo_com_sufixo(funcao_atual->nome, "_epilogo")
+                             : rotulo_nome("end_main"));
+            }
+            break;
+        case TERM_ABERTO:
+            fprintf(stderr, "Erro de Geração: Bloco B%d sem terminador.\n", b->id);
+            exit(1);
+    }
+}
+
+
+// --- Chamadas de Cauda ---
+// Em "retorne g(...)" a função não faz mais nada depois da chamada. Em vez de 'jal' (e de voltar
+// só para sair), ela desfaz o próprio quadro e salta para g, que retorna direto ao chamador
+// dela; a pilha não cresce a cada nível de recursão. Uma chamada da função a ela mesma nem
+// desfaz o quadro: salta para logo depois do prólogo, onde os parâmetros são recebidos.
+// Os argumentos empilhados (do quinto em diante) vão para o lugar dos que a função recebeu,
+// por isso só são de cauda as chamadas a funções com o mesmo número deles.
+static int num_chamadas_de_cauda;
+static int num_recursoes_de_cauda;
+
+// Desfaz o quadro da função atual: restaura os $s usados, o $sp, o $fp e (se foi salvo) o $ra.
+// O $sp sobe também os 'argumentos_empilhados_recebidos' (na saída da função; numa chamada de
+// cauda eles continuam na pilha, para a função chamada).
+static void desfaz_quadro(int argumentos_empilhados_recebidos) {
+    if (funcao_sem_quadro) return;
+    int espaco_locais = funcao_atual->vinculo->tamanho_quadro;
+    for (int i = 0; i < num_registradores_s; i++) {
+        emite_mem(&codigo, OP_LW, registradores_promocao[i], -espaco_locais - 4 * (i + 1), REG_FP);
+    }
+    emite_move(&codigo, REG_SP, REG_FP);            // Restaura o $sp para a posição do $fp.
+    emite_mem(&codigo, OP_LW, REG_FP, 0, REG_SP);   // Restaura o $fp antigo.
+    if (!funcao_folha) emite_mem(&codigo, OP_LW, REG_RA, 4, REG_SP); // Restaura o endereço de retorno $ra.
+    emite_i(&codigo, OP_ADDIU, REG_SP, REG_SP, 8 + 4 * argumentos_empilhados_recebidos);
+}
+
+// Indica se os argumentos empilhados da chamada de cauda podem ser guardados direto no lugar dos
+// recebidos, sem passar pela pilha: todos vêm logo antes da chamada e nenhum argumento lê um
+// parâmetro recebido na pilha, que outro pode já ter sobrescrito (a não ser o da mesma posição,
+// que nem é copiado).
+static int argumentos_no_lugar(const InstrucaoIR* chamada) {
+    int empilhados = 0;
+    for (InstrucaoIR* ins = chamada->anterior; ins && ins->op == IR_ARGUMENTO; ins = ins->anterior) {
+        if (ins->posicao >= PARAMETROS_EM_REGISTRADORES) empilhados++;
+        if (ins->a.tipo == OPERANDO_VAR && ins->a.var->classe == ARMAZ_PARAMETRO && !ins->a.var->registrador &&
+            ins->a.var->deslocamento > 0 && !eh_o_parametro_recebido(ins->a, ins->posicao)) return 0;
+    }
+    return empilhados == argumentos_empilhados(chamada->funcao);
+}
+
+static void gc_chamada_de_cauda(const InstrucaoIR* ins) {
+    // Os argumentos já estão em $a0-$a3 e os demais no lugar dos recebidos ou, se não puderam ir
+    // direto para lá, empilhados a partir de 0($sp). Os recebidos ficam logo acima do $fp e do $ra
+    // salvos (ou, sem quadro, logo acima dos que foram empilhados).
+    int empilhados = argumentos_abertos ? argumentos_empilhados(ins->funcao) : 0;
+    argumentos_abertos = argumentos_da_cauda = 0;
+    for (int i = 0; i < empilhados; i++) {
+        emite_mem(&codigo, OP_LW, AUXILIAR_1, 4 * i, REG_SP);
+        if (funcao_sem_quadro) emite_mem(&codigo, OP_SW, AUXILIAR_1, 4 * (empilhados + i), REG_SP);
+        else emite_mem(&codigo, OP_SW, AUXILIAR_1, 8 + 4 * i, REG_FP);
+    }
+    num_chamadas_de_cauda++;
+    if (ins->funcao == funcao_atual->vinculo) {
+        if (empilhados > 0) emite_i(&codigo, OP_ADDIU, REG_SP, REG_SP, 4 * empilhados);
+        emite_desvio(&codigo, OP_J, rotulo_com_sufixo(funcao_atual->nome, "_corpo"));
+        num_recursoes_de_cauda++;
+        return;
+    }
+    if (funcao_sem_quadro) {
+        if (empilhados > 0) emite_i(&codigo, OP_ADDIU, REG_SP, REG_SP, 4 * empilhados);
+    } else {
+        desfaz_quadro(0);
+    }
+    emite_desvio(&codigo, OP_J, rotulo_nome(texto_atomo(ins->funcao->nome)));
+}
+
+// Indica se a função chama a si mesma numa chamada de cauda (e precisa do rótulo '_corpo').
+static int tem_recursao_de_cauda(const FuncaoIR* funcao) {
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        if (b->ultima && b->ultima->funcao == funcao->vinculo && eh_chamada_de_cauda(b, b->ultima)) return 1;
+    }
+    return 0;
+}
+
+// Gera o corpo da função, bloco a bloco. Um bloco só precisa de rótulo se algum desvio chega
+// a ele de outro lugar que não o bloco imediatamente anterior. Um bloco que termina numa
+// chamada de cauda não tem terminador: a chamada já sai da função.
+static void gc_blocos(FuncaoIR* funcao) {
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        for (int p = 0; p < b->num_predecessores; p++) {
+            if (i == 0 || b->predecessores[p] != funcao->blocos[i - 1]) {
+                emite_rotulo(&codigo, rotulo_bloco(b));
+                break;
+            }
+        }
+        int cauda = 0;
+        const InstrucaoIR* ultima = b->ultima;
+        for (InstrucaoIR* ins = b->primeira; ins; ins = ins->proxima) {
+            if (ins->op == IR_ARGUMENTO && !argumentos_da_cauda && eh_chamada_de_cauda(b, ultima) &&
+                argumentos_no_lugar(ultima)) {
+                // Os argumentos que faltam são os da chamada de cauda.
+                argumentos_da_cauda = 1;
+                for (InstrucaoIR* a = ins; a != ultima; a = a->proxima) {
+                    if (a->op != IR_ARGUMENTO) argumentos_da_cauda = 0;
+                }
+            }
+            if (eh_chamada_de_cauda(b, ins)) {
+                gc_chamada_de_cauda(ins);
+                cauda = 1;
+            } else {
+                gc_instrucao(ins);
+            }
+        }
+        if (!cauda) gc_terminador(b, i + 1 < funcao->num_blocos ? funcao->blocos[i + 1] : NULL);
+    }
+}
+
+// Aloca os registradores da função e reserva as posições de salvamento: cada $t que atravessa
+// alguma chamada ganha uma posição no quadro, depois das posições dos temporários descarregados.
+// Os $s que sobraram da promoção também entram na alocação. 'salva_promovidas' indica se os
+// registradores $s usados são guardados no quadro.
+static void prepara_quadro(FuncaoIR* funcao, Registrador base, int bytes_variaveis, int salva_promovidas) {
+    funcao_atual = funcao;
+    funcao_folha = funcao->vinculo && !faz_chamadas(funcao);
+    mantem_parametros_nos_registradores(funcao);
+    escolhe_promovidas(funcao);
+    aloca_registradores(funcao, &alocacao, registradores_promocao + num_promovidas,
+                        NUM_PROMOVIVEIS - num_promovidas);
+    num_registradores_s = num_promovidas;
+    for (int t = 0; t < alocacao.num_temporarios; t++) {
+        for (int k = num_registradores_s; k < NUM_PROMOVIVEIS; k++) {
+            if (alocacao.registrador[t] == registradores_promocao[k]) num_registradores_s = k + 1;
+        }
+    }
+    base_quadro = base;
+    inicio_slots = bytes_variaveis + (salva_promovidas ? 4 * num_registradores_s : 0);
+
+    num_slots_salvamento = 0;
+    for (int r = 0; r < NUM_REGISTRADORES; r++) slot_salvamento[r] = -1;
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        for (InstrucaoIR* ins = funcao->blocos[i]->primeira; ins; ins = ins->proxima) {
+            if (ins->op != IR_CHAMADA) continue;
+            for (int t = 0; t < alocacao.num_temporarios; t++) {
+                Registrador r = alocacao.registrador[t];
+                if (destruido_na_chamada(r) && slot_salvamento[r] < 0 && vivo_atraves(&alocacao, t, ins->numero)) {
+                    slot_salvamento[r] = alocacao.num_slots + num_slots_salvamento++;
+                }
+            }
+        }
+    }
+    if (opcoes.depuracao && alocacao.num_slots > 0) {
+        printf("Temporários guardados na memória em '%s': %d\n", funcao->nome, alocacao.num_slots);
     }
-    // Continua a busca recursivamente por toda a árvore.
-    coletar_strings(no->filho1); coletar_strings(no->filho2);
-    coletar_strings(no->filho3); coletar_strings(no->filho4);
-    coletar_strings(no->proximo);
+}
+
+// Tamanho total do quadro: variáveis, registradores $s salvos e posições dos temporários.
+static int tamanho_quadro(void) {
+    return inicio_slots + 4 * (alocacao.num_slots + num_slots_salvamento);
+}
+
+
+// --- Funções e Bloco Principal ---
+
+// Funções folha (que não chamam outras funções do programa; leia, escreva e novalinha são
+// geradas em linha) não mudam $ra e por isso não o salvam. Se além disso nada da função fica
+// no quadro (variáveis e parâmetros usados estão em registradores, nenhum temporário foi
+// descarregado e nenhum $s precisa ser preservado), ela não monta quadro nenhum: o corpo vem
+// direto, e o epílogo é só o 'jr $ra'.
+static int num_funcoes;
+static int num_funcoes_folha;
+static int num_funcoes_sem_quadro;
+
+// Indica se o operando é uma variável local ou parâmetro que vive no quadro.
+static int no_quadro(Operando o) {
+    return o.tipo == OPERANDO_VAR && o.var->classe != ARMAZ_GLOBAL && !o.var->registrador;
+}
+
+static int usa_o_quadro(const FuncaoIR* funcao) {
+    if (num_registradores_s > 0 || alocacao.num_slots > 0) return 1;
+    for (No* p = funcao->vinculo->params; p != NULL; p = p->proximo) {
+        // O prólogo guarda no quadro o parâmetro recebido num registrador, ou lê da pilha o empilhado.
+        int empilhado = registrador_do_parametro(p->vinculo) == REG_ZERO;
+        if (empilhado == (p->vinculo->registrador != 0)) return 1;
+    }
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        for (InstrucaoIR* ins = b->primeira; ins; ins = ins->proxima) {
+            if (no_quadro(ins->destino) || no_quadro(ins->a) || no_quadro(ins->b)) return 1;
+        }
+        if (no_quadro(b->valor) || no_quadro(b->valor2)) return 1;
+    }
+    return 0;
+}
+
+// Os parâmetros recebidos em $a0-$a3 vão para o registrador da variável ou para o quadro (se
+// não continuarem onde chegaram); os empilhados promovidos são copiados da pilha para o seu
+// registrador. (Os registradores das variáveis nunca são os $a que trazem parâmetros.)
+static void recebe_parametros(const Vinculo* v_funcao) {
+    for (No* p = v_funcao->params; p != NULL; p = p->proximo) {
+        Vinculo* v = p->vinculo;
+        Registrador chegada = registrador_do_parametro(v);
+        if (chegada != REG_ZERO) {
+            if (!v->registrador) emite_mem(&codigo, OP_SW, chegada, v->deslocamento, REG_FP);
+            else if ((Registrador)v->registrador != chegada) emite_move(&codigo, v->registrador, chegada);
+        } else if (v->registrador) {
+            emite_mem(&codigo, OP_LW, v->registrador, v->deslocamento, REG_FP);
+        }
+    }
+}
+
+// Gera código para uma função do programa.
+static void gc_funcao(FuncaoIR* funcao) {
+    // O vínculo da função (anotado pela análise) traz o número de parâmetros e o tamanho do quadro.
+    Vinculo* v_funcao = funcao->vinculo;
+    const char* texto_funcao = funcao->nome; // Texto usado nos rótulos.
+    int espaco_locais = v_funcao->tamanho_quadro;
+    prepara_quadro(funcao, REG_FP, espaco_locais, 1);
+    int folha = funcao_folha;
+    int sem_quadro = funcao_sem_quadro = folha && !usa_o_quadro(funcao);
+    num_funcoes++;
+    num_funcoes_folha += folha;
+    num_funcoes_sem_quadro += sem_quadro;
+    if (opcoes.depuracao && folha) {
+        printf("Função folha '%s'%s.\n", texto_funcao, sem_quadro ? " (sem quadro)" : "");
+    }
+
+    // Inicia a seção de código para a função no arquivo .asm.
+    emite_comentario(&codigo, "---- Funcao: ", 1)->rotulo = rotulo_com_sufixo(texto_funcao, " ----");
+    emite_rotulo(&codigo, rotulo_nome(texto_funcao)); // Cria o rótulo (label) da função.
+
+    if (sem_quadro) {
+        if (tem_recursao_de_cauda(funcao)) emite_rotulo(&codigo, rotulo_com_sufixo(texto_funcao, "_corpo"));
+        recebe_parametros(v_funcao);
+        gc_blocos(funcao);
+        emite_rotulo(&codigo, rotulo_com_sufixo(texto_funcao, "_epilogo"));
+        if (v_funcao->num_params > PARAMETROS_EM_REGISTRADORES) { // Libera o espaço dos argumentos empilhados.
+            emite_i(&codigo, OP_ADDIU, REG_SP, REG_SP, 4 * (v_funcao->num_params - PARAMETROS_EM_REGISTRADORES));
+        }
+        emite_jr(&codigo, REG_RA);
+        libera_alocacao(&alocacao);
+        funcao_atual = NULL;
+        return;
+    }
+
+    // Gera o Prólogo da função: prepara a pilha para a execução da função. O quadro inteiro é
+    // conhecido aqui, então o $sp é ajustado uma vez só. De cima para baixo: o $ra e o $fp salvos
+    // (numa função folha o espaço do $ra continua reservado, para que os argumentos empilhados
+    // fiquem no mesmo lugar), as variáveis locais (a análise já arrumou as de todos os blocos, com
+    // os blocos disjuntos dividindo posições, e os parâmetros já têm seus deslocamentos), os
+    // registradores $s usados pela função, que precisam ser preservados, e as posições dos temporários.
+    emite_comentario(&codigo, "Prólogo", 0);
+    int abaixo_do_fp = tamanho_quadro();
+    emite_i(&codigo, OP_ADDIU, REG_SP, REG_SP, -(8 + abaixo_do_fp))->comentario = "Aloca o quadro";
+    if (!folha) emite_mem(&codigo, OP_SW, REG_RA, abaixo_do_fp + 4, REG_SP); // Salva o endereço de retorno ($ra).
+    emite_mem(&codigo, OP_SW, REG_FP, abaixo_do_fp, REG_SP); // Salva o frame pointer antigo ($fp).
+    emite_i(&codigo, OP_ADDIU, REG_FP, REG_SP, abaixo_do_fp); // O novo $fp aponta para o $fp salvo.
+    for (int i = 0; i < num_registradores_s; i++) {
+        emite_mem(&codigo, OP_SW, registradores_promocao[i], -espaco_locais - 4 * (i + 1), REG_FP);
+    }
+    if (tem_recursao_de_cauda(funcao)) emite_rotulo(&codigo, rotulo_com_sufixo(texto_funcao, "_corpo"));
+    recebe_parametros(v_funcao);
+
+    // Gera o código para o corpo da função.
+    gc_blocos(funcao);
+
+    // Gera o Epílogo da função: restaura a pilha e retorna ao chamador.
+    emite_rotulo(&codigo, rotulo_com_sufixo(texto_funcao, "_epilogo")); // Rótulo para o epílogo (usado pelo 'retorna').
+    emite_comentario(&codigo, "Epílogo", 0);
+    desfaz_quadro(argumentos_empilhados(v_funcao));
+    emite_jr(&codigo, REG_RA);                      // Retorna para o endereço em $ra (jump register).
+
+    libera_alocacao(&alocacao);
+    funcao_atual = NULL;
+}
+
+// Gera o bloco principal. As suas variáveis estão na área global, com as globais; na pilha,
+// a partir de $fp, ficam só as posições dos temporários (se houver alguma).
+static void gc_principal(FuncaoIR* funcao, int tamanho_area_global) {
+    // As variáveis do bloco principal também podem ficar em registradores. Como o programa
+    // termina em seguida, não é preciso salvar os registradores $s usados (e eles não ocupam o quadro).
+    prepara_quadro(funcao, REG_FP, 0, 0);
+
+    // Inicia o ponto de entrada principal do programa.
+    emite_comentario(&codigo, "---- Bloco Principal (programa) ----", 1);
+    emite_rotulo(&codigo, rotulo_nome("main"));
+    if (tamanho_area_global > 0) {
+        emite_la(&codigo, REG_GP, rotulo_nome("area_global"))->comentario = "Base das variáveis globais";
+    }
+    if (tamanho_quadro() > 0) {
+        emite_move(&codigo, REG_FP, REG_SP);
+        emite_i(&codigo, OP_ADDIU, REG_SP, REG_SP, -tamanho_quadro())->comentario = "Aloca espaço para temporário(s)";
+    }
+    // Ao sair pelo último bloco, a execução segue direto para 'end_main'.
+    gc_blocos(funcao);
+
+    libera_alocacao(&alocacao);
+    funcao_atual = NULL;
+}
+
+// --- Área Global ---
+// As variáveis globais e as do bloco principal têm endereço fixo: ficam na seção .data, a
+// partir do rótulo 'area_global', para onde o bloco principal aponta $gp. Cada acesso é então
+// um único 'lw'/'sw' (ou 'lbu'/'sb') com o deslocamento da variável. As 'int' (palavras,
+// alinhadas em 4 bytes) vêm antes das 'car' (um byte cada), e nenhuma precisa de enchimento.
+
+// Dá endereço às variáveis da lista que ocupam 'um_byte' e emite o espaço de cada uma.
+static void arruma_variaveis(Vinculo** variaveis, int n, int um_byte, int* deslocamento) {
+    for (int i = 0; i < n; i++) {
+        if (ocupa_um_byte(variaveis[i]) != um_byte) continue;
+        variaveis[i]->deslocamento = *deslocamento;
+        *deslocamento += um_byte ? 1 : 4;
+        emite_diretiva(&codigo, um_byte ? "  .byte 0" : "  .word 0")->comentario = texto_atomo(variaveis[i]->nome);
+    }
+}
+
+// Emite a área global e devolve o seu tamanho em bytes.
+static int gc_area_global(const ProgramaIR* programa) {
+    FuncaoIR* principal = programa->principal;
+    if (programa->num_globais + principal->num_variaveis == 0) return 0;
+    int tamanho = 0;
+    emite_rotulo(&codigo, rotulo_nome("area_global"));
+    for (int um_byte = 0; um_byte <= 1; um_byte++) {
+        arruma_variaveis(programa->globais, programa->num_globais, um_byte, &tamanho);
+        arruma_variaveis(principal->variaveis, principal->num_variaveis, um_byte, &tamanho);
+    }
+    if (tamanho > 32767) { // O deslocamento de 'lw'/'sw' tem 16 bits com sinal.
+        fprintf(stderr, "Erro de Geração: as variáveis globais ocupam %d bytes (máximo: 32767).\n", tamanho);
+        exit(1);
+    }
+    return tamanho;
 }
 
 // Função principal que orquestra a geração de código MIPS.
-void gerar_codigo(No* raiz_arvore, const char* nome_arquivo_saida) {
-    // Abre o arquivo de saída para escrita.
-    arquivo_saida = fopen(nome_arquivo_saida, "w");
+void gerar_codigo(ProgramaIR* programa, const char* nome_arquivo_saida, const OpcoesGeracao* opcoes_geracao) {
+    if (opcoes_geracao) opcoes = *opcoes_geracao;
+    programa_atual = programa;
+    for (int i = 0; i < NUM_ROTINAS; i++) rotinas_usadas[i] = 0;
+    num_funcoes = num_funcoes_folha = num_funcoes_sem_quadro = 0;
+    num_chamadas_de_cauda = num_recursoes_de_cauda = 0;
+
+    // Abre o arquivo de saída para escrita (antes de gerar, para falhar cedo se não for possível).
+    FILE* arquivo_saida = fopen(nome_arquivo_saida, "w");
     if (!arquivo_saida) {
         perror("Erro ao criar arquivo de saída");
         exit(1);
     }
-    
-    // Prepara a pilha de escopos, começando pelo escopo global.
-    inicializar_pilha(&pilha_escopos_gc);
-    empilhar(&pilha_escopos_gc); // Escopo global.
+    codigo_inicializar(&codigo);
+
+    // 1. Geração da Seção .data: a área global e as cadeias escritas pelo programa, já reunidas
+    //    pelo código intermediário (as instruções ficam em memória até o passo 5).
+    emite_diretiva(&codigo, ".data");
+    int tamanho_area_global = gc_area_global(programa);
+    for (int i = 0; i < programa->num_cadeias; i++) {
+        emite_asciiz(&codigo, rotulo_numerado("str_", i), texto_atomo(programa->cadeias[i]));
+    }
 
-    // 1. Primeira Passada: Coleta todas as strings para a seção .data.
-    coletar_strings(raiz_arvore);
+    // 2. Geração da Seção .text (código executável)
+    emite_diretiva(&codigo, ".text");
+    emite_diretiva(&codigo, ".globl main"); // Declara 'main' como um símbolo global.
+    emite_desvio(&codigo, OP_J, rotulo_nome("main")); // Salto inicial para o label 'main'.
 
-    // 2. Geração da Seção .data
-    fprintf(arquivo_saida, ".data\n");
-    StringLiteral* current = lista_strings;
-    while (current) {
-        // Para cada string na lista, escreve sua declaração no arquivo .asm.
-        fprintf(arquivo_saida, "%s: .asciiz %s\n", current->label, current->content);
-        current = current->next;
+    // 3. Percorre as funções do código intermediário (o bloco principal é a última).
+    for (int f = 0; f < programa->num_funcoes; f++) {
+        FuncaoIR* funcao = programa->funcoes[f];
+        if (funcao == programa->principal) gc_principal(funcao, tamanho_area_global);
+        else gc_funcao(funcao);
     }
 
-    // 3. Geração da Seção .text (código executável)
-    fprintf(arquivo_saida, ".text\n");
-    fprintf(arquivo_saida, ".globl main\n\n"); // Declara 'main' como um símbolo global.
-    fprintf(arquivo_saida, "j main\n\n");     // Salto inicial para o label 'main'.
+    // 4. Geração do Código de Finalização do Programa
+    emite_rotulo(&codigo, rotulo_nome("end_main")); // Rótulo para o fim da execução.
+    if (rotinas_usadas[ROTINA_ESCREVA_INTEIRO] || rotinas_usadas[ROTINA_ESCREVA_CARACTERE] ||
+        rotinas_usadas[ROTINA_ESCREVA_CADEIA]) {
+        chama_rotina(ROTINA_DESCARREGA);            // Escreve o que ainda estiver no buffer.
+    }
+    emite_li(&codigo, REG_V0, 10);  // Carrega o código de serviço 10 (exit).
+    emite_syscall(&codigo);         // Encerra o programa.
 
-    // 4. Segunda Passada: Percorre a árvore para gerar o código das instruções.
-    visita_no_gc(raiz_arvore);
+    if (num_funcoes > 0) {
+        printf("Funções folha: %d de %d (%d sem quadro).\n", num_funcoes_folha, num_funcoes, num_funcoes_sem_quadro);
+    }
+    if (opcoes.chamadas_de_cauda) {
+        printf("Chamadas de cauda: %d (%d recursiva(s)).\n", num_chamadas_de_cauda, num_recursoes_de_cauda);
+    }
+    if (opcoes.saida_com_buffer) {
+        int incluidas = 0;
+        for (int i = 0; i < NUM_ROTINAS; i++) incluidas += rotinas_usadas[i];
+        if (incluidas > 0 && !rotinas_usadas[ROTINA_DESCARREGA]) incluidas++; // Usada pelas demais.
+        printf("Entrada e saída com buffer: %d rotina(s) da biblioteca incluída(s).\n", incluidas);
+    }
 
-    // 5. Geração do Código de Finalização do Programa
-    fprintf(arquivo_saida, "\nend_main:\n");    // Rótulo para o fim da execução.
-    fprintf(arquivo_saida, "  li $v0, 10\n");   // Carrega o código de serviço 10 (exit).
-    fprintf(arquivo_saida, "  syscall\n");      // Encerra o programa.
+    // 5. Otimização de janela sobre as instruções ainda em memória (se pedida).
+    if (opcoes.peephole) {
+        otimiza_peephole(&codigo, opcoes.regras_peephole);
+        imprime_estatisticas_peephole();
+    }
+    // As rotinas da biblioteca já vêm prontas: entram depois da otimização de janela.
+    emite_biblioteca(&codigo, rotinas_usadas);
 
+    // 6. Converte as instruções em texto e grava tudo no arquivo de uma só vez.
+    if (codigo_escreve(&codigo, arquivo_saida) < 0) {
+        perror("Erro ao escrever o arquivo de saída");
+        exit(1);
+    }
     // Fecha o arquivo de saída.
     fclose(arquivo_saida);
+    codigo_liberar(&codigo);
 
-    // Libera a memória alocada para a lista de strings.
-    while(lista_strings) {
-        StringLiteral* temp = lista_strings;
-        lista_strings = lista_strings->next;
-        free(temp);
-    }
-    
     printf("Geração de código concluída. Arquivo '%s' criado.\n", nome_arquivo_saida);
-}
\ No newline at end of file
+}
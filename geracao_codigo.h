@@ -4,17 +4,29 @@
 #define GERACAO_CODIGO_H
 
 #include "arvore.h"
+#include "ir.h"
+
+// Opções que ajustam o código gerado (escolhidas na linha de comando).
+typedef struct OpcoesGeracao {
+    int promover_registradores; // Mantém as variáveis locais mais usadas em $s2-$s7 em vez da pilha.
+    int peephole;               // Aplica a otimização de janela (peephole.c) ao código gerado.
+    unsigned int regras_peephole; // Máscara das regras de janela ligadas (bit = índice da regra).
+    int chamadas_de_cauda;      // Troca "retorne f(...)" por um salto que reaproveita o quadro.
+    int saida_com_buffer;       // 'leia' e 'escreva' chamam as rotinas com buffer de biblioteca.c.
+    int depuracao;              // Imprime um resumo das decisões tomadas pela geração.
+} OpcoesGeracao;
 
 /**
  * @brief Função principal para iniciar a geração de código.
  *
- * Percorre a Árvore Sintática Abstrata (ASA) e gera o código assembly MIPS
- * em um arquivo de saída.
+ * Percorre o código intermediário (gerado a partir da ASA por gera_ir) e gera o
+ * código assembly MIPS em um arquivo de saída.
  *
- * @param raiz_arvore Ponteiro para o nó raiz da ASA.
+ * @param programa O código intermediário do programa.
  * @param nome_arquivo_saida O nome do arquivo .asm a ser criado.
+ * @param opcoes Opções de geração (NULL = todas desligadas).
  */
-void gerar_codigo(No* raiz_arvore, const char* nome_arquivo_saida);
-TipoDado string_para_tipo(char* str);
+void gerar_codigo(ProgramaIR* programa, const char* nome_arquivo_saida, const OpcoesGeracao* opcoes);
+TipoDado atomo_para_tipo(Atomo nome_tipo);
 
 #endif // GERACAO_CODIGO_H
\ No newline at end of file
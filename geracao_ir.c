@@ -0,0 +1,402 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "geracao_ir.h"
+#include "tabela_simbolos.h" // Vínculos anotados na árvore pela análise semântica.
+
+// Estado da tradução.
+static ProgramaIR* programa;
+static FuncaoIR* funcao_atual;
+static BlocoBasico* bloco_atual;       // Bloco que recebe as próximas instruções.
+static int profundidade_laco = 0;      // Quantos 'enquanto' envolvem o ponto atual.
+
+// Uma chamada de função destrói todos os temporários da máquina: para a ordem de Sethi-Ullman,
+// ela conta como se precisasse de todos eles.
+#define LIMITE_SETHI_ULLMAN 8
+
+static Operando gera_expr(No* no);
+static void gera_comandos(No* no);
+
+
+// --- Blocos ---
+
+// Começa a emitir no bloco 'b', que passa a ocupar o próximo lugar no código da função.
+static void inicia_bloco(BlocoBasico* b) {
+    b->profundidade_laco = profundidade_laco;
+    ir_posiciona_bloco(funcao_atual, b, funcao_atual->num_blocos);
+    bloco_atual = b;
+}
+
+
+// --- Expressões ---
+
+static OperadorIR operador_ir(Atomo op) {
+    switch (op) {
+        case ATOMO_MAIS:        return OPR_SOMA;
+        case ATOMO_MENOS:       return OPR_SUBTRACAO;
+        case ATOMO_VEZES:       return OPR_MULTIPLICACAO;
+        case ATOMO_DIVIDIDO:    return OPR_DIVISAO;
+        case ATOMO_IGUAL:       return OPR_IGUAL;
+        case ATOMO_DIFERENTE:   return OPR_DIFERENTE;
+        case ATOMO_MENOR:       return OPR_MENOR;
+        case ATOMO_MENOR_IGUAL: return OPR_MENOR_IGUAL;
+        case ATOMO_MAIOR:       return OPR_MAIOR;
+        case ATOMO_MAIOR_IGUAL: return OPR_MAIOR_IGUAL;
+        default:
+            // A análise semântica só deixa passar os operadores acima ('e' e 'ou' viram desvios).
+            fprintf(stderr, "Erro de Geração: Operador '%s' desconhecido.\n", texto_atomo(op));
+            exit(1);
+    }
+}
+
+// Verifica se um nó NO_CONST_CAR é, na verdade, uma cadeia de caracteres (lexema entre aspas).
+static int eh_cadeia(No* no) {
+    return no->tipo_no == NO_CONST_CAR && texto_atomo(no->lexema)[0] == '"';
+}
+
+// Número de Sethi-Ullman: quantos temporários a avaliação da subárvore precisa, avaliando
+// sempre primeiro o filho mais "caro". Folhas precisam de 1; um operador binário precisa do
+// maior dos dois, ou de um a mais se os dois empatarem (o resultado do primeiro fica ocupado
+// enquanto o segundo é avaliado).
+// O resultado é guardado no nó ('registradores' e 'tem_efeitos') para não ser recalculado.
+static int registradores_necessarios(No* no) {
+    if (no->registradores) return no->registradores;
+    int n = 1, efeitos = 0;
+    switch (no->tipo_no) {
+        case NO_OP_ARITMETICO:
+        case NO_OP_RELACIONAL: {
+            int esq = registradores_necessarios(no->filho1);
+            int dir = registradores_necessarios(no->filho2);
+            n = esq == dir ? esq + 1 : (esq > dir ? esq : dir);
+            efeitos = no->filho1->tem_efeitos || no->filho2->tem_efeitos;
+            break;
+        }
+        case NO_OP_LOGICO: {
+            // Os lados são avaliados um de cada vez, mas o resultado fica ocupado o tempo todo.
+            int esq = registradores_necessarios(no->filho1);
+            int dir = registradores_necessarios(no->filho2);
+            n = (esq > dir ? esq : dir) + 1;
+            efeitos = no->filho1->tem_efeitos || no->filho2->tem_efeitos;
+            break;
+        }
+        case NO_NEGACAO:
+            n = registradores_necessarios(no->filho1);
+            efeitos = no->filho1->tem_efeitos;
+            break;
+        case NO_ATRIBUICAO:
+            n = registradores_necessarios(no->filho2);
+            efeitos = 1;
+            break;
+        case NO_CHAMADA_FUNCAO:
+            n = LIMITE_SETHI_ULLMAN;
+            efeitos = 1;
+            break;
+        default: // Constantes e identificadores.
+            break;
+    }
+    if (n > LIMITE_SETHI_ULLMAN) n = LIMITE_SETHI_ULLMAN;
+    no->registradores = n;
+    no->tem_efeitos = efeitos;
+    return n;
+}
+
+// Avalia os argumentos da direita para a esquerda (a recursão chega ao último antes de gerar
+// o primeiro), guardando o valor do argumento 'posicao' em valores[posicao]. 'efeitos_antes'
+// diz se algum argumento à esquerda (avaliado depois) tem efeitos colaterais.
+static void avalia_argumentos(No* arg, int posicao, int efeitos_antes, Operando* valores) {
+    if (!arg) return;
+    registradores_necessarios(arg);
+    avalia_argumentos(arg->proximo, posicao + 1, efeitos_antes || arg->tem_efeitos, valores);
+    Operando valor = gera_expr(arg);
+    if (valor.tipo == OPERANDO_VAR && efeitos_antes) {
+        // A variável só é lida quando o argumento é passado, depois dos que faltam avaliar.
+        Operando copia = ir_novo_temp(funcao_atual);
+        ir_copia(bloco_atual, copia, valor);
+        valor = copia;
+    }
+    valores[posicao] = valor;
+}
+
+// Gera os argumentos de uma chamada e devolve quantos são. Todos são avaliados antes de o
+// primeiro ser passado: os que vão em registradores ($a0-$a3) seriam destruídos por uma
+// chamada feita ao avaliar outro argumento (ex: "f(g(1), h(2))"). Os argumentos são passados
+// do último para o primeiro, a ordem em que os que não cabem nos registradores são empilhados.
+static int gera_argumentos(No* args) {
+    int n = 0;
+    for (No* arg = args; arg; arg = arg->proximo) n++;
+    if (n == 0) return 0;
+    Operando* valores = malloc(n * sizeof(Operando));
+    avalia_argumentos(args, 0, 0, valores);
+    for (int i = n - 1; i >= 0; i--) {
+        InstrucaoIR* ins = ir_acrescenta(bloco_atual, IR_ARGUMENTO);
+        ins->a = valores[i];
+        ins->posicao = i;
+    }
+    free(valores);
+    return n;
+}
+
+// Traduz uma chamada. Para funções do usuário cujo valor é usado, devolve o temporário que
+// recebe o valor de retorno; nos demais casos devolve nenhum operando.
+static Operando gera_chamada(No* no, int usa_valor) {
+    InstrucaoIR* ins;
+    switch (no->lexema) {
+        case ATOMO_ESCREVA:
+            if (eh_cadeia(no->filho1)) {
+                ins = ir_acrescenta(bloco_atual, IR_ESCREVA_CADEIA);
+                ins->cadeia = ir_indice_cadeia(programa, no->filho1->lexema);
+            } else {
+                Operando valor = gera_expr(no->filho1);
+                ins = ir_acrescenta(bloco_atual, IR_ESCREVA);
+                ins->a = valor;
+                ins->tipo = no->filho1->tipo_dado;
+            }
+            return ir_nenhum();
+        case ATOMO_LEIA:
+            ir_acrescenta(bloco_atual, IR_LEIA)->destino = ir_var(no->filho1->vinculo);
+            return ir_nenhum();
+        case ATOMO_NOVALINHA:
+            ir_acrescenta(bloco_atual, IR_NOVALINHA);
+            return ir_nenhum();
+        default: {
+            int num_args = gera_argumentos(no->filho1);
+            ins = ir_acrescenta(bloco_atual, IR_CHAMADA);
+            ins->funcao = no->vinculo;
+            ins->num_args = num_args;
+            if (usa_valor) ins->destino = ir_novo_temp(funcao_atual);
+            return ins->destino;
+        }
+    }
+}
+
+// Avalia os dois operandos de um operador binário e os devolve na ordem do programa. Eles são
+// avaliados na ordem de Sethi-Ullman: primeiro o que precisa de mais temporários, para que o
+// valor do outro fique vivo pelo menor tempo possível. A troca de ordem só é feita quando
+// nenhum dos dois lados tem efeitos colaterais (chamadas ou atribuições), para não mudar o
+// resultado do programa.
+static void gera_operandos(No* no, Operando* a, Operando* b) {
+    No* esq = no->filho1;
+    No* dir = no->filho2;
+    int inverte = registradores_necessarios(dir) > registradores_necessarios(esq)
+                  && !esq->tem_efeitos && !dir->tem_efeitos;
+    No* primeiro = inverte ? dir : esq;
+    No* segundo = inverte ? esq : dir;
+
+    Operando o1 = gera_expr(primeiro);
+    if (o1.tipo == OPERANDO_VAR && segundo->tem_efeitos) {
+        // Uma variável só é lida quando a instrução executa, e o segundo operando pode
+        // alterá-la (ex: "x + (x = 1)"): copia o valor atual antes.
+        Operando copia = ir_novo_temp(funcao_atual);
+        ir_copia(bloco_atual, copia, o1);
+        o1 = copia;
+    }
+    Operando o2 = gera_expr(segundo);
+    *a = inverte ? o2 : o1;
+    *b = inverte ? o1 : o2;
+}
+
+static Operando gera_op_binaria(No* no) {
+    Operando a, b;
+    gera_operandos(no, &a, &b);
+    Operando destino = ir_novo_temp(funcao_atual);
+    ir_binario(bloco_atual, operador_ir(no->lexema), destino, a, b);
+    return destino;
+}
+
+// --- Condições ---
+// 'e' e 'ou' só avaliam o lado direito quando o esquerdo não decide o resultado. Numa
+// condição de 'se' ou 'enquanto', cada operando desvia direto para o destino verdadeiro ou
+// falso, sem calcular 0 ou 1; a negação só troca os destinos. Uma comparação também não é
+// calculada: o próprio desvio compara os dois operandos.
+
+// Indica se a expressão é um 'e'/'ou', possivelmente negado.
+static int eh_logica(const No* no) {
+    while (no->tipo_no == NO_NEGACAO) no = no->filho1;
+    return no->tipo_no == NO_OP_LOGICO;
+}
+
+// Termina o bloco atual desviando para 'se_verdadeiro' se a condição for diferente de zero e
+// para 'se_falso' caso contrário.
+static void gera_condicao(No* no, BlocoBasico* se_verdadeiro, BlocoBasico* se_falso) {
+    if (no->tipo_no == NO_OP_LOGICO) {
+        BlocoBasico* direito = ir_novo_bloco(programa);
+        if (no->lexema == ATOMO_E) gera_condicao(no->filho1, direito, se_falso);
+        else gera_condicao(no->filho1, se_verdadeiro, direito);
+        inicia_bloco(direito);
+        gera_condicao(no->filho2, se_verdadeiro, se_falso);
+    } else if (no->tipo_no == NO_NEGACAO) {
+        gera_condicao(no->filho1, se_falso, se_verdadeiro);
+    } else if (no->tipo_no == NO_OP_RELACIONAL) {
+        Operando a, b;
+        gera_operandos(no, &a, &b);
+        ir_desvio_comparacao(bloco_atual, operador_ir(no->lexema), a, b, se_verdadeiro, se_falso);
+    } else {
+        ir_desvio(bloco_atual, gera_expr(no), se_verdadeiro, se_falso);
+    }
+}
+
+// Valor de uma expressão lógica fora de uma condição. O resultado começa valendo 0 e só o
+// caminho verdadeiro o troca por 1, então é normalizado uma vez, no fim.
+static Operando gera_valor_logico(No* no) {
+    Operando resultado = ir_novo_temp(funcao_atual);
+    BlocoBasico* verdadeiro = ir_novo_bloco(programa);
+    BlocoBasico* fim = ir_novo_bloco(programa);
+    ir_copia(bloco_atual, resultado, ir_const(0));
+    gera_condicao(no, verdadeiro, fim);
+    inicia_bloco(verdadeiro);
+    ir_copia(bloco_atual, resultado, ir_const(1));
+    ir_salto(bloco_atual, fim);
+    inicia_bloco(fim);
+    return resultado;
+}
+
+// Traduz uma expressão e devolve o operando com o seu valor: uma constante, uma variável
+// ou o temporário que recebeu o resultado.
+static Operando gera_expr(No* no) {
+    switch (no->tipo_no) {
+        case NO_ATRIBUICAO: {
+            // A atribuição também é uma expressão: seu valor é o valor atribuído.
+            Operando valor = gera_expr(no->filho2);
+            ir_copia(bloco_atual, ir_var(no->filho1->vinculo), valor);
+            return valor;
+        }
+        case NO_CHAMADA_FUNCAO:
+            return gera_chamada(no, 1);
+
+        case NO_OP_ARITMETICO:
+        case NO_OP_RELACIONAL:
+            return gera_op_binaria(no);
+
+        case NO_OP_LOGICO:
+            return gera_valor_logico(no);
+
+        case NO_NEGACAO: { // "!x" é 1 quando x vale 0, e 0 nos demais casos.
+            if (eh_logica(no)) return gera_valor_logico(no);
+            Operando valor = gera_expr(no->filho1);
+            Operando destino = ir_novo_temp(funcao_atual);
+            ir_binario(bloco_atual, OPR_IGUAL, destino, valor, ir_const(0));
+            return destino;
+        }
+
+        case NO_IDENTIFICADOR:
+            return ir_var(no->vinculo);
+
+        case NO_CONST_INT:
+        case NO_CONST_CAR: // Cadeias (entre aspas) só aparecem em "escreva", tratada à parte.
+            return ir_const(valor_constante(no));
+
+        default:
+            fprintf(stderr, "Erro de Geração: Nó de expressão inesperado (tipo %d).\n", no->tipo_no);
+            exit(1);
+    }
+}
+
+
+// --- Comandos ---
+
+static void gera_se(No* no) {
+    BlocoBasico* entao = ir_novo_bloco(programa);
+    BlocoBasico* senao = no->filho3 ? ir_novo_bloco(programa) : NULL;
+    BlocoBasico* fim = ir_novo_bloco(programa);
+    gera_condicao(no->filho1, entao, senao ? senao : fim);
+
+    inicia_bloco(entao);
+    gera_comandos(no->filho2);
+    ir_salto(bloco_atual, fim);
+    if (senao) {
+        inicia_bloco(senao);
+        gera_comandos(no->filho3);
+        ir_salto(bloco_atual, fim);
+    }
+    inicia_bloco(fim);
+}
+
+// O laço testa a condição no início de cada volta; o corpo salta de volta para o teste.
+static void gera_enquanto(No* no) {
+    BlocoBasico* teste = ir_novo_bloco(programa);
+    BlocoBasico* corpo = ir_novo_bloco(programa);
+    BlocoBasico* fim = ir_novo_bloco(programa);
+    ir_salto(bloco_atual, teste);
+
+    profundidade_laco++;
+    inicia_bloco(teste);
+    gera_condicao(no->filho1, corpo, fim);
+    inicia_bloco(corpo);
+    gera_comandos(no->filho2);
+    ir_salto(bloco_atual, teste);
+    profundidade_laco--;
+
+    inicia_bloco(fim);
+}
+
+static void gera_comando(No* no) {
+    switch (no->tipo_no) {
+        case NO_BLOCO:
+            // As variáveis declaradas no bloco só são visíveis dentro da função.
+            for (No* decl = no->filho1; decl != NULL; decl = decl->proximo) {
+                if (decl->tipo_no == NO_DECL_VAR) ir_acrescenta_variavel(funcao_atual, decl->vinculo);
+            }
+            gera_comandos(no->filho2);
+            break;
+        case NO_IF:
+            gera_se(no);
+            break;
+        case NO_WHILE:
+            gera_enquanto(no);
+            break;
+        case NO_RETORNO:
+            ir_retorno(bloco_atual, no->filho1 ? gera_expr(no->filho1) : ir_nenhum());
+            // O que vier depois do 'retorne' fica num bloco inalcançável, descartado por ir_atualiza_grafo.
+            inicia_bloco(ir_novo_bloco(programa));
+            break;
+        case NO_CHAMADA_FUNCAO:
+            gera_chamada(no, 0); // O valor (se houver) é descartado.
+            break;
+        case NO_DECL_VAR:
+            break;
+        default: // Outras expressões usadas como comando: só os efeitos importam.
+            gera_expr(no);
+            break;
+    }
+}
+
+static void gera_comandos(No* no) {
+    for (; no != NULL; no = no->proximo) gera_comando(no);
+}
+
+// Traduz o corpo de uma função (ou o bloco principal, com vinculo = NULL). Sair pelo fim do
+// corpo equivale a um 'retorne' sem valor.
+static void gera_funcao(Vinculo* vinculo, const char* nome, No* params, No* corpo) {
+    funcao_atual = ir_nova_funcao(programa, vinculo, nome);
+    for (No* p = params; p != NULL; p = p->proximo) ir_acrescenta_variavel(funcao_atual, p->vinculo);
+    profundidade_laco = 0;
+    inicia_bloco(ir_novo_bloco(programa));
+    gera_comandos(corpo);
+    ir_retorno(bloco_atual, ir_nenhum());
+    ir_atualiza_grafo(funcao_atual);
+}
+
+static void gera_declaracoes(No* no) {
+    for (; no != NULL; no = no->proximo) {
+        if (no->tipo_no == NO_DECL_FUNCAO) {
+            gera_funcao(no->vinculo, texto_atomo(no->vinculo->nome), no->filho2, no->filho3);
+        } else if (no->tipo_no == NO_DECL_VAR) {
+            ir_acrescenta_global(programa, no->vinculo);
+        } else { // Listas: visita os filhos.
+            gera_declaracoes(no->filho1); gera_declaracoes(no->filho2);
+            gera_declaracoes(no->filho3); gera_declaracoes(no->filho4);
+        }
+    }
+}
+
+ProgramaIR* gera_ir(No* raiz_arvore) {
+    programa = ir_novo_programa();
+    gera_declaracoes(raiz_arvore->filho1);
+    gera_funcao(NULL, "main", NULL, raiz_arvore->filho2);
+    programa->principal = funcao_atual;
+
+    ProgramaIR* resultado = programa;
+    programa = NULL;
+    funcao_atual = NULL;
+    bloco_atual = NULL;
+    return resultado;
+}
@@ -0,0 +1,16 @@
+#ifndef GERACAO_IR_H
+#define GERACAO_IR_H
+
+#include "arvore.h"
+#include "ir.h"
+
+// --- Tradução da Árvore para o Código Intermediário ---
+// Percorre a árvore já analisada (e, se pedido, otimizada) e produz uma FuncaoIR por função
+// declarada, mais uma para o bloco principal. Os comandos 'se' e 'enquanto' viram blocos
+// básicos ligados por desvios; as expressões viram instruções de três endereços sobre
+// temporários, avaliadas na ordem de Sethi-Ullman.
+
+// Traduz o programa inteiro. O resultado deve ser devolvido com ir_liberar.
+ProgramaIR* gera_ir(No* raiz_arvore);
+
+#endif // GERACAO_IR_H
@@ -25,16 +25,16 @@ void yyerror(const char *s);/* A função que o parser chama quando encontra um
 /* A união '%union' define os diferentes tipos de dados que um símbolo (terminal ou não-terminal)
    pode ter. O analisador léxico e as regras sintáticas usam esta união para trocar informações. */
 %union {
-    char* str_lexema; /* Para tokens que carregam um valor de string (ex: um ID, um número, um operador como "=="). */
+    Atomo atomo;      /* Para tokens que carregam um lexema (ex: um ID, um número, um operador como "=="), já internado como átomo. */
     No* no_ptr;     /* Para símbolos não-terminais que, ao serem reduzidos, resultam em um ponteiro para um nó da ASA. */
 }
 
 /* --- Declaração de Tokens (Símbolos Terminais) --- */
 /* Aqui listamos todos os tokens que o analisador léxico pode retornar. */
-%token <str_lexema> ID INTCONST CARCONST CAD_CAR       /* Tokens que carregam um lexema em 'str_lexema'. */
+%token <atomo> ID INTCONST CARCONST CAD_CAR            /* Tokens que carregam um lexema (átomo) em 'atomo'. */
 %token PROGRAM CAR INT RETORNE LEIA ESCREVA NOVALINHA
 %token SE ENTAO SENAO ENQUANTO EXECUTE
-%token <str_lexema> DIF IGUAL MENOR_IGUAL MAIOR_IGUAL MENOR MAIOR E OU /* Operadores que também carregam o lexema. */
+%token <atomo> DIF IGUAL MENOR_IGUAL MAIOR_IGUAL MENOR MAIOR E OU /* Operadores que também carregam o lexema. */
 
 /* --- Declaração de Tipos para Não-Terminais --- */
 /* Aqui, associamos os símbolos não-terminais (regras da gramática) a um tipo da %union.
@@ -74,7 +74,7 @@ Programa
     : DeclFuncVar DeclProg
     {
         /* Ação: Nó raiz do programa. */
-        $$ = cria_no(NO_PROGRAMA, yylineno, NULL); /* Cria o nó 'Programa'. */
+        $$ = cria_no(NO_PROGRAMA, yylineno, ATOMO_NULO); /* Cria o nó 'Programa'. */
         $$->filho1 = $1; /* O primeiro filho é a lista de declarações de funções/variáveis globais. */
         $$->filho2 = $2; /* O segundo filho é o bloco principal 'programa'. */
         raiz_arvore = $$; /* Armazena o nó raiz na variável global. */
@@ -107,7 +107,6 @@ DeclFuncVar
         /* 3. Conecta a lista que criamos com o resto das declarações de funções/variáveis ($5). */
         ult_decl->proximo = $5;
         $$ = prim_decl; /* O resultado da regra é o início da lista de declarações. */
-        free($1->lexema); free($1); free($2); /* Libera memória intermediária. */
     }
     | Tipo ID DeclFunc DeclFuncVar
     {
@@ -134,7 +133,6 @@ DeclVar
         /* Retorna uma lista encadeada de nós de IDENTIFICADOR. */
         $$ = cria_no(NO_IDENTIFICADOR, yylineno, $2);
         $$->proximo = $3;
-        free($2);
     }
     | /* vazio */ { $$ = NULL; }
     ;
@@ -143,7 +141,7 @@ DeclFunc
     : '(' ListaParametros ')' Bloco
     {
         /* Cria um nó de função PARCIAL. O nome e o tipo são preenchidos pela regra pai (DeclFuncVar). */
-        $$ = cria_no(NO_DECL_FUNCAO, yylineno, NULL); /* Nome (lexema) é NULL por enquanto. */
+        $$ = cria_no(NO_DECL_FUNCAO, yylineno, ATOMO_NULO); /* Nome (lexema) é ATOMO_NULO por enquanto. */
         $$->filho2 = $2; /* O segundo filho são os parâmetros. */
         $$->filho3 = $4; /* O terceiro filho é o corpo da função (bloco). */
     }
@@ -160,7 +158,6 @@ ListaParametrosCont
         /* Parâmetro único ou o último de uma lista. */
         $$ = cria_no(NO_PARAM, yylineno, $1->lexema); /* O lexema do nó guarda o tipo do parâmetro. */
         $$->filho1 = cria_no(NO_IDENTIFICADOR, yylineno, $2); /* O filho guarda o nome. */
-        free($1->lexema); free($1); free($2);
     }
     | Tipo ID ',' ListaParametrosCont
     {
@@ -168,7 +165,6 @@ ListaParametrosCont
         $$ = cria_no(NO_PARAM, yylineno, $1->lexema);
         $$->filho1 = cria_no(NO_IDENTIFICADOR, yylineno, $2);
         $$->proximo = $4; /* Encadeia com o resto da lista de parâmetros. */
-        free($1->lexema); free($1); free($2);
     }
     ;
 
@@ -176,7 +172,7 @@ Bloco
     : '{' ListaDeclVar ListaComando '}'
     {
         /* Um bloco de código. */
-        $$ = cria_no(NO_BLOCO, yylineno, NULL);
+        $$ = cria_no(NO_BLOCO, yylineno, ATOMO_NULO);
         $$->filho1 = $2; /* Filho 1: lista de declarações de variáveis locais. */
         $$->filho2 = $3; /* Filho 2: lista de comandos. */
     }
@@ -201,7 +197,6 @@ ListaDeclVar
         }
         ult_decl->proximo = $5;
         $$ = prim_decl;
-        free($1->lexema); free($1); free($2);
     }
     | /* vazio */ { $$ = NULL; }
     ;
@@ -209,8 +204,8 @@ ListaDeclVar
 Tipo
     /* Regra para reconhecer tipos. Cria um nó temporário que será usado
        pelas regras de declaração. O lexema do nó é o nome do tipo. */
-    : INT { $$ = cria_no(NO_DECL_VAR, yylineno, "int"); }
-    | CAR { $$ = cria_no(NO_DECL_VAR, yylineno, "car"); }
+    : INT { $$ = cria_no(NO_DECL_VAR, yylineno, ATOMO_INT); }
+    | CAR { $$ = cria_no(NO_DECL_VAR, yylineno, ATOMO_CAR); }
     ;
 
 ListaComando
@@ -232,35 +227,33 @@ ListaComando
 Comando
     /* Um comando pode ser uma expressão, um retorno, uma chamada, um condicional, etc. */
     : Expr ';'              { $$ = $1; }
-    | RETORNE Expr ';'      { $$ = cria_no(NO_RETORNO, yylineno, NULL); $$->filho1 = $2; }
+    | RETORNE Expr ';'      { $$ = cria_no(NO_RETORNO, yylineno, ATOMO_NULO); $$->filho1 = $2; }
     
     // REGRA CORRIGIDA PARA LEIA
     | LEIA ID ';'           { 
-                                $$ = cria_no(NO_CHAMADA_FUNCAO, yylineno, "leia"); 
+                                $$ = cria_no(NO_CHAMADA_FUNCAO, yylineno, ATOMO_LEIA); 
                                 $$->filho1 = cria_no(NO_IDENTIFICADOR, yylineno, $2); 
-                                free($2);
                             }
     // REGRA CORRIGIDA PARA ESCREVA
     | ESCREVA Expr ';'      { 
-                                $$ = cria_no(NO_CHAMADA_FUNCAO, yylineno, "escreva"); 
+                                $$ = cria_no(NO_CHAMADA_FUNCAO, yylineno, ATOMO_ESCREVA); 
                                 $$->filho1 = $2; 
                             }
     // REGRA CORRIGIDA PARA ESCREVA COM CADEIA DE CARACTERES (já estava quase certo)
     | ESCREVA CAD_CAR ';'   { 
                                 No* str_node = cria_no(NO_CONST_CAR, yylineno, $2);
-                                $$ = cria_no(NO_CHAMADA_FUNCAO, yylineno, "escreva");
+                                $$ = cria_no(NO_CHAMADA_FUNCAO, yylineno, ATOMO_ESCREVA);
                                 $$->filho1 = str_node;
-                                free($2);
                             }
     // REGRA CORRIGIDA PARA NOVALINHA
     | NOVALINHA ';'         { 
-                                $$ = cria_no(NO_CHAMADA_FUNCAO, yylineno, "novalinha");
+                                $$ = cria_no(NO_CHAMADA_FUNCAO, yylineno, ATOMO_NOVALINHA);
                                 $$->filho1 = NULL; // Sem argumentos
                             }
     
-    | SE '(' Expr ')' ENTAO Comando           { $$ = cria_no(NO_IF, yylineno, NULL); $$->filho1 = $3; $$->filho2 = $6; $$->filho3 = NULL; }
-    | SE '(' Expr ')' ENTAO Comando SENAO Comando { $$ = cria_no(NO_IF, yylineno, NULL); $$->filho1 = $3; $$->filho2 = $6; $$->filho3 = $8; }
-    | ENQUANTO '(' Expr ')' EXECUTE Comando   { $$ = cria_no(NO_WHILE, yylineno, NULL); $$->filho1 = $3; $$->filho2 = $6; }
+    | SE '(' Expr ')' ENTAO Comando           { $$ = cria_no(NO_IF, yylineno, ATOMO_NULO); $$->filho1 = $3; $$->filho2 = $6; $$->filho3 = NULL; }
+    | SE '(' Expr ')' ENTAO Comando SENAO Comando { $$ = cria_no(NO_IF, yylineno, ATOMO_NULO); $$->filho1 = $3; $$->filho2 = $6; $$->filho3 = $8; }
+    | ENQUANTO '(' Expr ')' EXECUTE Comando   { $$ = cria_no(NO_WHILE, yylineno, ATOMO_NULO); $$->filho1 = $3; $$->filho2 = $6; }
     | Bloco                 { $$ = $1; }
     | ';'                   { $$ = NULL; } /* Comando vazio, resulta em nada na ASA. */
     ;
@@ -270,10 +263,9 @@ Expr
     : ID '=' Expr
     {
         /* Atribuição. */
-        $$ = cria_no(NO_ATRIBUICAO, yylineno, NULL);
+        $$ = cria_no(NO_ATRIBUICAO, yylineno, ATOMO_NULO);
         $$->filho1 = cria_no(NO_IDENTIFICADOR, yylineno, $1);
         $$->filho2 = $3;
-        free($1);
     }
     | OrExpr { $$ = $1; }
     ;
@@ -281,42 +273,42 @@ Expr
 /* --- Níveis de Precedência de Expressões --- */
 /* Cada regra passa o controle para a regra de maior precedência, e se não houver operador
    daquele nível, ela simplesmente passa o resultado da regra de maior precedência para cima. */
-OrExpr    : OrExpr OU AndExpr { $$ = cria_no(NO_OP_LOGICO, yylineno, "ou"); $$->filho1 = $1; $$->filho2 = $3; }
+OrExpr    : OrExpr OU AndExpr { $$ = cria_no(NO_OP_LOGICO, yylineno, ATOMO_OU); $$->filho1 = $1; $$->filho2 = $3; }
           | AndExpr { $$ = $1; } ;
 
-AndExpr   : AndExpr E EqExpr { $$ = cria_no(NO_OP_LOGICO, yylineno, "e"); $$->filho1 = $1; $$->filho2 = $3; }
+AndExpr   : AndExpr E EqExpr { $$ = cria_no(NO_OP_LOGICO, yylineno, ATOMO_E); $$->filho1 = $1; $$->filho2 = $3; }
           | EqExpr { $$ = $1; } ;
 
-EqExpr    : EqExpr IGUAL DesigExpr { $$ = cria_no(NO_OP_RELACIONAL, yylineno, $2); $$->filho1 = $1; $$->filho2 = $3; free($2); }
-          | EqExpr DIF DesigExpr { $$ = cria_no(NO_OP_RELACIONAL, yylineno, $2); $$->filho1 = $1; $$->filho2 = $3; free($2); }
+EqExpr    : EqExpr IGUAL DesigExpr { $$ = cria_no(NO_OP_RELACIONAL, yylineno, $2); $$->filho1 = $1; $$->filho2 = $3; }
+          | EqExpr DIF DesigExpr { $$ = cria_no(NO_OP_RELACIONAL, yylineno, $2); $$->filho1 = $1; $$->filho2 = $3; }
           | DesigExpr { $$ = $1; } ;
 
-DesigExpr : DesigExpr MENOR AddExpr { $$ = cria_no(NO_OP_RELACIONAL, yylineno, $2); $$->filho1 = $1; $$->filho2 = $3; free($2); }
-          | DesigExpr MAIOR AddExpr { $$ = cria_no(NO_OP_RELACIONAL, yylineno, $2); $$->filho1 = $1; $$->filho2 = $3; free($2); }
-          | DesigExpr MAIOR_IGUAL AddExpr { $$ = cria_no(NO_OP_RELACIONAL, yylineno, $2); $$->filho1 = $1; $$->filho2 = $3; free($2); }
-          | DesigExpr MENOR_IGUAL AddExpr { $$ = cria_no(NO_OP_RELACIONAL, yylineno, $2); $$->filho1 = $1; $$->filho2 = $3; free($2); }
+DesigExpr : DesigExpr MENOR AddExpr { $$ = cria_no(NO_OP_RELACIONAL, yylineno, $2); $$->filho1 = $1; $$->filho2 = $3; }
+          | DesigExpr MAIOR AddExpr { $$ = cria_no(NO_OP_RELACIONAL, yylineno, $2); $$->filho1 = $1; $$->filho2 = $3; }
+          | DesigExpr MAIOR_IGUAL AddExpr { $$ = cria_no(NO_OP_RELACIONAL, yylineno, $2); $$->filho1 = $1; $$->filho2 = $3; }
+          | DesigExpr MENOR_IGUAL AddExpr { $$ = cria_no(NO_OP_RELACIONAL, yylineno, $2); $$->filho1 = $1; $$->filho2 = $3; }
           | AddExpr { $$ = $1; } ;
 
-AddExpr   : AddExpr '+' MulExpr { $$ = cria_no(NO_OP_ARITMETICO, yylineno, "+"); $$->filho1 = $1; $$->filho2 = $3; }
-          | AddExpr '-' MulExpr { $$ = cria_no(NO_OP_ARITMETICO, yylineno, "-"); $$->filho1 = $1; $$->filho2 = $3; }
+AddExpr   : AddExpr '+' MulExpr { $$ = cria_no(NO_OP_ARITMETICO, yylineno, ATOMO_MAIS); $$->filho1 = $1; $$->filho2 = $3; }
+          | AddExpr '-' MulExpr { $$ = cria_no(NO_OP_ARITMETICO, yylineno, ATOMO_MENOS); $$->filho1 = $1; $$->filho2 = $3; }
           | MulExpr { $$ = $1; } ;
           
-MulExpr   : MulExpr '*' UnExpr { $$ = cria_no(NO_OP_ARITMETICO, yylineno, "*"); $$->filho1 = $1; $$->filho2 = $3; }
-          | MulExpr '/' UnExpr { $$ = cria_no(NO_OP_ARITMETICO, yylineno, "/"); $$->filho1 = $1; $$->filho2 = $3; }
+MulExpr   : MulExpr '*' UnExpr { $$ = cria_no(NO_OP_ARITMETICO, yylineno, ATOMO_VEZES); $$->filho1 = $1; $$->filho2 = $3; }
+          | MulExpr '/' UnExpr { $$ = cria_no(NO_OP_ARITMETICO, yylineno, ATOMO_DIVIDIDO); $$->filho1 = $1; $$->filho2 = $3; }
           | UnExpr { $$ = $1; } ;
 
 UnExpr
     : '-' PrimExpr %prec UNEG /* O '%prec UNEG' força a precedência deste operador unário a ser a definida por 'UNEG'. */
     {
         /* Representa o menos unário como uma multiplicação por -1. */
-        $$ = cria_no(NO_OP_ARITMETICO, yylineno, "*");
-        $$->filho1 = cria_no(NO_CONST_INT, yylineno, "-1");
+        $$ = cria_no(NO_OP_ARITMETICO, yylineno, ATOMO_VEZES);
+        $$->filho1 = cria_no(NO_CONST_INT, yylineno, ATOMO_MENOS_UM);
         $$->filho2 = $2;
     }
     | '!' PrimExpr %prec UNEG
     {
         /* Operador de negação lógica. */
-        $$ = cria_no(NO_NEGACAO, yylineno, "!");
+        $$ = cria_no(NO_NEGACAO, yylineno, ATOMO_NEGACAO);
         $$->filho1 = $2;
     }
     | PrimExpr { $$ = $1; }
@@ -329,18 +321,16 @@ PrimExpr
         /* Chamada de função com um ou mais argumentos. */
         $$ = cria_no(NO_CHAMADA_FUNCAO, yylineno, $1);
         $$->filho1 = $3;
-        free($1);
     }
     | ID '(' ')'
     {
         /* Chamada de função sem argumentos. */
         $$ = cria_no(NO_CHAMADA_FUNCAO, yylineno, $1);
         $$->filho1 = NULL;
-        free($1);
     }
-    | ID        { $$ = cria_no(NO_IDENTIFICADOR, yylineno, $1); free($1); }
-    | INTCONST  { $$ = cria_no(NO_CONST_INT, yylineno, $1); free($1); }
-    | CARCONST  { $$ = cria_no(NO_CONST_CAR, yylineno, $1); free($1); }
+    | ID        { $$ = cria_no(NO_IDENTIFICADOR, yylineno, $1); }
+    | INTCONST  { $$ = cria_no(NO_CONST_INT, yylineno, $1); }
+    | CARCONST  { $$ = cria_no(NO_CONST_CAR, yylineno, $1); }
     | '(' Expr ')' { $$ = $2; } /* Expressão entre parênteses para forçar a ordem de avaliação. */
     ;
 
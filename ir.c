@@ -0,0 +1,682 @@
+#include <limits.h>         // Para INT_MIN.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ir.h"
+#include "arena.h"          // Instruções, blocos e funções ficam numa arena.
+#include "tabela_simbolos.h" // Nomes das variáveis e funções (para a listagem).
+
+// Instruções, blocos e funções do código intermediário. Os vetores que crescem (blocos de uma
+// função, predecessores, conjuntos de vivos) usam realloc e são devolvidos por ir_liberar.
+static Arena arena_ir = { .tamanho_bloco = 32 * 1024 };
+
+static void* cresce_vetor(void* vetor, int* capacidade, size_t tamanho_elemento) {
+    *capacidade = *capacidade ? *capacidade * 2 : 8;
+    vetor = realloc(vetor, *capacidade * tamanho_elemento);
+    if (!vetor) {
+        fprintf(stderr, "Erro: Falha de alocação de memória no código intermediário.\n");
+        exit(1);
+    }
+    return vetor;
+}
+
+
+// --- Construção ---
+
+ProgramaIR* ir_novo_programa(void) {
+    ProgramaIR* programa = arena_alocar(&arena_ir, sizeof(ProgramaIR));
+    memset(programa, 0, sizeof(*programa));
+    return programa;
+}
+
+FuncaoIR* ir_nova_funcao(ProgramaIR* programa, Vinculo* vinculo, const char* nome) {
+    FuncaoIR* funcao = arena_alocar(&arena_ir, sizeof(FuncaoIR));
+    memset(funcao, 0, sizeof(*funcao));
+    funcao->vinculo = vinculo;
+    funcao->nome = nome;
+    if (programa->num_funcoes == programa->capacidade_funcoes) {
+        programa->funcoes = cresce_vetor(programa->funcoes, &programa->capacidade_funcoes, sizeof(FuncaoIR*));
+    }
+    programa->funcoes[programa->num_funcoes++] = funcao;
+    return funcao;
+}
+
+BlocoBasico* ir_novo_bloco(ProgramaIR* programa) {
+    BlocoBasico* bloco = arena_alocar(&arena_ir, sizeof(BlocoBasico));
+    memset(bloco, 0, sizeof(*bloco));
+    bloco->id = programa->num_blocos++;
+    bloco->indice = -1;
+    bloco->terminador = TERM_ABERTO;
+    return bloco;
+}
+
+void ir_posiciona_bloco(FuncaoIR* funcao, BlocoBasico* bloco, int posicao) {
+    if (funcao->num_blocos == funcao->capacidade_blocos) {
+        funcao->blocos = cresce_vetor(funcao->blocos, &funcao->capacidade_blocos, sizeof(BlocoBasico*));
+    }
+    memmove(&funcao->blocos[posicao + 1], &funcao->blocos[posicao],
+            (funcao->num_blocos - posicao) * sizeof(BlocoBasico*));
+    funcao->blocos[posicao] = bloco;
+    funcao->num_blocos++;
+    for (int i = posicao; i < funcao->num_blocos; i++) funcao->blocos[i]->indice = i;
+}
+
+void ir_acrescenta_variavel(FuncaoIR* funcao, Vinculo* v) {
+    if (funcao->num_variaveis == funcao->capacidade_variaveis) {
+        funcao->variaveis = cresce_vetor(funcao->variaveis, &funcao->capacidade_variaveis, sizeof(Vinculo*));
+    }
+    funcao->variaveis[funcao->num_variaveis++] = v;
+}
+
+Vinculo* ir_nova_variavel(FuncaoIR* funcao, const Vinculo* modelo, Atomo nome) {
+    Vinculo* v = arena_alocar(&arena_ir, sizeof(Vinculo));
+    memset(v, 0, sizeof(*v));
+    v->nome = nome;
+    v->categoria = CAT_VARIAVEL;
+    v->tipo_dado = modelo->tipo_dado;
+    v->linha = modelo->linha;
+    if (funcao->vinculo) { // Uma local a mais no quadro da função.
+        v->classe = ARMAZ_LOCAL;
+        funcao->vinculo->tamanho_quadro += 4;
+        v->deslocamento = -funcao->vinculo->tamanho_quadro;
+    } else {               // As variáveis do bloco principal ficam na área global.
+        v->classe = ARMAZ_GLOBAL;
+    }
+    ir_acrescenta_variavel(funcao, v);
+    funcao->num_criadas++;
+    return v;
+}
+
+void ir_acrescenta_global(ProgramaIR* programa, Vinculo* v) {
+    if (programa->num_globais == programa->capacidade_globais) {
+        programa->globais = cresce_vetor(programa->globais, &programa->capacidade_globais, sizeof(Vinculo*));
+    }
+    programa->globais[programa->num_globais++] = v;
+}
+
+// Devolve o índice da cadeia, acrescentando-a na primeira vez (átomos iguais = textos iguais).
+int ir_indice_cadeia(ProgramaIR* programa, Atomo cadeia) {
+    for (int i = 0; i < programa->num_cadeias; i++) {
+        if (programa->cadeias[i] == cadeia) return i;
+    }
+    if (programa->num_cadeias == programa->capacidade_cadeias) {
+        programa->cadeias = cresce_vetor(programa->cadeias, &programa->capacidade_cadeias, sizeof(Atomo));
+    }
+    programa->cadeias[programa->num_cadeias] = cadeia;
+    return programa->num_cadeias++;
+}
+
+Operando ir_nenhum(void) {
+    Operando o = { OPERANDO_NENHUM, 0, NULL };
+    return o;
+}
+
+Operando ir_const(int valor) {
+    Operando o = { OPERANDO_CONST, valor, NULL };
+    return o;
+}
+
+Operando ir_var(Vinculo* v) {
+    Operando o = { OPERANDO_VAR, 0, v };
+    return o;
+}
+
+Operando ir_novo_temp(FuncaoIR* funcao) {
+    Operando o = { OPERANDO_TEMP, funcao->num_temporarios++, NULL };
+    return o;
+}
+
+int ir_calcula(OperadorIR operador, int x, int y, int* resultado) {
+    unsigned int ux = (unsigned int)x, uy = (unsigned int)y;
+    switch (operador) {
+        case OPR_SOMA:
+        case OPR_SOMA_MODULAR:  *resultado = (int)(ux + uy); break;
+        case OPR_SUBTRACAO:
+        case OPR_SUBTRACAO_MODULAR: *resultado = (int)(ux - uy); break;
+        case OPR_MULTIPLICACAO: *resultado = (int)(ux * uy); break;
+        case OPR_DIVISAO:
+            if (y == 0 || (x == INT_MIN && y == -1)) return 0;
+            *resultado = x / y;
+            break;
+        case OPR_IGUAL:         *resultado = x == y; break;
+        case OPR_DIFERENTE:     *resultado = x != y; break;
+        case OPR_MENOR:         *resultado = x < y; break;
+        case OPR_MENOR_IGUAL:   *resultado = x <= y; break;
+        case OPR_MAIOR:         *resultado = x > y; break;
+        case OPR_MAIOR_IGUAL:   *resultado = x >= y; break;
+        case OPR_DESLOCA_ESQUERDA:
+        case OPR_DESLOCA_DIREITA:
+        case OPR_DESLOCA_DIREITA_LOGICO:
+            if (y < 0 || y > 31) return 0;
+            if (operador == OPR_DESLOCA_ESQUERDA) *resultado = (int)(ux << y);
+            else if (operador == OPR_DESLOCA_DIREITA_LOGICO || x >= 0) *resultado = (int)(ux >> y);
+            else *resultado = (int)~(~ux >> y); // Os bits que entram são cópias do sinal.
+            break;
+        default:                return 0;
+    }
+    return 1;
+}
+
+OperadorIR ir_nega_comparacao(OperadorIR operador) {
+    switch (operador) {
+        case OPR_IGUAL:         return OPR_DIFERENTE;
+        case OPR_DIFERENTE:     return OPR_IGUAL;
+        case OPR_MENOR:         return OPR_MAIOR_IGUAL;
+        case OPR_MENOR_IGUAL:   return OPR_MAIOR;
+        case OPR_MAIOR:         return OPR_MENOR_IGUAL;
+        default:                return OPR_MENOR;       // OPR_MAIOR_IGUAL.
+    }
+}
+
+OperadorIR ir_espelha_comparacao(OperadorIR operador) {
+    switch (operador) {
+        case OPR_MENOR:         return OPR_MAIOR;
+        case OPR_MENOR_IGUAL:   return OPR_MAIOR_IGUAL;
+        case OPR_MAIOR:         return OPR_MENOR;
+        case OPR_MAIOR_IGUAL:   return OPR_MENOR_IGUAL;
+        default:                return operador;        // '==' e '!=' não mudam.
+    }
+}
+
+InstrucaoIR* ir_insere_antes(BlocoBasico* bloco, InstrucaoIR* posicao, OpcodeIR op) {
+    InstrucaoIR* ins = arena_alocar(&arena_ir, sizeof(InstrucaoIR));
+    memset(ins, 0, sizeof(*ins));
+    ins->op = op;
+    ins->proxima = posicao;
+    ins->anterior = posicao ? posicao->anterior : bloco->ultima;
+    if (ins->anterior) ins->anterior->proxima = ins;
+    else bloco->primeira = ins;
+    if (posicao) posicao->anterior = ins;
+    else bloco->ultima = ins;
+    return ins;
+}
+
+InstrucaoIR* ir_acrescenta(BlocoBasico* bloco, OpcodeIR op) {
+    return ir_insere_antes(bloco, NULL, op);
+}
+
+InstrucaoIR* ir_insere_fi(BlocoBasico* bloco, Operando destino) {
+    InstrucaoIR* ins = ir_insere_antes(bloco, bloco->primeira, IR_FI);
+    int n = bloco->num_predecessores;
+    ins->destino = destino;
+    ins->fontes = arena_alocar(&arena_ir, (n ? n : 1) * sizeof(Operando));
+    for (int p = 0; p < n; p++) ins->fontes[p] = ir_nenhum();
+    return ins;
+}
+
+InstrucaoIR* ir_copia(BlocoBasico* bloco, Operando destino, Operando a) {
+    InstrucaoIR* ins = ir_acrescenta(bloco, IR_COPIA);
+    ins->destino = destino;
+    ins->a = a;
+    return ins;
+}
+
+InstrucaoIR* ir_binario(BlocoBasico* bloco, OperadorIR operador, Operando destino, Operando a, Operando b) {
+    InstrucaoIR* ins = ir_acrescenta(bloco, IR_BINARIO);
+    ins->operador = operador;
+    ins->destino = destino;
+    ins->a = a;
+    ins->b = b;
+    return ins;
+}
+
+InstrucaoIR* ir_duplica(BlocoBasico* bloco, const InstrucaoIR* ins) {
+    InstrucaoIR* copia = ir_acrescenta(bloco, ins->op);
+    InstrucaoIR* anterior = copia->anterior;
+    *copia = *ins;
+    copia->anterior = anterior;
+    copia->proxima = NULL;
+    return copia;
+}
+
+void ir_remove_instrucao(BlocoBasico* bloco, InstrucaoIR* ins) {
+    if (ins->anterior) ins->anterior->proxima = ins->proxima;
+    else bloco->primeira = ins->proxima;
+    if (ins->proxima) ins->proxima->anterior = ins->anterior;
+    else bloco->ultima = ins->anterior;
+    ins->anterior = ins->proxima = NULL;
+}
+
+void ir_salto(BlocoBasico* bloco, BlocoBasico* destino) {
+    bloco->terminador = TERM_SALTO;
+    bloco->valor = bloco->valor2 = ir_nenhum();
+    bloco->sucessores[0] = destino;
+    bloco->sucessores[1] = NULL;
+}
+
+void ir_desvio(BlocoBasico* bloco, Operando condicao, BlocoBasico* se_verdadeiro, BlocoBasico* se_falso) {
+    ir_desvio_comparacao(bloco, OPR_DIFERENTE, condicao, ir_const(0), se_verdadeiro, se_falso);
+}
+
+void ir_desvio_comparacao(BlocoBasico* bloco, OperadorIR operador, Operando a, Operando b,
+                          BlocoBasico* se_verdadeiro, BlocoBasico* se_falso) {
+    int resultado = 1;
+    if ((a.tipo == OPERANDO_CONST && b.tipo == OPERANDO_CONST) || se_verdadeiro == se_falso) {
+        if (se_verdadeiro != se_falso) ir_calcula(operador, a.valor, b.valor, &resultado);
+        ir_salto(bloco, resultado ? se_verdadeiro : se_falso);
+        return;
+    }
+    bloco->terminador = TERM_DESVIO;
+    bloco->comparacao = operador;
+    bloco->valor = a;
+    bloco->valor2 = b;
+    bloco->sucessores[0] = se_verdadeiro;
+    bloco->sucessores[1] = se_falso;
+}
+
+void ir_retorno(BlocoBasico* bloco, Operando valor) {
+    bloco->terminador = TERM_RETORNO;
+    bloco->valor = valor;
+    bloco->valor2 = ir_nenhum();
+    bloco->sucessores[0] = bloco->sucessores[1] = NULL;
+}
+
+
+// --- Grafo de Fluxo de Controle ---
+
+static void acrescenta_predecessor(BlocoBasico* bloco, BlocoBasico* pred) {
+    if (bloco->num_predecessores == bloco->capacidade_predecessores) {
+        bloco->predecessores = cresce_vetor(bloco->predecessores, &bloco->capacidade_predecessores,
+                                            sizeof(BlocoBasico*));
+    }
+    bloco->predecessores[bloco->num_predecessores++] = pred;
+}
+
+// Marca os blocos alcançáveis a partir da entrada (busca em profundidade com pilha explícita).
+static void marca_alcancaveis(FuncaoIR* funcao, char* alcancado) {
+    BlocoBasico** pilha = malloc(funcao->num_blocos * sizeof(BlocoBasico*));
+    if (!pilha) {
+        fprintf(stderr, "Erro: Falha de alocação de memória no código intermediário.\n");
+        exit(1);
+    }
+    int topo = 0;
+    alcancado[0] = 1;
+    pilha[topo++] = funcao->blocos[0];
+    while (topo > 0) {
+        BlocoBasico* b = pilha[--topo];
+        for (int s = 0; s < 2; s++) {
+            BlocoBasico* suc = b->sucessores[s];
+            if (suc && !alcancado[suc->indice]) {
+                alcancado[suc->indice] = 1;
+                pilha[topo++] = suc;
+            }
+        }
+    }
+    free(pilha);
+}
+
+void ir_atualiza_grafo(FuncaoIR* funcao) {
+    if (funcao->num_blocos == 0) return;
+    char* alcancado = calloc(funcao->num_blocos, 1);
+    if (!alcancado) {
+        fprintf(stderr, "Erro: Falha de alocação de memória no código intermediário.\n");
+        exit(1);
+    }
+    marca_alcancaveis(funcao, alcancado);
+
+    // Compacta o vetor mantendo a ordem de disposição dos blocos que sobraram.
+    int n = 0;
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        if (!alcancado[i]) {
+            free(b->predecessores);
+            free(b->vivos_entrada);
+            free(b->vivos_saida);
+            continue;
+        }
+        b->indice = n;
+        b->num_predecessores = 0;
+        funcao->blocos[n++] = b;
+    }
+    funcao->num_blocos = n;
+    free(alcancado);
+
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        for (int s = 0; s < 2; s++) {
+            if (b->sucessores[s]) acrescenta_predecessor(b->sucessores[s], b);
+        }
+    }
+}
+
+void ir_divide_arestas_criticas(ProgramaIR* programa, FuncaoIR* funcao) {
+    int n = funcao->num_blocos, dividiu = 0;
+    for (int i = 0; i < n; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        if (b->terminador != TERM_DESVIO) continue;
+        for (int s = 0; s < 2; s++) {
+            BlocoBasico* suc = b->sucessores[s];
+            if (suc->num_predecessores < 2) continue;
+            // O bloco novo vai para o fim da função: assim nenhuma passagem direta entre os
+            // blocos existentes é desfeita.
+            BlocoBasico* meio = ir_novo_bloco(programa);
+            meio->profundidade_laco = b->profundidade_laco < suc->profundidade_laco
+                                      ? b->profundidade_laco : suc->profundidade_laco;
+            ir_salto(meio, suc);
+            ir_posiciona_bloco(funcao, meio, funcao->num_blocos);
+            b->sucessores[s] = meio;
+            dividiu = 1;
+        }
+    }
+    if (dividiu) ir_atualiza_grafo(funcao);
+}
+
+// Segue a cadeia de blocos vazios que só saltam adiante. O limite de passos encerra a busca
+// num laço feito só de blocos vazios (como 'enquanto (1) { }').
+static BlocoBasico* destino_final(FuncaoIR* funcao, BlocoBasico* b) {
+    for (int passos = 0; passos < funcao->num_blocos; passos++) {
+        if (b->primeira || b->terminador != TERM_SALTO || b == funcao->blocos[0]) break;
+        b = b->sucessores[0];
+    }
+    return b;
+}
+
+void ir_remove_blocos_vazios(FuncaoIR* funcao) {
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        for (int s = 0; s < 2; s++) {
+            if (b->sucessores[s]) b->sucessores[s] = destino_final(funcao, b->sucessores[s]);
+        }
+        if (b->terminador == TERM_DESVIO && b->sucessores[0] == b->sucessores[1]) {
+            ir_salto(b, b->sucessores[0]);
+        }
+    }
+    ir_atualiza_grafo(funcao);
+}
+
+
+// --- Dominadores ---
+
+// Sobe pela árvore de dominadores a partir dos dois blocos até se encontrarem.
+static BlocoBasico* intersecta(BlocoBasico* a, BlocoBasico* b) {
+    while (a != b) {
+        while (a->numero_pos_ordem < b->numero_pos_ordem) a = a->dominador;
+        while (b->numero_pos_ordem < a->numero_pos_ordem) b = b->dominador;
+    }
+    return a;
+}
+
+void ir_calcula_dominadores(FuncaoIR* funcao) {
+    int n = funcao->num_blocos;
+    if (n == 0) return;
+    BlocoBasico** pos_ordem = malloc(n * sizeof(BlocoBasico*));
+    BlocoBasico** pilha = malloc(n * sizeof(BlocoBasico*));
+    int* proximo = calloc(n, sizeof(int));     // Próximo sucessor a visitar (2 = terminado).
+    char* visitado = calloc(n, 1);
+    if (!pos_ordem || !pilha || !proximo || !visitado) {
+        fprintf(stderr, "Erro: Falha de alocação de memória no código intermediário.\n");
+        exit(1);
+    }
+
+    // Busca em profundidade com pilha explícita, numerando os blocos em pós-ordem.
+    int num = 0, topo = 0;
+    visitado[0] = 1;
+    pilha[topo++] = funcao->blocos[0];
+    while (topo > 0) {
+        BlocoBasico* b = pilha[topo - 1];
+        if (proximo[b->indice] < 2) {
+            BlocoBasico* suc = b->sucessores[proximo[b->indice]++];
+            if (suc && !visitado[suc->indice]) {
+                visitado[suc->indice] = 1;
+                pilha[topo++] = suc;
+            }
+        } else {
+            topo--;
+            b->numero_pos_ordem = num;
+            pos_ordem[num++] = b;
+        }
+    }
+
+    // Itera em pós-ordem reversa até o ponto fixo; a entrada é dominada só por ela mesma.
+    for (int i = 0; i < n; i++) funcao->blocos[i]->dominador = NULL;
+    funcao->blocos[0]->dominador = funcao->blocos[0];
+    int mudou = 1;
+    while (mudou) {
+        mudou = 0;
+        for (int k = num - 2; k >= 0; k--) {
+            BlocoBasico* b = pos_ordem[k];
+            BlocoBasico* novo = NULL;
+            for (int p = 0; p < b->num_predecessores; p++) {
+                BlocoBasico* pred = b->predecessores[p];
+                if (!pred->dominador) continue;
+                novo = novo ? intersecta(pred, novo) : pred;
+            }
+            if (novo != b->dominador) {
+                b->dominador = novo;
+                mudou = 1;
+            }
+        }
+    }
+    funcao->blocos[0]->dominador = NULL;
+    free(pos_ordem);
+    free(pilha);
+    free(proximo);
+    free(visitado);
+}
+
+int ir_domina(const BlocoBasico* a, const BlocoBasico* b) {
+    while (b && b != a) b = b->dominador;
+    return b == a;
+}
+
+
+// --- Vivacidade dos Temporários ---
+// Um temporário está vivo num ponto se algum caminho a partir dali o lê antes de reescrevê-lo.
+// Todas as instruções leem 'a' e 'b' e escrevem 'destino', e o terminador lê 'valor' e
+// 'valor2'. A forma SSA (com funções fi) é desfeita antes de a vivacidade ser calculada.
+
+#define BITS_PALAVRA (8 * (int)sizeof(unsigned int))
+
+int ir_palavras_conjunto(const FuncaoIR* funcao) {
+    return (funcao->num_temporarios + BITS_PALAVRA - 1) / BITS_PALAVRA;
+}
+
+int ir_pertence(const unsigned int* conjunto, int temp) {
+    return (conjunto[temp / BITS_PALAVRA] >> (temp % BITS_PALAVRA)) & 1u;
+}
+
+static void inclui(unsigned int* conjunto, Operando o) {
+    if (o.tipo == OPERANDO_TEMP) conjunto[o.valor / BITS_PALAVRA] |= 1u << (o.valor % BITS_PALAVRA);
+}
+
+static void exclui(unsigned int* conjunto, Operando o) {
+    if (o.tipo == OPERANDO_TEMP) conjunto[o.valor / BITS_PALAVRA] &= ~(1u << (o.valor % BITS_PALAVRA));
+}
+
+void ir_calcula_vivacidade(FuncaoIR* funcao) {
+    int palavras = ir_palavras_conjunto(funcao);
+    size_t bytes = (palavras ? palavras : 1) * sizeof(unsigned int);
+    unsigned int* vivos = malloc(bytes);
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        b->vivos_entrada = realloc(b->vivos_entrada, bytes);
+        b->vivos_saida = realloc(b->vivos_saida, bytes);
+        if (!vivos || !b->vivos_entrada || !b->vivos_saida) {
+            fprintf(stderr, "Erro: Falha de alocação de memória no código intermediário.\n");
+            exit(1);
+        }
+        memset(b->vivos_entrada, 0, bytes);
+        memset(b->vivos_saida, 0, bytes);
+    }
+
+    // Itera até o ponto fixo, visitando os blocos de trás para frente (o que costuma
+    // propagar a informação em poucas voltas).
+    int mudou = 1;
+    while (mudou) {
+        mudou = 0;
+        for (int i = funcao->num_blocos - 1; i >= 0; i--) {
+            BlocoBasico* b = funcao->blocos[i];
+            // Saída = união das entradas dos sucessores.
+            for (int s = 0; s < 2; s++) {
+                BlocoBasico* suc = b->sucessores[s];
+                if (!suc) continue;
+                for (int w = 0; w < palavras; w++) b->vivos_saida[w] |= suc->vivos_entrada[w];
+            }
+            // Entrada = (saída - escritos) + lidos, instrução por instrução, de trás para frente.
+            memcpy(vivos, b->vivos_saida, bytes);
+            inclui(vivos, b->valor);
+            inclui(vivos, b->valor2);
+            for (InstrucaoIR* ins = b->ultima; ins; ins = ins->anterior) {
+                exclui(vivos, ins->destino);
+                inclui(vivos, ins->a);
+                inclui(vivos, ins->b);
+            }
+            if (memcmp(vivos, b->vivos_entrada, bytes) != 0) {
+                memcpy(b->vivos_entrada, vivos, bytes);
+                mudou = 1;
+            }
+        }
+    }
+    free(vivos);
+}
+
+
+// --- Listagem ---
+
+static const char* texto_operador[NUM_OPERADORES_IR] = {
+    "+", "-", "*", "/", "==", "!=", "<", "<=", ">", ">=", "<<", ">>", ">>>", "+u", "-u"
+};
+
+static void imprime_operando(FILE* arquivo, Operando o) {
+    switch (o.tipo) {
+        case OPERANDO_TEMP:  fprintf(arquivo, "t%d", o.valor); break;
+        case OPERANDO_CONST: fprintf(arquivo, "%d", o.valor); break;
+        case OPERANDO_VAR:   fprintf(arquivo, "%s", texto_atomo(o.var->nome)); break;
+        case OPERANDO_NENHUM: break;
+    }
+}
+
+static void imprime_instrucao(FILE* arquivo, const ProgramaIR* programa, const BlocoBasico* bloco,
+                              const InstrucaoIR* ins) {
+    fprintf(arquivo, "    ");
+    if (ins->destino.tipo != OPERANDO_NENHUM && ins->op != IR_LEIA) {
+        imprime_operando(arquivo, ins->destino);
+        fprintf(arquivo, " = ");
+    }
+    switch (ins->op) {
+        case IR_COPIA:
+            imprime_operando(arquivo, ins->a);
+            break;
+        case IR_BINARIO:
+            imprime_operando(arquivo, ins->a);
+            fprintf(arquivo, " %s ", texto_operador[ins->operador]);
+            imprime_operando(arquivo, ins->b);
+            break;
+        case IR_ARGUMENTO:
+            fprintf(arquivo, "argumento %d, ", ins->posicao);
+            imprime_operando(arquivo, ins->a);
+            break;
+        case IR_CHAMADA:
+            fprintf(arquivo, "chame %s, %d", texto_atomo(ins->funcao->nome), ins->num_args);
+            break;
+        case IR_LEIA:
+            fprintf(arquivo, "leia ");
+            imprime_operando(arquivo, ins->destino);
+            break;
+        case IR_ESCREVA:
+            fprintf(arquivo, ins->tipo == TIPO_CAR ? "escreva car " : "escreva ");
+            imprime_operando(arquivo, ins->a);
+            break;
+        case IR_ESCREVA_CADEIA:
+            fprintf(arquivo, "escreva %s", texto_atomo(programa->cadeias[ins->cadeia]));
+            break;
+        case IR_NOVALINHA:
+            fprintf(arquivo, "novalinha");
+            break;
+        case IR_FI:
+            fprintf(arquivo, "fi(");
+            for (int p = 0; p < bloco->num_predecessores; p++) {
+                if (p > 0) fprintf(arquivo, ", ");
+                imprime_operando(arquivo, ins->fontes[p]);
+            }
+            fprintf(arquivo, ")");
+            break;
+    }
+    fprintf(arquivo, "\n");
+}
+
+static void imprime_bloco(FILE* arquivo, const ProgramaIR* programa, const BlocoBasico* b) {
+    fprintf(arquivo, "B%d:", b->id);
+    if (b->num_predecessores > 0) {
+        fprintf(arquivo, "%*s; predecessores:", b->id < 10 ? 6 : 5, "");
+        for (int p = 0; p < b->num_predecessores; p++) fprintf(arquivo, " B%d", b->predecessores[p]->id);
+    }
+    if (b->profundidade_laco > 0) fprintf(arquivo, "  (laço %d)", b->profundidade_laco);
+    fprintf(arquivo, "\n");
+
+    for (const InstrucaoIR* ins = b->primeira; ins; ins = ins->proxima) {
+        imprime_instrucao(arquivo, programa, b, ins);
+    }
+    switch (b->terminador) {
+        case TERM_SALTO:
+            fprintf(arquivo, "    vá para B%d\n", b->sucessores[0]->id);
+            break;
+        case TERM_DESVIO:
+            fprintf(arquivo, "    se ");
+            imprime_operando(arquivo, b->valor);
+            if (b->comparacao != OPR_DIFERENTE || b->valor2.tipo != OPERANDO_CONST || b->valor2.valor != 0) {
+                fprintf(arquivo, " %s ", texto_operador[b->comparacao]);
+                imprime_operando(arquivo, b->valor2);
+            }
+            fprintf(arquivo, " vá para B%d senão B%d\n", b->sucessores[0]->id, b->sucessores[1]->id);
+            break;
+        case TERM_RETORNO:
+            fprintf(arquivo, "    retorne ");
+            imprime_operando(arquivo, b->valor);
+            fprintf(arquivo, "\n");
+            break;
+        case TERM_ABERTO:
+            fprintf(arquivo, "    (bloco sem terminador)\n");
+            break;
+    }
+}
+
+void ir_imprime(const ProgramaIR* programa, FILE* arquivo) {
+    for (int f = 0; f < programa->num_funcoes; f++) {
+        const FuncaoIR* funcao = programa->funcoes[f];
+        if (funcao->vinculo) {
+            fprintf(arquivo, "funcao %s(", funcao->nome);
+            int primeiro = 1;
+            for (No* p = funcao->vinculo->params; p; p = p->proximo) {
+                fprintf(arquivo, "%s%s", primeiro ? "" : ", ", texto_atomo(p->vinculo->nome));
+                primeiro = 0;
+            }
+            fprintf(arquivo, ")");
+        } else {
+            fprintf(arquivo, "programa");
+        }
+        fprintf(arquivo, "  ; %d bloco(s), %d temporário(s)\n", funcao->num_blocos, funcao->num_temporarios);
+        for (int i = 0; i < funcao->num_blocos; i++) {
+            imprime_bloco(arquivo, programa, funcao->blocos[i]);
+        }
+        fprintf(arquivo, "\n");
+    }
+}
+
+static void libera_funcao(FuncaoIR* funcao) {
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        free(funcao->blocos[i]->predecessores);
+        free(funcao->blocos[i]->vivos_entrada);
+        free(funcao->blocos[i]->vivos_saida);
+    }
+    free(funcao->blocos);
+    free(funcao->variaveis);
+}
+
+void ir_remove_funcao(ProgramaIR* programa, FuncaoIR* funcao) {
+    int f = 0;
+    while (f < programa->num_funcoes && programa->funcoes[f] != funcao) f++;
+    if (f == programa->num_funcoes) return;
+    memmove(&programa->funcoes[f], &programa->funcoes[f + 1],
+            (programa->num_funcoes - f - 1) * sizeof(FuncaoIR*));
+    programa->num_funcoes--;
+    libera_funcao(funcao);
+}
+
+void ir_liberar(ProgramaIR* programa) {
+    for (int f = 0; f < programa->num_funcoes; f++) libera_funcao(programa->funcoes[f]);
+    free(programa->funcoes);
+    free(programa->cadeias);
+    free(programa->globais);
+    arena_liberar(&arena_ir);
+}
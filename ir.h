@@ -0,0 +1,210 @@
+#ifndef IR_H
+#define IR_H
+
+#include <stdio.h>      // Para o tipo FILE.
+#include "arvore.h"
+
+struct Vinculo;
+
+// --- Código Intermediário de Três Endereços ---
+// Entre a árvore e o MIPS, cada função (e o bloco principal) é traduzida para uma sequência
+// de instruções simples, do tipo "t3 = t1 + x", agrupadas em blocos básicos: trechos sem
+// desvios no meio, que só podem ser alcançados pelo início. O último comando de cada bloco
+// (o terminador) diz para onde o controle vai depois dele, formando o grafo de fluxo de
+// controle da função. As otimizações independentes de máquina trabalham sobre esta forma,
+// e a geração de código MIPS só precisa conhecer as poucas instruções abaixo.
+
+// Um operando é um temporário (valor intermediário, numerado dentro da função), uma constante
+// ou uma variável do programa (lida ou escrita onde quer que ela esteja guardada).
+typedef enum {
+    OPERANDO_NENHUM,
+    OPERANDO_TEMP,
+    OPERANDO_CONST,
+    OPERANDO_VAR
+} TipoOperando;
+
+typedef struct Operando {
+    TipoOperando tipo;
+    int valor;                  // Número do temporário ou valor da constante.
+    struct Vinculo* var;        // OPERANDO_VAR: a variável.
+} Operando;
+
+// Operadores das instruções binárias. 'e' e 'ou' não aparecem: viram desvios (ver
+// geracao_ir.c); a negação '!x' é traduzida como "x == 0". Os deslocamentos não existem na
+// linguagem: são introduzidos pela redução de força (ver reducao.c), sempre com 'b' constante.
+// A soma e a subtração modulares também só vêm das otimizações: elas não param o programa
+// quando o resultado transborda, como a multiplicação que substituem (um valor intermediário
+// pode transbordar mesmo quando o produto cabe em 32 bits).
+typedef enum {
+    OPR_SOMA, OPR_SUBTRACAO, OPR_MULTIPLICACAO, OPR_DIVISAO,
+    OPR_IGUAL, OPR_DIFERENTE, OPR_MENOR, OPR_MENOR_IGUAL, OPR_MAIOR, OPR_MAIOR_IGUAL,
+    OPR_DESLOCA_ESQUERDA,       // a << b
+    OPR_DESLOCA_DIREITA,        // a >> b, repetindo o bit de sinal (aritmético)
+    OPR_DESLOCA_DIREITA_LOGICO, // a >> b, entrando zeros
+    OPR_SOMA_MODULAR,           // a + b, módulo 2^32
+    OPR_SUBTRACAO_MODULAR,      // a - b, módulo 2^32
+    NUM_OPERADORES_IR
+} OperadorIR;
+
+typedef enum {
+    IR_COPIA,           // destino = a
+    IR_BINARIO,         // destino = a operador b
+    IR_ARGUMENTO,       // passa a como o argumento 'posicao' da chamada seguinte (do último ao primeiro)
+    IR_CHAMADA,         // destino = funcao(argumentos passados) (destino pode ser nenhum)
+    IR_LEIA,            // destino (uma variável) = inteiro lido da entrada
+    IR_ESCREVA,         // escreve a (como inteiro ou caractere, conforme 'tipo')
+    IR_ESCREVA_CADEIA,  // escreve a cadeia de número 'cadeia' do programa
+    IR_NOVALINHA,       // escreve '\n'
+    IR_FI               // destino = fontes[i] se o controle veio de predecessores[i] (só na forma SSA)
+} OpcodeIR;
+
+typedef struct InstrucaoIR {
+    OpcodeIR op;
+    OperadorIR operador;        // IR_BINARIO.
+    Operando destino, a, b;
+    struct Vinculo* funcao;     // IR_CHAMADA: a função chamada.
+    int num_args;               // IR_CHAMADA: quantos argumentos foram passados para ela.
+    int posicao;                // IR_ARGUMENTO: posição do argumento (0 = o primeiro).
+    TipoDado tipo;              // IR_ESCREVA: tipo do valor escrito.
+    int cadeia;                 // IR_ESCREVA_CADEIA: índice em ProgramaIR.cadeias.
+    Operando* fontes;           // IR_FI: um operando por predecessor do bloco ('a' guarda a variável
+                                // de origem enquanto o SSA é construído).
+    int numero;                 // Posição na ordem linear da função (calculada pela alocação).
+    struct InstrucaoIR* anterior;
+    struct InstrucaoIR* proxima;
+} InstrucaoIR;
+
+typedef enum {
+    TERM_ABERTO,        // Bloco ainda em construção.
+    TERM_SALTO,         // Vai para sucessores[0].
+    TERM_DESVIO,        // Se "valor comparacao valor2" vale vai para sucessores[0], senão para sucessores[1].
+    TERM_RETORNO        // Sai da função (devolvendo 'valor', se houver).
+} TipoTerminador;
+
+typedef struct BlocoBasico {
+    int id;                     // Número único no programa (usado nos rótulos e na listagem).
+    int indice;                 // Posição no vetor de blocos da função.
+    InstrucaoIR* primeira;
+    InstrucaoIR* ultima;
+    TipoTerminador terminador;
+    Operando valor;             // Primeiro operando da comparação do desvio ou valor retornado.
+    OperadorIR comparacao;      // TERM_DESVIO: um operador relacional.
+    Operando valor2;            // TERM_DESVIO: segundo operando da comparação.
+    int numero_terminador;      // Posição do terminador na ordem linear (calculada pela alocação).
+    struct BlocoBasico* sucessores[2];
+    struct BlocoBasico** predecessores;
+    int num_predecessores;
+    int capacidade_predecessores;
+    int profundidade_laco;      // Quantos 'enquanto' envolvem o bloco.
+    struct BlocoBasico* dominador; // Dominador imediato (ver ir_calcula_dominadores).
+    int numero_pos_ordem;       // Posição numa busca em profundidade, em pós-ordem.
+    unsigned int* vivos_entrada; // Temporários vivos na entrada/saída (ver ir_calcula_vivacidade).
+    unsigned int* vivos_saida;
+} BlocoBasico;
+
+typedef struct FuncaoIR {
+    struct Vinculo* vinculo;    // A função (NULL no bloco principal).
+    const char* nome;           // Texto usado nos rótulos.
+    BlocoBasico** blocos;       // Em ordem de disposição no código; blocos[0] é a entrada.
+    int num_blocos;
+    int capacidade_blocos;
+    int num_temporarios;
+    struct Vinculo** variaveis; // Parâmetros e variáveis declaradas no corpo (invisíveis fora dele).
+    int num_variaveis;
+    int capacidade_variaveis;
+    int num_criadas;            // Quantas das últimas variáveis foram criadas por ir_nova_variavel.
+} FuncaoIR;
+
+typedef struct ProgramaIR {
+    FuncaoIR** funcoes;         // Funções na ordem do programa; o bloco principal é a última.
+    int num_funcoes;
+    int capacidade_funcoes;
+    FuncaoIR* principal;
+    Atomo* cadeias;             // Cadeias escritas por 'escreva' (com as aspas), sem repetição.
+    int num_cadeias;
+    int capacidade_cadeias;
+    struct Vinculo** globais;   // Variáveis declaradas fora das funções, na ordem do programa
+    int num_globais;            // (as do bloco principal estão em principal->variaveis).
+    int capacidade_globais;
+    int num_blocos;             // Contador para os ids dos blocos.
+} ProgramaIR;
+
+// --- Construção ---
+ProgramaIR* ir_novo_programa(void);
+FuncaoIR* ir_nova_funcao(ProgramaIR* programa, struct Vinculo* vinculo, const char* nome);
+// Um bloco novo ainda não faz parte da função: ir_posiciona_bloco o coloca na ordem de disposição
+// (na posição 'posicao'; funcao->num_blocos = no fim). Assim o bloco pode ser alvo de desvios
+// antes de ocupar seu lugar no código.
+BlocoBasico* ir_novo_bloco(ProgramaIR* programa);
+void ir_posiciona_bloco(FuncaoIR* funcao, BlocoBasico* bloco, int posicao);
+void ir_acrescenta_variavel(FuncaoIR* funcao, struct Vinculo* v);
+// Cria uma variável nova da função, com o tipo de 'modelo' (ao copiar o corpo de outra função
+// para dentro dela): uma local a mais no quadro ou, no bloco principal, uma global.
+struct Vinculo* ir_nova_variavel(FuncaoIR* funcao, const struct Vinculo* modelo, Atomo nome);
+void ir_acrescenta_global(ProgramaIR* programa, struct Vinculo* v);
+// Tira a função do programa (quando ninguém mais a chama) e devolve a memória dela.
+void ir_remove_funcao(ProgramaIR* programa, FuncaoIR* funcao);
+int ir_indice_cadeia(ProgramaIR* programa, Atomo cadeia);
+
+Operando ir_nenhum(void);
+Operando ir_const(int valor);
+Operando ir_var(struct Vinculo* v);
+Operando ir_novo_temp(FuncaoIR* funcao);
+
+// Calcula "x operador y" como o MIPS calcularia. Devolve 0 (sem calcular) nas divisões que
+// dariam erro, que ficam para a execução.
+int ir_calcula(OperadorIR operador, int x, int y, int* resultado);
+// Operador relacional que dá o resultado oposto ('<' -> '>=') e o que dá o mesmo resultado
+// com os operandos trocados ('<' -> '>').
+OperadorIR ir_nega_comparacao(OperadorIR operador);
+OperadorIR ir_espelha_comparacao(OperadorIR operador);
+
+// Acrescenta uma instrução ao fim do bloco e a devolve para que os campos sejam preenchidos.
+InstrucaoIR* ir_acrescenta(BlocoBasico* bloco, OpcodeIR op);
+// Insere uma instrução antes de 'posicao' (NULL = no fim do bloco).
+InstrucaoIR* ir_insere_antes(BlocoBasico* bloco, InstrucaoIR* posicao, OpcodeIR op);
+// Insere no início do bloco uma função fi com um operando (ainda vazio) por predecessor.
+InstrucaoIR* ir_insere_fi(BlocoBasico* bloco, Operando destino);
+InstrucaoIR* ir_copia(BlocoBasico* bloco, Operando destino, Operando a);
+InstrucaoIR* ir_binario(BlocoBasico* bloco, OperadorIR operador, Operando destino, Operando a, Operando b);
+// Acrescenta ao fim do bloco uma cópia da instrução, com os mesmos operandos (não vale para fi).
+InstrucaoIR* ir_duplica(BlocoBasico* bloco, const InstrucaoIR* ins);
+void ir_remove_instrucao(BlocoBasico* bloco, InstrucaoIR* ins);
+
+// Terminadores. Um desvio com condição constante (ou com os dois destinos iguais) vira um salto.
+// ir_desvio testa "condicao != 0"; ir_desvio_comparacao testa "a operador b" (operador relacional).
+void ir_salto(BlocoBasico* bloco, BlocoBasico* destino);
+void ir_desvio(BlocoBasico* bloco, Operando condicao, BlocoBasico* se_verdadeiro, BlocoBasico* se_falso);
+void ir_desvio_comparacao(BlocoBasico* bloco, OperadorIR operador, Operando a, Operando b,
+                          BlocoBasico* se_verdadeiro, BlocoBasico* se_falso);
+void ir_retorno(BlocoBasico* bloco, Operando valor);
+
+// --- Grafo de Fluxo de Controle ---
+// Remove os blocos que não podem ser alcançados a partir da entrada e refaz as listas de
+// predecessores (chamar depois de qualquer mudança nos terminadores).
+void ir_atualiza_grafo(FuncaoIR* funcao);
+
+// Coloca um bloco vazio em cada aresta crítica (de um bloco com dois sucessores para um com
+// vários predecessores), para que haja sempre um lugar só daquela aresta onde pôr código.
+void ir_divide_arestas_criticas(ProgramaIR* programa, FuncaoIR* funcao);
+// Desvia os saltos que passam por blocos vazios direto para o destino final e remove os blocos
+// que deixaram de ser alcançados.
+void ir_remove_blocos_vazios(FuncaoIR* funcao);
+
+// Calcula o dominador imediato de cada bloco (Cooper, Harvey e Kennedy): 'a' domina 'b' se
+// todo caminho da entrada até 'b' passa por 'a'. Exige as listas de predecessores em dia.
+void ir_calcula_dominadores(FuncaoIR* funcao);
+int ir_domina(const BlocoBasico* a, const BlocoBasico* b);
+
+// Calcula, para cada bloco, os temporários vivos na entrada e na saída (análise de fluxo de
+// dados iterativa, de trás para frente). Os conjuntos são vetores de bits com
+// ir_palavras_conjunto(funcao) palavras.
+void ir_calcula_vivacidade(FuncaoIR* funcao);
+int ir_palavras_conjunto(const FuncaoIR* funcao);
+int ir_pertence(const unsigned int* conjunto, int temp);
+
+// --- Listagem e Liberação ---
+void ir_imprime(const ProgramaIR* programa, FILE* arquivo);
+void ir_liberar(ProgramaIR* programa);
+
+#endif // IR_H
@@ -0,0 +1,628 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lacos.h"
+#include "tabela_simbolos.h"
+
+#define LIMITE_ROTACAO 16       // Máximo de instruções do teste copiado para o fim do laço.
+#define LIMITE_VOLTAS 8         // Máximo de voltas de um laço desenrolado.
+#define LIMITE_DESENROLADO 64   // Máximo de instruções do corpo depois de desenrolado.
+
+static EstatisticasLacos estatisticas;
+
+// A função sendo transformada e o programa dono dela (para criar blocos).
+static ProgramaIR* programa;
+static FuncaoIR* funcao;
+
+static void* aloca_zerado(int n, size_t tamanho) {
+    void* v = calloc(n ? n : 1, tamanho);
+    if (!v) {
+        fprintf(stderr, "Erro: Falha de alocação de memória na otimização de laços.\n");
+        exit(1);
+    }
+    return v;
+}
+
+
+// --- Laços Naturais ---
+// Uma aresta b -> h em que h domina b é uma aresta de volta, e h é o cabeçalho de um laço.
+// O laço é formado por h e pelos blocos que chegam a alguma dessas arestas sem passar por h.
+
+typedef struct Laco {
+    BlocoBasico* cabecalho;
+    BlocoBasico* pre_cabecalho; // Único bloco de fora que entra no laço (e só vai para ele).
+    char* no_laco;              // Por índice de bloco: 1 se o bloco é do laço.
+    int num_blocos;
+} Laco;
+
+static Laco* lacos;
+static int num_lacos;
+
+// Marca em 'no_laco' (por índice) os blocos do laço de cabeçalho 'h' e devolve quantos são
+// (0 se 'h' não for cabeçalho de um laço).
+static int marca_laco(BlocoBasico* h, char* no_laco) {
+    memset(no_laco, 0, funcao->num_blocos);
+    BlocoBasico** pilha = aloca_zerado(funcao->num_blocos, sizeof(BlocoBasico*));
+    int topo = 0, n = 0;
+    for (int p = 0; p < h->num_predecessores; p++) {
+        BlocoBasico* b = h->predecessores[p];
+        if (!ir_domina(h, b)) continue;
+        if (n == 0) {
+            no_laco[h->indice] = 1;
+            n = 1;
+        }
+        if (!no_laco[b->indice]) {
+            no_laco[b->indice] = 1;
+            n++;
+            pilha[topo++] = b;
+        }
+    }
+    while (topo > 0) {
+        BlocoBasico* b = pilha[--topo];
+        for (int p = 0; p < b->num_predecessores; p++) {
+            BlocoBasico* pred = b->predecessores[p];
+            if (no_laco[pred->indice]) continue;
+            no_laco[pred->indice] = 1;
+            n++;
+            pilha[topo++] = pred;
+        }
+    }
+    free(pilha);
+    return n;
+}
+
+// Indica se algum temporário escrito no bloco é lido em outro bloco.
+static int temporario_lido_fora(const BlocoBasico* bloco) {
+    char* escrito = aloca_zerado(funcao->num_temporarios, 1);
+    int lido = 0;
+    for (const InstrucaoIR* ins = bloco->primeira; ins; ins = ins->proxima) {
+        if (ins->destino.tipo == OPERANDO_TEMP) escrito[ins->destino.valor] = 1;
+    }
+#define LIDO(o) ((o).tipo == OPERANDO_TEMP && escrito[(o).valor])
+    for (int i = 0; i < funcao->num_blocos && !lido; i++) {
+        const BlocoBasico* b = funcao->blocos[i];
+        if (b == bloco) continue;
+        for (const InstrucaoIR* ins = b->primeira; ins && !lido; ins = ins->proxima) {
+            lido = LIDO(ins->a) || LIDO(ins->b);
+        }
+        lido = lido || LIDO(b->valor) || LIDO(b->valor2);
+    }
+#undef LIDO
+    free(escrito);
+    return lido;
+}
+
+// Cópias de instruções. Cada temporário escrito por uma cópia ganha um nome novo, e as leituras
+// seguintes usam esse nome: 'novo_nome' guarda, por temporário, o nome da cópia mais recente.
+static int* novo_nome;
+static int num_nomes;
+
+static void inicia_nomes(void) {
+    num_nomes = funcao->num_temporarios;
+    novo_nome = aloca_zerado(num_nomes, sizeof(int));
+    for (int t = 0; t < num_nomes; t++) novo_nome[t] = -1;
+}
+
+static Operando renomeado(Operando o) {
+    if (o.tipo == OPERANDO_TEMP && o.valor < num_nomes && novo_nome[o.valor] >= 0) o.valor = novo_nome[o.valor];
+    return o;
+}
+
+// Acrescenta ao fim de 'destino' cópias das instruções de 'primeira' até 'ultima'.
+static void copia_instrucoes(BlocoBasico* destino, const InstrucaoIR* primeira, const InstrucaoIR* ultima) {
+    for (const InstrucaoIR* ins = primeira; ins; ins = ins->proxima) {
+        InstrucaoIR* copia = ir_duplica(destino, ins);
+        copia->a = renomeado(copia->a);
+        copia->b = renomeado(copia->b);
+        if (copia->destino.tipo == OPERANDO_TEMP) {
+            Operando novo = ir_novo_temp(funcao);
+            novo_nome[copia->destino.valor] = novo.valor;
+            copia->destino = novo;
+        }
+        if (ins == ultima) break;
+    }
+}
+
+
+// --- Rotação ---
+// O 'enquanto' é gerado com o teste no início: cada volta executa o teste, o desvio para fora
+// e, no fim do corpo, um salto de volta. Com uma cópia do teste no fim do corpo, que desvia
+// de volta para o corpo, a volta custa um desvio só; o teste original passa a ser executado
+// uma vez, na entrada.
+
+static int rotaciona(BlocoBasico* h, char* no_laco) {
+    if (h->terminador != TERM_DESVIO || h == funcao->blocos[0] || !marca_laco(h, no_laco)) return 0;
+    if (no_laco[h->sucessores[0]->indice] == no_laco[h->sucessores[1]->indice]) return 0; // Não é a saída.
+    int n = 0;
+    for (InstrucaoIR* ins = h->primeira; ins; ins = ins->proxima) n++;
+    if (n > LIMITE_ROTACAO) return 0;
+    for (int p = 0; p < h->num_predecessores; p++) {
+        BlocoBasico* b = h->predecessores[p];
+        if (ir_domina(h, b) && (b == h || b->terminador != TERM_SALTO)) return 0;
+    }
+    if (temporario_lido_fora(h)) return 0;
+
+    inicia_nomes();
+    for (int p = 0; p < h->num_predecessores; p++) {
+        BlocoBasico* b = h->predecessores[p];
+        if (!ir_domina(h, b)) continue;
+        if (h->primeira) copia_instrucoes(b, h->primeira, h->ultima);
+        ir_desvio_comparacao(b, h->comparacao, renomeado(h->valor), renomeado(h->valor2),
+                             h->sucessores[0], h->sucessores[1]);
+    }
+    free(novo_nome);
+    if (h->profundidade_laco > 0) h->profundidade_laco--;
+    estatisticas.lacos_rodados++;
+    return 1;
+}
+
+// Cada rotação muda o grafo, então ele (e os dominadores) é refeito antes da próxima. Um laço
+// rodado não roda de novo: o fim do corpo já termina num desvio.
+static void rotaciona_lacos(void) {
+    int rodou = 1;
+    while (rodou) {
+        rodou = 0;
+        ir_calcula_dominadores(funcao);
+        char* no_laco = aloca_zerado(funcao->num_blocos, 1);
+        for (int i = 0; i < funcao->num_blocos && !rodou; i++) rodou = rotaciona(funcao->blocos[i], no_laco);
+        free(no_laco);
+        if (rodou) ir_atualiza_grafo(funcao);
+    }
+}
+
+
+// --- Pré-cabeçalhos ---
+// O que sai de um laço vai para um bloco que só o precede: as arestas que entram no laço
+// passam a ir para esse bloco, posto logo antes do cabeçalho. Um bloco de fora que é a única
+// entrada e só salta para o cabeçalho já serve.
+
+static BlocoBasico* pre_cabecalho_existente(BlocoBasico* h) {
+    BlocoBasico* unico = NULL;
+    for (int p = 0; p < h->num_predecessores; p++) {
+        BlocoBasico* b = h->predecessores[p];
+        if (ir_domina(h, b)) continue;
+        if (unico) return NULL;
+        unico = b;
+    }
+    return unico && unico->terminador == TERM_SALTO ? unico : NULL;
+}
+
+static void cria_pre_cabecalho(BlocoBasico* h) {
+    BlocoBasico* pre = ir_novo_bloco(programa);
+    pre->profundidade_laco = h->profundidade_laco > 0 ? h->profundidade_laco - 1 : 0;
+    for (int p = 0; p < h->num_predecessores; p++) {
+        BlocoBasico* b = h->predecessores[p];
+        if (ir_domina(h, b)) continue;
+        for (int s = 0; s < 2; s++) {
+            if (b->sucessores[s] == h) b->sucessores[s] = pre;
+        }
+    }
+    ir_salto(pre, h);
+    ir_posiciona_bloco(funcao, pre, h->indice);
+}
+
+static int compara_tamanho(const void* x, const void* y) {
+    return ((const Laco*)x)->num_blocos - ((const Laco*)y)->num_blocos;
+}
+
+// Garante um pré-cabeçalho para cada laço e monta a lista de laços, dos internos (menores)
+// para os externos, para que o código movido de um laço interno ainda possa sair do externo.
+static void encontra_lacos(void) {
+    int criou = 1;
+    while (criou) {
+        criou = 0;
+        ir_calcula_dominadores(funcao);
+        char* no_laco = aloca_zerado(funcao->num_blocos, 1);
+        for (int i = 0; i < funcao->num_blocos && !criou; i++) {
+            BlocoBasico* h = funcao->blocos[i];
+            if (h == funcao->blocos[0] || !marca_laco(h, no_laco) || pre_cabecalho_existente(h)) continue;
+            cria_pre_cabecalho(h);
+            criou = 1;
+        }
+        free(no_laco);
+        if (criou) ir_atualiza_grafo(funcao);
+    }
+
+    lacos = aloca_zerado(funcao->num_blocos, sizeof(Laco));
+    num_lacos = 0;
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* h = funcao->blocos[i];
+        if (h == funcao->blocos[0]) continue;
+        Laco* laco = &lacos[num_lacos];
+        laco->no_laco = aloca_zerado(funcao->num_blocos, 1);
+        laco->num_blocos = marca_laco(h, laco->no_laco);
+        if (laco->num_blocos == 0) {
+            free(laco->no_laco);
+            continue;
+        }
+        laco->cabecalho = h;
+        laco->pre_cabecalho = pre_cabecalho_existente(h);
+        num_lacos++;
+    }
+    qsort(lacos, num_lacos, sizeof(Laco), compara_tamanho);
+}
+
+static void libera_lacos(void) {
+    for (int l = 0; l < num_lacos; l++) free(lacos[l].no_laco);
+    free(lacos);
+    lacos = NULL;
+    num_lacos = 0;
+}
+
+
+// Variáveis da função (parâmetros e variáveis do corpo, ou as do bloco principal): nenhuma
+// outra função as enxerga. As demais são globais e podem ser escritas por qualquer chamada.
+static int eh_local(const Vinculo* v) {
+    for (int k = 0; k < funcao->num_variaveis; k++) {
+        if (funcao->variaveis[k] == v) return 1;
+    }
+    return 0;
+}
+
+
+// --- Movimento de Código Invariante ---
+// Um operando é invariante no laço se é constante, se é um temporário que o laço não escreve
+// ou se é uma variável que o laço não escreve. Chamadas podem escrever as variáveis globais,
+// mas não as locais. Um cálculo com operandos invariantes, que não pode falhar (divisão por
+// um valor desconhecido pode ser por zero) e cujo resultado vai para um temporário escrito só
+// ali, dá o mesmo resultado em toda volta e pode ser feito uma vez, no pré-cabeçalho.
+
+static int* definicoes;         // Por temporário: quantas instruções da função o escrevem.
+static char* definido_no_laco;  // Por temporário: 1 se uma instrução do laço o escreve.
+static int num_temporarios_contados;
+static Vinculo** escritas;      // Variáveis escritas no laço.
+static int num_escritas;
+static int tem_chamada;
+
+static int escrita_no_laco(const Vinculo* v) {
+    for (int k = 0; k < num_escritas; k++) {
+        if (escritas[k] == v) return 1;
+    }
+    return 0;
+}
+
+static int invariante(Operando o) {
+    switch (o.tipo) {
+        case OPERANDO_TEMP:
+            return o.valor >= num_temporarios_contados || !definido_no_laco[o.valor];
+        case OPERANDO_VAR:
+            return !escrita_no_laco(o.var) && (!tem_chamada || eh_local(o.var));
+        default:
+            return 1;
+    }
+}
+
+static int pode_mover(const InstrucaoIR* ins) {
+    if (ins->destino.tipo != OPERANDO_TEMP || ins->destino.valor >= num_temporarios_contados
+        || definicoes[ins->destino.valor] != 1) {
+        return 0;
+    }
+    if (ins->op == IR_COPIA) return invariante(ins->a);
+    if (ins->op != IR_BINARIO || !invariante(ins->a) || !invariante(ins->b)) return 0;
+    return ins->operador != OPR_DIVISAO || (ins->b.tipo == OPERANDO_CONST && ins->b.valor != 0);
+}
+
+// Levantamento do que o laço escreve e se ele chama funções. As definições são contadas de
+// novo a cada laço: os temporários criados para um laço interno estão dentro do externo.
+static void examina_laco(const Laco* laco) {
+    num_temporarios_contados = funcao->num_temporarios;
+    definicoes = aloca_zerado(num_temporarios_contados, sizeof(int));
+    definido_no_laco = aloca_zerado(num_temporarios_contados, 1);
+    num_escritas = 0;
+    tem_chamada = 0;
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        for (const InstrucaoIR* ins = funcao->blocos[i]->primeira; ins; ins = ins->proxima) {
+            if (ins->destino.tipo == OPERANDO_TEMP) definicoes[ins->destino.valor]++;
+            if (!laco->no_laco[i]) continue;
+            if (ins->op == IR_CHAMADA) tem_chamada = 1;
+            if (ins->destino.tipo == OPERANDO_TEMP) {
+                definido_no_laco[ins->destino.valor] = 1;
+            } else if (ins->destino.tipo == OPERANDO_VAR && !escrita_no_laco(ins->destino.var)) {
+                escritas[num_escritas++] = ins->destino.var;
+            }
+        }
+    }
+}
+
+// Troca as leituras de uma variável global invariante por um temporário carregado uma vez
+// no pré-cabeçalho.
+static Vinculo** globais_lidas;
+static Operando* temporario_da_global;
+static int num_globais_lidas;
+
+static Operando leitura_movida(const Laco* laco, Operando o) {
+    if (o.tipo != OPERANDO_VAR || eh_local(o.var) || !invariante(o)) return o;
+    for (int k = 0; k < num_globais_lidas; k++) {
+        if (globais_lidas[k] == o.var) return temporario_da_global[k];
+    }
+    Operando t = ir_novo_temp(funcao);
+    ir_copia(laco->pre_cabecalho, t, o);
+    globais_lidas[num_globais_lidas] = o.var;
+    temporario_da_global[num_globais_lidas++] = t;
+    estatisticas.leituras_globais_movidas++;
+    return t;
+}
+
+static void move_invariantes(const Laco* laco) {
+    examina_laco(laco);
+    num_globais_lidas = 0;
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        if (!laco->no_laco[i]) continue;
+        BlocoBasico* b = funcao->blocos[i];
+        for (InstrucaoIR* ins = b->primeira; ins; ins = ins->proxima) {
+            ins->a = leitura_movida(laco, ins->a);
+            ins->b = leitura_movida(laco, ins->b);
+        }
+        b->valor = leitura_movida(laco, b->valor);
+        b->valor2 = leitura_movida(laco, b->valor2);
+    }
+
+    // Um cálculo movido torna invariante o seu resultado, o que pode liberar outros: repete
+    // até nada mais sair. A ordem no pré-cabeçalho é a ordem em que saem, que respeita as
+    // dependências.
+    int moveu = 1;
+    while (moveu) {
+        moveu = 0;
+        for (int i = 0; i < funcao->num_blocos; i++) {
+            if (!laco->no_laco[i]) continue;
+            BlocoBasico* b = funcao->blocos[i];
+            InstrucaoIR* proxima;
+            for (InstrucaoIR* ins = b->primeira; ins; ins = proxima) {
+                proxima = ins->proxima;
+                if (!pode_mover(ins)) continue;
+                ir_duplica(laco->pre_cabecalho, ins);
+                ir_remove_instrucao(b, ins);
+                definido_no_laco[ins->destino.valor] = 0;
+                estatisticas.expressoes_movidas++;
+                moveu = 1;
+            }
+        }
+    }
+    free(definicoes);
+    free(definido_no_laco);
+}
+
+static void move_invariantes_dos_lacos(void) {
+    int num_instrucoes = 0;
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        for (const InstrucaoIR* ins = funcao->blocos[i]->primeira; ins; ins = ins->proxima) num_instrucoes++;
+    }
+    escritas = aloca_zerado(num_instrucoes, sizeof(Vinculo*));
+    globais_lidas = aloca_zerado(2 * num_instrucoes + 2 * funcao->num_blocos, sizeof(Vinculo*));
+    temporario_da_global = aloca_zerado(2 * num_instrucoes + 2 * funcao->num_blocos, sizeof(Operando));
+
+    for (int l = 0; l < num_lacos; l++) move_invariantes(&lacos[l]);
+
+    free(escritas);
+    free(globais_lidas);
+    free(temporario_da_global);
+}
+
+
+// --- Desenrolamento ---
+// Um laço de um só bloco, já rodado, que continua enquanto "i op N" (N constante) e soma uma
+// constante à variável local i uma única vez por volta, faz um número de voltas conhecido se
+// o valor de i na entrada for uma constante. Com poucas voltas, o bloco vira uma sequência de
+// cópias do corpo que termina saltando para a saída.
+
+// Procura, subindo pela cadeia de blocos com um único predecessor a partir de 'bloco', a última
+// atribuição à variável antes dele. Devolve o bloco onde ela está se for de uma constante.
+static BlocoBasico* valor_inicial(BlocoBasico* bloco, const Vinculo* v, int* valor) {
+    for (int passos = 0; passos < funcao->num_blocos; passos++) {
+        for (const InstrucaoIR* ins = bloco->ultima; ins; ins = ins->anterior) {
+            if (ins->destino.tipo != OPERANDO_VAR || ins->destino.var != v) continue;
+            if (ins->op != IR_COPIA || ins->a.tipo != OPERANDO_CONST) return NULL;
+            *valor = ins->a.valor;
+            return bloco;
+        }
+        if (bloco->num_predecessores != 1) return NULL;
+        bloco = bloco->predecessores[0];
+    }
+    return NULL;
+}
+
+// Constante somada à variável pela única instrução do bloco que a escreve ("v = t", com
+// "t = v + k", "t = k + v" ou "t = v - k" no mesmo bloco).
+static int passo_da_variavel(const BlocoBasico* b, const Vinculo* v, int* passo) {
+    const InstrucaoIR* escrita = NULL;
+    for (const InstrucaoIR* ins = b->primeira; ins; ins = ins->proxima) {
+        if (ins->destino.tipo != OPERANDO_VAR || ins->destino.var != v) continue;
+        if (escrita || ins->op != IR_COPIA || ins->a.tipo != OPERANDO_TEMP) return 0;
+        escrita = ins;
+    }
+    if (!escrita) return 0;
+    for (const InstrucaoIR* ins = b->primeira; ins != escrita; ins = ins->proxima) {
+        if (ins->op != IR_BINARIO || ins->destino.tipo != OPERANDO_TEMP
+            || ins->destino.valor != escrita->a.valor) {
+            continue;
+        }
+        Operando x = ins->a, y = ins->b;
+        if (ins->operador == OPR_SOMA && y.tipo == OPERANDO_VAR && y.var == v) {
+            x = ins->b;
+            y = ins->a;
+        }
+        if (x.tipo != OPERANDO_VAR || x.var != v || y.tipo != OPERANDO_CONST) return 0;
+        if (ins->operador == OPR_SOMA) *passo = y.valor;
+        else if (ins->operador == OPR_SUBTRACAO) *passo = (int)(0u - (unsigned int)y.valor);
+        else return 0;
+        return 1;
+    }
+    return 0;
+}
+
+static int desenrola(const Laco* laco) {
+    BlocoBasico* b = laco->cabecalho;
+    if (laco->num_blocos != 1 || b->terminador != TERM_DESVIO || !laco->pre_cabecalho) return 0;
+    // Normaliza a condição para "variável op constante", verdadeira enquanto o laço continua.
+    int volta = b->sucessores[0] == b ? 0 : 1;
+    OperadorIR op = volta == 0 ? b->comparacao : ir_nega_comparacao(b->comparacao);
+    Operando x = b->valor, y = b->valor2;
+    if (x.tipo == OPERANDO_CONST) {
+        x = b->valor2;
+        y = b->valor;
+        op = ir_espelha_comparacao(op);
+    }
+    if (x.tipo != OPERANDO_VAR || !eh_local(x.var) || y.tipo != OPERANDO_CONST) return 0;
+
+    int passo, inicial;
+    BlocoBasico* origem = valor_inicial(laco->pre_cabecalho, x.var, &inicial);
+    if (!origem || !passo_da_variavel(b, x.var, &passo)) return 0;
+    int voltas = 0, v = inicial, continua;
+    ir_calcula(op, v, y.valor, &continua);
+    while (continua) {
+        if (++voltas > LIMITE_VOLTAS) return 0;
+        ir_calcula(OPR_SOMA, v, passo, &v);
+        ir_calcula(op, v, y.valor, &continua);
+    }
+    int n = 0;
+    for (InstrucaoIR* ins = b->primeira; ins; ins = ins->proxima) n++;
+    if (voltas == 0 || n * voltas > LIMITE_DESENROLADO || temporario_lido_fora(b)) return 0;
+
+    inicia_nomes();
+    InstrucaoIR* ultima = b->ultima;
+    for (int k = 1; k < voltas && ultima; k++) copia_instrucoes(b, b->primeira, ultima);
+    free(novo_nome);
+    ir_salto(b, b->sucessores[1 - volta]);
+    if (b->profundidade_laco > 0) b->profundidade_laco--;
+
+    // A guarda (o teste original, antes do pré-cabeçalho) também sabe o valor de i: se ela
+    // compara i com uma constante, o desvio vira um salto para o corpo.
+    BlocoBasico* pre = laco->pre_cabecalho;
+    BlocoBasico* guarda = pre->num_predecessores == 1 ? pre->predecessores[0] : NULL;
+    if (guarda && origem != pre && guarda->terminador == TERM_DESVIO) {
+        Operando a = guarda->valor, c = guarda->valor2;
+        if (a.tipo == OPERANDO_VAR && a.var == x.var) a = ir_const(inicial);
+        if (c.tipo == OPERANDO_VAR && c.var == x.var) c = ir_const(inicial);
+        ir_desvio_comparacao(guarda, guarda->comparacao, a, c, guarda->sucessores[0], guarda->sucessores[1]);
+    }
+    estatisticas.lacos_desenrolados++;
+    return 1;
+}
+
+
+// --- Variáveis de Indução ---
+// Uma variável local que o laço escreve uma única vez, somando a ela uma constante c, é uma
+// variável de indução: a cada escrita, o seu produto por uma constante k aumenta k*c. Em vez
+// de multiplicar a cada volta, um temporário recebe o produto no pré-cabeçalho e é somado de
+// k*c logo depois da escrita, e as multiplicações viram cópias dele. A soma é modular, como
+// a multiplicação que substitui: a última volta ainda soma k*c, e esse produto, que o
+// programa nunca usa, pode transbordar. Fatores ±2^n ficam de fora: o deslocamento que os
+// substitui (ver reducao.c) já custa o mesmo que a soma.
+
+typedef struct Inducao {
+    Vinculo* var;
+    int fator;
+    Operando produto;           // Vale var * fator em todo ponto do laço.
+} Inducao;
+
+static Inducao* inducoes;
+static int num_inducoes;
+
+// A única instrução do laço que escreve a variável, se ela for uma variável de indução
+// (e então o bloco onde ela está e a constante somada); NULL caso contrário.
+static InstrucaoIR* escrita_de_inducao(const Laco* laco, const Vinculo* v, BlocoBasico** bloco, int* passo) {
+    InstrucaoIR* escrita = NULL;
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        if (!laco->no_laco[i]) continue;
+        for (InstrucaoIR* ins = funcao->blocos[i]->primeira; ins; ins = ins->proxima) {
+            if (ins->destino.tipo != OPERANDO_VAR || ins->destino.var != v) continue;
+            if (escrita) return NULL;
+            escrita = ins;
+            *bloco = funcao->blocos[i];
+        }
+    }
+    if (!escrita || !passo_da_variavel(*bloco, v, passo)) return NULL;
+    return escrita;
+}
+
+// Temporário que acompanha "v * fator" no laço (criado na primeira vez), ou nenhum se 'v' não
+// é uma variável de indução.
+static Operando produto_da_inducao(const Laco* laco, Vinculo* v, int fator) {
+    for (int k = 0; k < num_inducoes; k++) {
+        if (inducoes[k].var == v && inducoes[k].fator == fator) return inducoes[k].produto;
+    }
+    BlocoBasico* bloco;
+    int passo, incremento;
+    InstrucaoIR* escrita = escrita_de_inducao(laco, v, &bloco, &passo);
+    if (!escrita) return ir_nenhum();
+
+    Operando produto = ir_novo_temp(funcao);
+    ir_binario(laco->pre_cabecalho, OPR_MULTIPLICACAO, produto, ir_var(v), ir_const(fator));
+    ir_calcula(OPR_MULTIPLICACAO, fator, passo, &incremento);
+    InstrucaoIR* soma = ir_insere_antes(bloco, escrita->proxima, IR_BINARIO);
+    soma->operador = OPR_SOMA_MODULAR;
+    soma->destino = produto;
+    soma->a = produto;
+    soma->b = ir_const(incremento);
+
+    inducoes[num_inducoes].var = v;
+    inducoes[num_inducoes].fator = fator;
+    inducoes[num_inducoes++].produto = produto;
+    return produto;
+}
+
+static void reduz_inducoes(const Laco* laco) {
+    if (!laco->pre_cabecalho) return;
+    num_inducoes = 0;
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        if (!laco->no_laco[i]) continue;
+        for (InstrucaoIR* ins = funcao->blocos[i]->primeira; ins; ins = ins->proxima) {
+            if (ins->op != IR_BINARIO || ins->operador != OPR_MULTIPLICACAO) continue;
+            Operando x = ins->a, k = ins->b;
+            if (x.tipo == OPERANDO_CONST) {
+                x = ins->b;
+                k = ins->a;
+            }
+            if (x.tipo != OPERANDO_VAR || !eh_local(x.var) || k.tipo != OPERANDO_CONST) continue;
+            unsigned int m = k.valor < 0 ? 0u - (unsigned int)k.valor : (unsigned int)k.valor;
+            if ((m & (m - 1)) == 0) continue; // 0 ou potência de 2.
+            Operando produto = produto_da_inducao(laco, x.var, k.valor);
+            if (produto.tipo == OPERANDO_NENHUM) continue;
+            ins->op = IR_COPIA;
+            ins->a = produto;
+            ins->b = ir_nenhum();
+            estatisticas.multiplicacoes_reduzidas++;
+        }
+    }
+}
+
+static void reduz_inducoes_dos_lacos(void) {
+    int num_instrucoes = 0;
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        for (const InstrucaoIR* ins = funcao->blocos[i]->primeira; ins; ins = ins->proxima) num_instrucoes++;
+    }
+    inducoes = aloca_zerado(num_instrucoes, sizeof(Inducao));
+    for (int l = 0; l < num_lacos; l++) reduz_inducoes(&lacos[l]);
+    free(inducoes);
+}
+
+
+static void otimiza_funcao(FuncaoIR* f, int desenrolar) {
+    funcao = f;
+    if (funcao->num_blocos == 0) return;
+    rotaciona_lacos();
+    encontra_lacos();
+    move_invariantes_dos_lacos();
+    reduz_inducoes_dos_lacos();
+    if (desenrolar) {
+        int desenrolou = 0;
+        for (int l = 0; l < num_lacos; l++) desenrolou |= desenrola(&lacos[l]);
+        if (desenrolou) ir_atualiza_grafo(funcao);
+    }
+    libera_lacos();
+}
+
+EstatisticasLacos otimiza_lacos(ProgramaIR* p, int desenrolar) {
+    memset(&estatisticas, 0, sizeof(estatisticas));
+    programa = p;
+    for (int f = 0; f < programa->num_funcoes; f++) otimiza_funcao(programa->funcoes[f], desenrolar);
+    return estatisticas;
+}
+
+void imprime_estatisticas_lacos(void) {
+    printf("Laços: %d rodado(s), %d expressão(ões) invariante(s) movida(s), %d leitura(s) de global "
+           "movida(s), %d multiplicação(ões) trocada(s) por somas, %d desenrolado(s).\n",
+           estatisticas.lacos_rodados, estatisticas.expressoes_movidas,
+           estatisticas.leituras_globais_movidas, estatisticas.multiplicacoes_reduzidas,
+           estatisticas.lacos_desenrolados);
+}
@@ -0,0 +1,33 @@
+#ifndef LACOS_H
+#define LACOS_H
+
+#include "ir.h"
+
+// --- Otimização de Laços (-O2) ---
+// Passada sobre o código intermediário, logo depois da sua geração. Em cada função:
+//  - roda os laços: o teste do 'enquanto' é copiado para o fim do corpo, e cada volta passa a
+//    executar um único desvio (o teste do início só é feito na entrada, como guarda);
+//  - move para antes do laço os cálculos cujos operandos não mudam dentro dele, e as leituras
+//    de variáveis globais que o laço não escreve (se ele não chama funções, que poderiam
+//    escrevê-las);
+//  - troca as multiplicações de uma variável de indução (somada de uma constante a cada volta)
+//    por uma constante por um temporário que é somado junto com ela;
+//  - se pedido, desenrola os laços de um só bloco que contam de uma constante até outra em
+//    poucas voltas, trocando o laço por cópias do corpo em sequência.
+
+// Contadores do que a passada fez (para o relatório).
+typedef struct EstatisticasLacos {
+    int lacos_rodados;          // Laços que passaram a ter o teste no fim.
+    int expressoes_movidas;     // Cálculos invariantes levados para antes do laço.
+    int leituras_globais_movidas; // Variáveis globais lidas uma vez antes do laço.
+    int multiplicacoes_reduzidas; // Produtos de variáveis de indução trocados por somas.
+    int lacos_desenrolados;     // Laços trocados por cópias do corpo.
+} EstatisticasLacos;
+
+// Otimiza os laços de todas as funções do programa e devolve o que foi feito.
+EstatisticasLacos otimiza_lacos(ProgramaIR* programa, int desenrolar);
+
+// Imprime o relatório da última execução.
+void imprime_estatisticas_lacos(void);
+
+#endif // LACOS_H
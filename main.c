@@ -5,7 +5,15 @@
 #include "arvore.h"       // Inclui a definição da Árvore Sintática Abstrata.
 #include "tabela_simbolos.h" // Inclui a definição da Tabela de Símbolos.
 #include "analise_semantica.h" // Inclui a função principal da análise semântica.
+#include "otimizacao.h"
+#include "alcance.h"
+#include "geracao_ir.h"
+#include "expansao.h"
+#include "lacos.h"
+#include "ssa.h"
+#include "reducao.h"
 #include "geracao_codigo.h"
+#include "peephole.h"
 
 // --- Variáveis Globais Externas ---
 // Estas variáveis são definidas e gerenciadas pelo analisador léxico (Flex/Lex)
@@ -36,14 +44,83 @@ void yyerror(const char *s) {
 int main(int argc, char **argv) {
     // Verifica se o usuário forneceu o nome do arquivo de entrada.
     if (argc < 2) {
-        fprintf(stderr, "Uso: %s <arquivo.g> [-d]\n", argv[0]);
+        fprintf(stderr, "Uso: %s <arquivo.g> [-d] [-r] [-P] [-Pno-<regra>] [-O<nível>] [-u] [-inline=<n>] [-b] [-emit-ir]\n", argv[0]);
+        fprintf(stderr, "  -d   modo de depuração\n");
+        fprintf(stderr, "  -r   mantém as variáveis locais mais usadas em registradores ($s2-$s7)\n");
+        fprintf(stderr, "  -P   otimização de janela (peephole) sobre o código MIPS\n");
+        fprintf(stderr, "  -Pno-<regra>  desliga uma regra da otimização de janela:\n");
+        for (int r = 0; r < NUM_REGRAS_PEEPHOLE; r++) {
+            fprintf(stderr, "         %-17s %s\n", peephole_nome_regra(r), peephole_descricao_regra(r));
+        }
+        fprintf(stderr, "  -O0  sem otimizações (padrão)\n");
+        fprintf(stderr, "  -O1  dobra e propaga constantes, simplifica identidades, troca '*' e '/' por constantes por\n"
+                        "       deslocamentos, remove desvios de condição constante, troca as chamadas em 'retorne'\n"
+                        "       por saltos e usa -P (-O = -O1)\n");
+        fprintf(stderr, "  -O2  -O1 mais -r, a otimização de laços (teste no fim e cálculos invariantes fora do laço) e\n"
+                        "       a expansão em linha das funções pequenas (-inline=%d)\n", ORCAMENTO_EXPANSAO_PADRAO);
+        fprintf(stderr, "  -O3  -O2 mais a forma SSA: numeração global de valores e remoção de código morto\n");
+        fprintf(stderr, "  -u   desenrola os laços de poucas voltas com contagem constante (liga a otimização de laços)\n");
+        fprintf(stderr, "  -inline=<n>  expande em linha as chamadas a funções não recursivas de até <n> instruções\n"
+                        "               do código intermediário (0 desliga)\n");
+        fprintf(stderr, "  -b   entrada e saída com buffer: 'escreva' acumula o texto e o escreve de uma vez (no fim,\n"
+                        "       antes de cada 'leia' ou com o buffer cheio) e 'leia' lê uma linha por vez\n");
+        fprintf(stderr, "  -emit-ir  grava o código intermediário (blocos básicos) em <arquivo>.ir\n");
         return 1; // Retorna 1 para indicar erro.
     }
 
-    // Verifica se o argumento opcional "-d" (debug) foi fornecido.
-    if (argc > 2 && strcmp(argv[2], "-d") == 0) {
-        debug_mode = 1;
-        printf("Modo de depuração ativado.\n");
+    // Lê as opções que vêm depois do nome do arquivo.
+    OpcoesGeracao opcoes = {0};
+    opcoes.regras_peephole = TODAS_AS_REGRAS_PEEPHOLE;
+    int nivel_otimizacao = 0;
+    int emitir_ir = 0;
+    int desenrolar_lacos = 0;
+    int orcamento_expansao = -1; // -1 = o padrão do nível de otimização.
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "-d") == 0) {
+            debug_mode = 1;
+            printf("Modo de depuração ativado.\n");
+        } else if (strcmp(argv[i], "-r") == 0) {
+            opcoes.promover_registradores = 1;
+        } else if (strcmp(argv[i], "-P") == 0) {
+            opcoes.peephole = 1;
+        } else if (strncmp(argv[i], "-Pno-", 5) == 0) {
+            int regra = peephole_indice_regra(argv[i] + 5);
+            if (regra < 0) {
+                fprintf(stderr, "Regra de otimização de janela desconhecida: '%s'\n", argv[i] + 5);
+                return 1;
+            }
+            opcoes.regras_peephole &= ~(1u << regra);
+        } else if (strcmp(argv[i], "-O") == 0) {
+            nivel_otimizacao = 1;
+        } else if (strncmp(argv[i], "-O", 2) == 0 && argv[i][2] >= '0' && argv[i][2] <= '3' && argv[i][3] == '\0') {
+            nivel_otimizacao = argv[i][2] - '0';
+        } else if (strcmp(argv[i], "-u") == 0) {
+            desenrolar_lacos = 1;
+        } else if (strncmp(argv[i], "-inline=", 8) == 0) {
+            char* fim;
+            long n = strtol(argv[i] + 8, &fim, 10);
+            if (fim == argv[i] + 8 || *fim != '\0' || n < 0 || n > 10000) {
+                fprintf(stderr, "Orçamento de expansão em linha inválido: '%s'\n", argv[i] + 8);
+                return 1;
+            }
+            orcamento_expansao = (int)n;
+        } else if (strcmp(argv[i], "-b") == 0) {
+            opcoes.saida_com_buffer = 1;
+        } else if (strcmp(argv[i], "-emit-ir") == 0) {
+            emitir_ir = 1;
+        } else {
+            fprintf(stderr, "Opção desconhecida: '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (nivel_otimizacao >= 1) {
+        opcoes.peephole = 1;
+        opcoes.chamadas_de_cauda = 1;
+    }
+    if (nivel_otimizacao >= 2) {
+        opcoes.promover_registradores = 1;
+        if (orcamento_expansao < 0) orcamento_expansao = ORCAMENTO_EXPANSAO_PADRAO;
     }
 
     // Abre o arquivo de código-fonte fornecido pelo usuário em modo de leitura ("r").
@@ -60,6 +137,8 @@ int main(int argc, char **argv) {
     // A chamada `yyparse()` inicia o processo. O parser (Bison) chama o lexer (Flex)
     // para obter tokens e constrói a Árvore Sintática Abstrata, cuja raiz é armazenada em 'raiz_arvore'.
     printf("Iniciando análise léxica e sintática...\n");
+    // Registra os átomos predefinidos (tipos, funções nativas, operadores) antes de ler tokens.
+    inicializar_atomos();
     int result = yyparse();
     fclose(yyin); 
 
@@ -72,28 +151,91 @@ int main(int argc, char **argv) {
             printf("----------------------------------------\n\n");
         }
 
-        // --- Cria cópias da árvore para as próximas fases ---
-        No* arvore_para_semantica = copia_arvore(raiz_arvore);
-        No* arvore_para_geracao = copia_arvore(raiz_arvore);
-
-        // 2. Análise Semântica (usa a primeira cópia)
+        // 2. Análise Semântica
+        // As fases seguintes trabalham sobre a MESMA árvore: a análise semântica anota os tipos
+        // nos nós, a otimização (se pedida) simplifica a árvore no próprio lugar e a geração do
+        // código intermediário apenas os lê, sem alterar a estrutura da árvore.
         printf("Iniciando análise semântica...\n");
-        int erros_semanticos = analisar(arvore_para_semantica);
+        int erros_semanticos = analisar(raiz_arvore);
 
         if (erros_semanticos == 0) {
             printf("Análise semântica concluída sem erros!\n\n");
+            if (debug_mode) {
+                imprime_estatisticas_analise();
+            }
 
-            // 3. Geração de Código (usa a segunda cópia, intacta)
-            printf("Iniciando geração de código...\n");
+            // 3. Otimização (reescreve a árvore anotada no próprio lugar)
+            if (nivel_otimizacao > 0) {
+                printf("Iniciando otimização (-O%d)...\n", nivel_otimizacao);
+                otimizar(raiz_arvore, nivel_otimizacao);
+                imprime_estatisticas_otimizacao();
+                printf("\n");
+                if (debug_mode) {
+                    printf("--- Árvore Sintática Abstrata Otimizada ---\n");
+                    imprime_arvore(raiz_arvore, 0);
+                    printf("-----------------------------------------\n\n");
+                }
+            }
+
+            // Os comandos que nunca são executados são descartados em todos os níveis (e as funções
+            // que o programa não chama, depois da expansão em linha).
+            remove_comandos_inalcancaveis(raiz_arvore, debug_mode);
+
+            // Os arquivos de saída têm o nome da entrada com outra extensão.
             char nome_arquivo_saida[256];
             strcpy(nome_arquivo_saida, argv[1]);
             char *ponto = strrchr(nome_arquivo_saida, '.');
-            if (ponto) {
-                strcpy(ponto, ".asm");
-            } else {
-                strcat(nome_arquivo_saida, ".asm");
+            if (!ponto) {
+                ponto = nome_arquivo_saida + strlen(nome_arquivo_saida);
             }
-            gerar_codigo(arvore_para_geracao, nome_arquivo_saida);
+
+            // 4. Geração do Código Intermediário (blocos básicos de instruções de três endereços)
+            printf("Iniciando geração de código intermediário...\n");
+            ProgramaIR* programa_ir = gera_ir(raiz_arvore);
+            if (orcamento_expansao > 0) {
+                printf("Iniciando expansão de funções em linha...\n");
+                expande_funcoes(programa_ir, orcamento_expansao, debug_mode);
+                imprime_estatisticas_expansao();
+            }
+            remove_funcoes_inalcancaveis(programa_ir, debug_mode);
+            imprime_estatisticas_alcance();
+            if (nivel_otimizacao >= 2 || desenrolar_lacos) {
+                printf("Iniciando otimização de laços...\n");
+                otimiza_lacos(programa_ir, desenrolar_lacos);
+                imprime_estatisticas_lacos();
+            }
+            if (nivel_otimizacao >= 3) {
+                printf("Iniciando otimização em forma SSA...\n");
+                otimiza_ssa(programa_ir);
+                imprime_estatisticas_ssa();
+            }
+            if (nivel_otimizacao >= 1) {
+                printf("Iniciando redução de força...\n");
+                reduz_forca(programa_ir);
+                imprime_estatisticas_reducao();
+            }
+            if (orcamento_expansao > 0) {
+                junta_variaveis_copiadas(programa_ir);
+                imprime_estatisticas_variaveis_copiadas();
+            }
+            if (emitir_ir) {
+                strcpy(ponto, ".ir");
+                FILE* arquivo_ir = fopen(nome_arquivo_saida, "w");
+                if (!arquivo_ir) {
+                    perror("Erro ao criar arquivo do código intermediário");
+                    return 1;
+                }
+                ir_imprime(programa_ir, arquivo_ir);
+                fclose(arquivo_ir);
+                printf("Código intermediário gravado em '%s'.\n", nome_arquivo_saida);
+            }
+
+            // 5. Geração de Código MIPS (a partir do código intermediário)
+            printf("Iniciando geração de código...\n");
+            strcpy(ponto, ".asm");
+            opcoes.depuracao = debug_mode;
+            gerar_codigo(programa_ir, nome_arquivo_saida, &opcoes);
+            ir_liberar(programa_ir);
 
             printf("\nCompilação concluída com sucesso!\n");
         } else {
@@ -101,16 +243,20 @@ int main(int argc, char **argv) {
             result = 1; 
         }
 
-        // Libera a memória de TODAS as árvores criadas
-        libera_arvore(arvore_para_semantica);
-        libera_arvore(arvore_para_geracao);
-
     } else { 
         fprintf(stderr, "\nCompilação abortada com erros sintáticos.\n");
     }
 
-    // Libera a memória da árvore original
-    libera_arvore(raiz_arvore);
+    // Mostra quanto a arena da árvore e a tabela de átomos consumiram (para medir o custo de alocação).
+    if (debug_mode) {
+        imprime_estatisticas_arvore();
+        imprime_estatisticas_atomos();
+    }
+
+    // Libera de uma só vez a memória dos vínculos, da árvore e dos lexemas (átomos).
+    liberar_analise();
+    libera_arvores();
+    liberar_atomos();
 
     return result;
 }
\ No newline at end of file
@@ -0,0 +1,438 @@
+#include <stdio.h>      // Para printf e snprintf.
+#include <stdlib.h>     // Para realloc e exit.
+#include <limits.h>     // Para INT_MIN.
+#include "otimizacao.h"
+#include "atomos.h"          // Os valores dobrados viram lexemas (átomos) de constantes.
+#include "tabela_simbolos.h" // Os valores conhecidos das variáveis ficam nos seus vínculos.
+
+// --- Valores Conhecidos das Variáveis ---
+// Durante o percurso, o vínculo de cada variável guarda se o seu valor atual é uma constante
+// conhecida ('constante_versao' != 0) e qual ('constante_valor'). Toda mudança é anotada num
+// registro de desfazer, como na pilha de escopos: ao terminar um ramo de 'se' ou o corpo de um
+// laço, basta desfazer até a marca tomada na entrada para voltar ao que se sabia antes dele.
+//
+// Uma chamada de função pode alterar qualquer variável global. Em vez de percorrer todas as
+// globais conhecidas a cada chamada, cada fato sobre uma global guarda a 'época' em que foi
+// registrado, e a chamada só incrementa a época: fatos de épocas anteriores deixam de valer.
+// Locais e parâmetros não são visíveis para outras funções, então as chamadas não os afetam.
+
+typedef struct RegistroFato {
+    Vinculo* vinculo;
+    int versao;         // Valores anteriores, restaurados ao desfazer.
+    int valor;
+} RegistroFato;
+
+static RegistroFato* registros = NULL;
+static int num_registros = 0;
+static int capacidade_registros = 0;
+static int epoca_globais = 1;
+
+static EstatisticasOtimizacao estatisticas;
+
+static void otimiza_comandos(No* lista);
+
+// Retorna 1 (e o valor em '*valor') se o valor atual da variável é conhecido.
+static int valor_conhecido(const Vinculo* v, int* valor) {
+    if (v->constante_versao == 0) return 0;
+    if (v->classe == ARMAZ_GLOBAL && v->constante_versao != epoca_globais) return 0;
+    *valor = v->constante_valor;
+    return 1;
+}
+
+// Registra que a variável passou a valer 'valor' (conhecido = 1) ou um valor desconhecido.
+static void define_fato(Vinculo* v, int conhecido, int valor) {
+    if (num_registros == capacidade_registros) {
+        capacidade_registros = capacidade_registros ? capacidade_registros * 2 : 64;
+        registros = realloc(registros, capacidade_registros * sizeof(RegistroFato));
+        if (!registros) {
+            printf("Erro: Falha de alocação de memória na otimização.\n");
+            exit(1);
+        }
+    }
+    registros[num_registros].vinculo = v;
+    registros[num_registros].versao = v->constante_versao;
+    registros[num_registros].valor = v->constante_valor;
+    num_registros++;
+
+    v->constante_versao = conhecido ? epoca_globais : 0;
+    v->constante_valor = valor;
+}
+
+// Restaura os valores conhecidos ao estado em que estavam quando havia 'marca' registros.
+static void desfaz_ate(int marca) {
+    while (num_registros > marca) {
+        RegistroFato* r = &registros[--num_registros];
+        r->vinculo->constante_versao = r->versao;
+        r->vinculo->constante_valor = r->valor;
+    }
+}
+
+// Esquece o valor de toda variável que possa ser alterada em algum ponto da subárvore
+// (atribuições e 'leia'); se houver chamada a uma função do usuário, esquece as globais.
+static void esquece_alteradas(No* no) {
+    for (; no != NULL; no = no->proximo) {
+        if (no->tipo_no == NO_ATRIBUICAO) {
+            define_fato(no->filho1->vinculo, 0, 0);
+        } else if (no->tipo_no == NO_CHAMADA_FUNCAO) {
+            if (no->lexema == ATOMO_LEIA) define_fato(no->filho1->vinculo, 0, 0);
+            else if (no->vinculo->classe == ARMAZ_FUNCAO) epoca_globais++;
+        }
+        esquece_alteradas(no->filho1); esquece_alteradas(no->filho2);
+        esquece_alteradas(no->filho3); esquece_alteradas(no->filho4);
+    }
+}
+
+
+// --- Dobramento de Constantes ---
+
+// Cadeias (entre aspas) também chegam como NO_CONST_CAR, mas não têm valor numérico.
+static int eh_cadeia(const No* no) {
+    return no->tipo_no == NO_CONST_CAR && texto_atomo(no->lexema)[0] == '"';
+}
+
+static int eh_constante(const No* no) {
+    return no->tipo_no == NO_CONST_INT || (no->tipo_no == NO_CONST_CAR && !eh_cadeia(no));
+}
+
+// Transforma o nó numa constante inteira com o valor dado. O tipo de dado anotado pela análise
+// é mantido (ex: um 'car' conhecido continua sendo escrito como caractere).
+static void vira_constante(No* no, int valor) {
+    char texto[16];
+    int tamanho = snprintf(texto, sizeof(texto), "%d", valor);
+    no->tipo_no = NO_CONST_INT;
+    no->lexema = interna(texto, (size_t)tamanho);
+    no->vinculo = NULL;
+    no->filho1 = no->filho2 = no->filho3 = no->filho4 = NULL;
+}
+
+// Calcula 'a op b' como o MIPS calcularia. Retorna 0 se a operação não deve ser feita em
+// tempo de compilação (divisão por zero ou que transborda: o erro fica para a execução).
+static int calcula(Atomo op, int a, int b, int* resultado) {
+    // Soma, subtração e multiplicação são feitas sem sinal para dar a volta em 32 bits,
+    // como as instruções do MIPS (em C, o transbordo com sinal seria indefinido).
+    unsigned int ua = (unsigned int)a, ub = (unsigned int)b;
+    switch (op) {
+        case ATOMO_MAIS:        *resultado = (int)(ua + ub); return 1;
+        case ATOMO_MENOS:       *resultado = (int)(ua - ub); return 1;
+        case ATOMO_VEZES:       *resultado = (int)(ua * ub); return 1;
+        case ATOMO_DIVIDIDO:
+            if (b == 0 || (a == INT_MIN && b == -1)) return 0;
+            *resultado = a / b; // Trunca em direção a zero, como 'div'.
+            return 1;
+        case ATOMO_IGUAL:       *resultado = a == b; return 1;
+        case ATOMO_DIFERENTE:   *resultado = a != b; return 1;
+        case ATOMO_MENOR:       *resultado = a < b; return 1;
+        case ATOMO_MENOR_IGUAL: *resultado = a <= b; return 1;
+        case ATOMO_MAIOR:       *resultado = a > b; return 1;
+        case ATOMO_MAIOR_IGUAL: *resultado = a >= b; return 1;
+        default:                return 0;
+    }
+}
+
+
+// --- Simplificação Algébrica ---
+
+// Retorna 1 se a subárvore pode ser descartada sem mudar o programa: não tem chamadas nem
+// atribuições, nem divisões (que poderiam parar a execução por divisão por zero).
+static int sem_efeitos(const No* no) {
+    if (no == NULL) return 1;
+    switch (no->tipo_no) {
+        case NO_CHAMADA_FUNCAO:
+        case NO_ATRIBUICAO:
+            return 0;
+        case NO_OP_ARITMETICO:
+            if (no->lexema == ATOMO_DIVIDIDO) return 0;
+            return sem_efeitos(no->filho1) && sem_efeitos(no->filho2);
+        default:
+            return sem_efeitos(no->filho1) && sem_efeitos(no->filho2);
+    }
+}
+
+// Retorna 1 se as duas subárvores (sem efeitos) calculam sempre o mesmo valor.
+static int mesma_expressao(const No* a, const No* b) {
+    if (a == NULL || b == NULL) return a == b;
+    if (a->tipo_no != b->tipo_no) return 0;
+    switch (a->tipo_no) {
+        case NO_IDENTIFICADOR:
+            return a->vinculo == b->vinculo;
+        case NO_CONST_INT:
+        case NO_CONST_CAR:
+            return !eh_cadeia(a) && !eh_cadeia(b) && valor_constante(a) == valor_constante(b);
+        case NO_OP_ARITMETICO:
+        case NO_OP_RELACIONAL:
+        case NO_OP_LOGICO:
+        case NO_NEGACAO:
+            return a->lexema == b->lexema && mesma_expressao(a->filho1, b->filho1) &&
+                   mesma_expressao(a->filho2, b->filho2);
+        default:
+            return 0;
+    }
+}
+
+// Coloca a subárvore 'filho' no lugar do nó. O encadeamento ('proximo') e o tipo anotado são
+// mantidos.
+static void vira_filho(No* no, const No* filho) {
+    No copia = *filho;
+    copia.proximo = no->proximo;
+    copia.tipo_dado = no->tipo_dado;
+    *no = copia;
+}
+
+static int eh_constante_valendo(const No* no, int valor) {
+    return eh_constante(no) && valor_constante(no) == valor;
+}
+
+// Aplica as identidades x+0 = 0+x = x-0 = x*1 = 1*x = x/1 = x, x*0 = 0*x = 0 e x-x = 0
+// (as duas últimas só se 'x' não tem efeitos, já que deixa de ser avaliado).
+// Retorna 1 se o nó foi simplificado.
+static int simplifica_aritmetica(No* no) {
+    No* x = no->filho1;
+    No* y = no->filho2;
+    switch (no->lexema) {
+        case ATOMO_MAIS:
+            if (eh_constante_valendo(y, 0)) { vira_filho(no, x); return 1; }
+            if (eh_constante_valendo(x, 0)) { vira_filho(no, y); return 1; }
+            return 0;
+        case ATOMO_MENOS:
+            if (eh_constante_valendo(y, 0)) { vira_filho(no, x); return 1; }
+            if (sem_efeitos(x) && mesma_expressao(x, y)) { vira_constante(no, 0); return 1; }
+            return 0;
+        case ATOMO_VEZES:
+            if (eh_constante_valendo(y, 1)) { vira_filho(no, x); return 1; }
+            if (eh_constante_valendo(x, 1)) { vira_filho(no, y); return 1; }
+            if ((eh_constante_valendo(y, 0) && sem_efeitos(x)) ||
+                (eh_constante_valendo(x, 0) && sem_efeitos(y))) {
+                vira_constante(no, 0);
+                return 1;
+            }
+            return 0;
+        case ATOMO_DIVIDIDO:
+            if (eh_constante_valendo(y, 1)) { vira_filho(no, x); return 1; }
+            return 0;
+        default:
+            return 0;
+    }
+}
+
+// Expressões cujo valor já é sempre 0 ou 1.
+static int eh_booleana(const No* no) {
+    return no->tipo_no == NO_OP_RELACIONAL || no->tipo_no == NO_OP_LOGICO || no->tipo_no == NO_NEGACAO;
+}
+
+// '!!x' vale 1 se x != 0 e 0 caso contrário: vira o próprio 'x' se ele já é 0 ou 1, ou a
+// comparação "x != 0" (uma instrução em vez de duas). Retorna 1 se o nó foi simplificado.
+static int simplifica_dupla_negacao(No* no) {
+    if (no->filho1->tipo_no != NO_NEGACAO) return 0;
+    No* x = no->filho1->filho1;
+    if (eh_booleana(x)) {
+        vira_filho(no, x);
+        return 1;
+    }
+    No* zero = cria_no(NO_CONST_INT, no->linha, interna("0", 1));
+    zero->tipo_dado = TIPO_INT;
+    no->tipo_no = NO_OP_RELACIONAL;
+    no->lexema = ATOMO_DIFERENTE;
+    no->filho1 = x;
+    no->filho2 = zero;
+    return 1;
+}
+
+static void otimiza_expr(No* no);
+
+// Os argumentos de uma chamada são avaliados da direita para a esquerda: a recursão chega ao
+// último antes de otimizar o primeiro.
+static void otimiza_argumentos(No* arg) {
+    if (arg == NULL) return;
+    otimiza_argumentos(arg->proximo);
+    otimiza_expr(arg);
+}
+
+// Otimiza uma expressão no lugar: substitui variáveis de valor conhecido e dobra os
+// operadores cujos operandos ficaram constantes. As subexpressões são visitadas na ordem em
+// que a geração de código as avalia, para que atribuições e chamadas dentro da expressão
+// afetem apenas o que vem depois delas.
+static void otimiza_expr(No* no) {
+    int a, b, resultado;
+    switch (no->tipo_no) {
+        case NO_IDENTIFICADOR:
+            if (valor_conhecido(no->vinculo, &a)) {
+                vira_constante(no, a);
+                estatisticas.constantes_propagadas++;
+            }
+            break;
+
+        case NO_ATRIBUICAO:
+            otimiza_expr(no->filho2);
+            if (eh_constante(no->filho2)) define_fato(no->filho1->vinculo, 1, valor_constante(no->filho2));
+            else define_fato(no->filho1->vinculo, 0, 0);
+            break;
+
+        case NO_CHAMADA_FUNCAO:
+            if (no->lexema == ATOMO_LEIA) {
+                define_fato(no->filho1->vinculo, 0, 0);
+            } else if (no->lexema == ATOMO_ESCREVA) {
+                if (!eh_cadeia(no->filho1)) otimiza_expr(no->filho1);
+            } else if (no->lexema != ATOMO_NOVALINHA) {
+                otimiza_argumentos(no->filho1);
+                epoca_globais++; // A função chamada pode alterar qualquer global.
+            }
+            break;
+
+        case NO_OP_LOGICO: {
+            // O lado direito só é avaliado se o esquerdo não decidir o resultado.
+            otimiza_expr(no->filho1);
+            if (eh_constante(no->filho1)) {
+                a = valor_constante(no->filho1);
+                if ((no->lexema == ATOMO_E) == (a == 0)) {
+                    vira_constante(no, a != 0);
+                    estatisticas.nos_dobrados++;
+                    break;
+                }
+                otimiza_expr(no->filho2); // O direito é sempre avaliado.
+                if (eh_constante(no->filho2)) {
+                    vira_constante(no, valor_constante(no->filho2) != 0);
+                    estatisticas.nos_dobrados++;
+                }
+                break;
+            }
+            // Pode ou não ser avaliado: o que ele altera passa a ser desconhecido.
+            int marca = num_registros;
+            otimiza_expr(no->filho2);
+            desfaz_ate(marca);
+            esquece_alteradas(no->filho2);
+            break;
+        }
+
+        case NO_OP_ARITMETICO:
+        case NO_OP_RELACIONAL:
+            otimiza_expr(no->filho1);
+            otimiza_expr(no->filho2);
+            if (eh_constante(no->filho1) && eh_constante(no->filho2)) {
+                a = valor_constante(no->filho1);
+                b = valor_constante(no->filho2);
+                if (calcula(no->lexema, a, b, &resultado)) {
+                    vira_constante(no, resultado);
+                    estatisticas.nos_dobrados++;
+                }
+            } else if (no->tipo_no == NO_OP_ARITMETICO && simplifica_aritmetica(no)) {
+                estatisticas.identidades_aplicadas++;
+            }
+            break;
+
+        case NO_NEGACAO:
+            otimiza_expr(no->filho1);
+            if (eh_constante(no->filho1)) {
+                vira_constante(no, valor_constante(no->filho1) == 0);
+                estatisticas.nos_dobrados++;
+            } else if (simplifica_dupla_negacao(no)) {
+                estatisticas.identidades_aplicadas++;
+            }
+            break;
+
+        default: // Constantes.
+            break;
+    }
+}
+
+
+// --- Comandos ---
+
+// Transforma um comando num bloco sem declarações cujo único conteúdo é a lista 'comandos'
+// (possivelmente vazia). O encadeamento com os comandos seguintes ('proximo') é mantido.
+static void vira_bloco(No* no, No* comandos) {
+    no->tipo_no = NO_BLOCO;
+    no->lexema = ATOMO_NULO;
+    no->filho1 = NULL;
+    no->filho2 = comandos;
+    no->filho3 = no->filho4 = NULL;
+}
+
+static void otimiza_comando(No* no) {
+    int marca;
+    switch (no->tipo_no) {
+        case NO_BLOCO:
+            // Uma variável recém-declarada tem valor indefinido (importante em laços, onde o
+            // bloco é reexecutado e a variável já teve um valor conhecido na volta anterior).
+            for (No* d = no->filho1; d != NULL; d = d->proximo) define_fato(d->vinculo, 0, 0);
+            otimiza_comandos(no->filho2);
+            break;
+
+        case NO_IF:
+            otimiza_expr(no->filho1);
+            if (eh_constante(no->filho1)) {
+                // Só um dos ramos pode ser executado: ele toma o lugar do 'se'.
+                vira_bloco(no, valor_constante(no->filho1) ? no->filho2 : no->filho3);
+                estatisticas.desvios_removidos++;
+                otimiza_comandos(no->filho2);
+                break;
+            }
+            // Cada ramo parte do que se sabia antes do 'se'. Depois dele, não se sabe qual dos
+            // dois foi executado, então o que qualquer um deles altera passa a ser desconhecido.
+            marca = num_registros;
+            otimiza_comandos(no->filho2);
+            desfaz_ate(marca);
+            otimiza_comandos(no->filho3);
+            desfaz_ate(marca);
+            esquece_alteradas(no->filho2);
+            esquece_alteradas(no->filho3);
+            break;
+
+        case NO_WHILE:
+            // A condição e o corpo são executados várias vezes: o que o laço altera não pode ser
+            // considerado conhecido em nenhum ponto dele (nem depois dele).
+            esquece_alteradas(no->filho1);
+            esquece_alteradas(no->filho2);
+            marca = num_registros;
+            otimiza_expr(no->filho1);
+            if (eh_constante(no->filho1) && valor_constante(no->filho1) == 0) {
+                vira_bloco(no, NULL); // O corpo nunca é executado.
+                estatisticas.desvios_removidos++;
+            } else {
+                otimiza_comandos(no->filho2);
+            }
+            desfaz_ate(marca);
+            break;
+
+        case NO_RETORNO:
+            if (no->filho1) otimiza_expr(no->filho1);
+            break;
+
+        default: // Expressões usadas como comando.
+            otimiza_expr(no);
+            break;
+    }
+}
+
+static void otimiza_comandos(No* lista) {
+    for (No* no = lista; no != NULL; no = no->proximo) otimiza_comando(no);
+}
+
+// Otimiza o corpo de uma função (ou o bloco principal) a partir de nenhum valor conhecido.
+static void otimiza_corpo(No* corpo) {
+    epoca_globais++; // Valores de globais conhecidos em outro corpo não valem aqui.
+    otimiza_comando(corpo);
+    desfaz_ate(0);
+}
+
+EstatisticasOtimizacao otimizar(No* raiz_arvore, int nivel) {
+    EstatisticasOtimizacao zeradas = {0};
+    estatisticas = zeradas;
+    if (nivel <= 0 || !raiz_arvore) return estatisticas;
+
+    for (No* d = raiz_arvore->filho1; d != NULL; d = d->proximo) {
+        if (d->tipo_no == NO_DECL_FUNCAO) otimiza_corpo(d->filho3);
+    }
+    otimiza_corpo(raiz_arvore->filho2);
+
+    free(registros);
+    registros = NULL;
+    capacidade_registros = 0;
+    return estatisticas;
+}
+
+void imprime_estatisticas_otimizacao(void) {
+    printf("Otimização: %d nó(s) dobrado(s), %d constante(s) propagada(s), %d desvio(s) removido(s), "
+           "%d identidade(s) aplicada(s).\n",
+           estatisticas.nos_dobrados, estatisticas.constantes_propagadas, estatisticas.desvios_removidos,
+           estatisticas.identidades_aplicadas);
+}
@@ -0,0 +1,32 @@
+#ifndef OTIMIZACAO_H
+#define OTIMIZACAO_H
+
+#include "arvore.h"
+
+// --- Otimização sobre a Árvore Sintática Abstrata ---
+// Passada executada entre a análise semântica e a geração de código. Ela reescreve a árvore
+// já anotada no próprio lugar, então a geração de código não precisa saber que ela existiu:
+//  - subárvores constantes de operadores (ex: 2*60*60) viram uma única constante;
+//  - o valor de variáveis atribuídas com constantes é propagado para os usos seguintes
+//    (ex: "x = 3; y = x + 1;" vira "x = 3; y = 4;");
+//  - 'se' e 'enquanto' cuja condição é conhecida têm o ramo morto removido;
+//  - identidades algébricas são aplicadas (x+0, x*1 e x/1 viram x; x*0 e x-x viram 0 quando
+//    'x' não tem efeitos; !!x vira "x != 0").
+//
+// Níveis: 0 = nenhuma otimização; 1 = todas as transformações acima.
+
+// Contadores do que a passada fez (para o relatório).
+typedef struct EstatisticasOtimizacao {
+    int nos_dobrados;           // Operadores substituídos pelo seu valor constante.
+    int constantes_propagadas;  // Usos de variáveis substituídos pelo valor conhecido.
+    int desvios_removidos;      // Comandos 'se'/'enquanto' com condição constante eliminados.
+    int identidades_aplicadas;  // Operações simplificadas algebricamente (ex: x+0, x*1, x-x, !!x).
+} EstatisticasOtimizacao;
+
+// Otimiza a árvore de acordo com o nível e devolve o que foi feito.
+EstatisticasOtimizacao otimizar(No* raiz_arvore, int nivel);
+
+// Imprime o relatório da última otimização.
+void imprime_estatisticas_otimizacao(void);
+
+#endif // OTIMIZACAO_H
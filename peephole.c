@@ -0,0 +1,427 @@
+#include <stdio.h>      // Para printf.
+#include <stdlib.h>     // Para calloc, free e exit.
+#include <string.h>     // Para strcmp.
+#include "peephole.h"
+#include "biblioteca.h"
+
+// --- Estado de uma Passada ---
+// As regras não apagam instruções do vetor diretamente (isso deslocaria as posições a cada
+// remoção): elas só as marcam em 'removida'. Ao fim de cada varredura o vetor é compactado
+// de uma vez e o índice de rótulos é refeito.
+typedef struct Janela {
+    CodigoMips* codigo;
+    char* removida;             // removida[i] != 0: a instrução i será descartada.
+    int* indice_rotulos;        // Tabela de hash: posição -> índice da definição do rótulo (-1 = vazia).
+    unsigned int capacidade_indice; // Potência de 2.
+} Janela;
+
+// Uma regra tenta reescrever o código a partir da instrução 'i'. Devolve 1 se reescreveu.
+typedef int (*FuncaoRegra)(Janela* j, int i);
+
+typedef struct RegraPeephole {
+    const char* nome;
+    const char* descricao;
+    FuncaoRegra aplica;
+} RegraPeephole;
+
+// Estatísticas da última execução, por regra.
+static int aplicacoes[NUM_REGRAS_PEEPHOLE];
+static int removidas[NUM_REGRAS_PEEPHOLE];
+static int regra_atual;             // Regra em execução (a quem as remoções são atribuídas).
+static int instrucoes_antes, instrucoes_depois;
+
+#define ORCAMENTO_VIVACIDADE 256 // Máximo de instruções examinadas ao decidir se um temporário está vivo.
+
+// --- Auxiliares ---
+
+static int eh_temporario(Registrador r) {
+    return (r >= REG_T0 && r <= REG_T7) || r == REG_T8 || r == REG_T9;
+}
+
+// Comentários não geram código e podem ser pulados pelas regras (rótulos não: eles separam
+// blocos básicos, já que podem ser alcançados por desvios).
+static int eh_anotacao(const Instrucao* ins) {
+    return ins->op == OP_COMENTARIO;
+}
+
+static int conta_instrucoes(const CodigoMips* codigo) {
+    int n = 0;
+    for (int i = 0; i < codigo->num_instrucoes; i++) {
+        Opcode op = codigo->instrucoes[i].op;
+        if (op != OP_ROTULO && op != OP_COMENTARIO && op != OP_DIRETIVA && op != OP_ASCIIZ) n++;
+    }
+    return n;
+}
+
+static void remove_instrucao(Janela* j, int i) {
+    j->removida[i] = 1;
+    removidas[regra_atual]++;
+}
+
+// Próxima instrução depois de 'i' que não foi removida nem é comentário (-1 se não houver).
+static int proxima(const Janela* j, int i) {
+    for (i++; i < j->codigo->num_instrucoes; i++) {
+        if (!j->removida[i] && !eh_anotacao(&j->codigo->instrucoes[i])) return i;
+    }
+    return -1;
+}
+
+static unsigned int hash_rotulo(Rotulo r) {
+    unsigned int h = 2166136261u;
+    for (const char* p = r.prefixo; p && *p; p++) h = (h ^ (unsigned char)*p) * 16777619u;
+    h = (h ^ (unsigned int)r.numero) * 16777619u;
+    for (const char* p = r.sufixo; p && *p; p++) h = (h ^ (unsigned char)*p) * 16777619u;
+    return h;
+}
+
+// Refaz o índice de rótulos (chamado depois de cada compactação).
+static void indexa_rotulos(Janela* j) {
+    int n = j->codigo->num_instrucoes;
+    unsigned int capacidade = 64;
+    while (capacidade < (unsigned int)n * 2) capacidade *= 2;
+    if (capacidade != j->capacidade_indice) {
+        free(j->indice_rotulos);
+        j->indice_rotulos = malloc(capacidade * sizeof(int));
+        if (!j->indice_rotulos) {
+            printf("Erro: Falha de alocação de memória na otimização de janela.\n");
+            exit(1);
+        }
+        j->capacidade_indice = capacidade;
+    }
+    for (unsigned int p = 0; p < capacidade; p++) j->indice_rotulos[p] = -1;
+    for (int i = 0; i < n; i++) {
+        const Instrucao* ins = &j->codigo->instrucoes[i];
+        if (ins->op != OP_ROTULO) continue;
+        unsigned int p = hash_rotulo(ins->rotulo) & (capacidade - 1);
+        while (j->indice_rotulos[p] != -1) p = (p + 1) & (capacidade - 1); // Sondagem linear.
+        j->indice_rotulos[p] = i;
+    }
+}
+
+// Posição da definição do rótulo (-1 se não estiver no código).
+static int busca_rotulo(const Janela* j, Rotulo r) {
+    unsigned int p = hash_rotulo(r) & (j->capacidade_indice - 1);
+    while (j->indice_rotulos[p] != -1) {
+        int i = j->indice_rotulos[p];
+        if (rotulos_iguais(j->codigo->instrucoes[i].rotulo, r)) return i;
+        p = (p + 1) & (j->capacidade_indice - 1);
+    }
+    return -1;
+}
+
+// Indica se o valor atual do temporário 'r' pode ser lido a partir da instrução 'i', seguindo
+// os desvios. Na dúvida (orçamento esgotado, rótulo desconhecido) responde que sim.
+// Temporários não sobrevivem a chamadas nem ao retorno: a geração salva na pilha, antes do
+// 'jal', os que ainda serão usados (e esse 'sw' conta como leitura). As rotinas da biblioteca
+// são a exceção: elas preservam os temporários.
+static int temporario_vivo(const Janela* j, int i, Registrador r, int* orcamento) {
+    for (; i >= 0 && i < j->codigo->num_instrucoes; i++) {
+        if (j->removida[i]) continue;
+        if (--*orcamento < 0) return 1;
+        const Instrucao* ins = &j->codigo->instrucoes[i];
+        switch (ins->op) {
+            case OP_ROTULO: case OP_COMENTARIO: case OP_DIRETIVA: case OP_ASCIIZ:
+                break;
+            case OP_J: {
+                int alvo = busca_rotulo(j, ins->rotulo);
+                if (alvo < 0) return 1;
+                i = alvo; // O laço continua depois do rótulo de destino.
+                break;
+            }
+            case OP_BEQZ: case OP_BNEZ:
+            case OP_BEQ: case OP_BNE: case OP_BLT: case OP_BLE: case OP_BGT: case OP_BGE: {
+                if (le_registrador(ins, r)) return 1;
+                int alvo = busca_rotulo(j, ins->rotulo);
+                if (alvo < 0 || temporario_vivo(j, alvo + 1, r, orcamento)) return 1;
+                break; // Continua pelo caminho em que o desvio não é tomado.
+            }
+            case OP_JAL:
+                if (eh_rotina_da_biblioteca(ins->rotulo)) break;
+                return 0;
+            case OP_JR:
+                return 0;
+            default:
+                if (le_registrador(ins, r)) return 1;
+                if (registrador_escrito(ins) == r) return 0;
+                break;
+        }
+    }
+    return 0; // Fim do código.
+}
+
+static int morto_a_partir_de(const Janela* j, int i, Registrador r) {
+    int orcamento = ORCAMENTO_VIVACIDADE;
+    return !temporario_vivo(j, i, r, &orcamento);
+}
+
+// Troca o registrador de destino de uma instrução (que precisa escrever algum).
+static void muda_destino(Instrucao* ins, Registrador r) {
+    if (ins->op == OP_ADDI || ins->op == OP_ADDIU || ins->op == OP_LW || ins->op == OP_LBU ||
+        ins->op == OP_SLL || ins->op == OP_SRA || ins->op == OP_SRL) ins->rt = r;
+    else ins->rd = r;
+}
+
+static int cabe_em_16_bits(long valor) {
+    return valor >= -32768 && valor <= 32767;
+}
+
+
+// --- Regras ---
+
+// "move r, r" não faz nada.
+static int regra_move_inutil(Janela* j, int i) {
+    Instrucao* ins = &j->codigo->instrucoes[i];
+    if (ins->op != OP_MOVE || ins->rd != ins->rs) return 0;
+    remove_instrucao(j, i);
+    return 1;
+}
+
+// "sw rA, k(b)" seguido de "lw rB, k(b)": o valor já está em rA.
+static int regra_recarga(Janela* j, int i) {
+    Instrucao* sw = &j->codigo->instrucoes[i];
+    if (sw->op != OP_SW) return 0;
+    int k = proxima(j, i);
+    if (k < 0) return 0;
+    Instrucao* lw = &j->codigo->instrucoes[k];
+    if (lw->op != OP_LW || lw->rs != sw->rs || lw->imediato != sw->imediato) return 0;
+    if (lw->rt == sw->rt) {
+        remove_instrucao(j, k);
+    } else {
+        Registrador destino = lw->rt;
+        lw->op = OP_MOVE;
+        lw->rd = destino;
+        lw->rs = sw->rt;
+        lw->rt = REG_ZERO;
+        lw->imediato = 0;
+    }
+    return 1;
+}
+
+// Ajustes consecutivos do mesmo registrador ("addiu $sp, $sp, a" e "addiu $sp, $sp, b")
+// viram um só; um ajuste de zero some.
+static int regra_ajuste_pilha(Janela* j, int i) {
+    Instrucao* a = &j->codigo->instrucoes[i];
+    if (a->op != OP_ADDIU || a->rt != a->rs) return 0;
+    if (a->imediato == 0) {
+        remove_instrucao(j, i);
+        return 1;
+    }
+    int k = proxima(j, i);
+    if (k < 0) return 0;
+    Instrucao* b = &j->codigo->instrucoes[k];
+    if (b->op != OP_ADDIU || b->rt != a->rt || b->rs != a->rt) return 0;
+    long soma = (long)a->imediato + b->imediato;
+    if (!cabe_em_16_bits(soma)) return 0;
+    a->imediato = (int)soma;
+    remove_instrucao(j, k);
+    if (soma == 0) remove_instrucao(j, i);
+    return 1;
+}
+
+// Um desvio ("j" ou condicional) para um rótulo que vem logo em seguida é inútil.
+static int regra_salto_proximo(Janela* j, int i) {
+    Instrucao* ins = &j->codigo->instrucoes[i];
+    if (ins->op != OP_J && !eh_desvio_condicional(ins->op)) return 0;
+    for (int k = proxima(j, i); k >= 0; k = proxima(j, k)) {
+        Instrucao* seguinte = &j->codigo->instrucoes[k];
+        if (seguinte->op != OP_ROTULO) break;
+        if (rotulos_iguais(seguinte->rotulo, ins->rotulo)) {
+            remove_instrucao(j, i);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Instruções entre um salto incondicional ("j" ou "jr") e o próximo rótulo nunca executam.
+static int regra_inalcancavel(Janela* j, int i) {
+    Instrucao* ins = &j->codigo->instrucoes[i];
+    if (ins->op != OP_J && ins->op != OP_JR) return 0;
+    int removeu = 0;
+    for (int k = proxima(j, i); k >= 0; k = proxima(j, k)) {
+        Opcode op = j->codigo->instrucoes[k].op;
+        if (op == OP_ROTULO || op == OP_DIRETIVA || op == OP_ASCIIZ) break;
+        remove_instrucao(j, k);
+        removeu = 1;
+    }
+    return removeu;
+}
+
+// Um desvio para um rótulo cuja primeira instrução é "j M" pode ir direto para M.
+static int regra_desvio_encadeado(Janela* j, int i) {
+    Instrucao* ins = &j->codigo->instrucoes[i];
+    if (ins->op != OP_J && !eh_desvio_condicional(ins->op)) return 0;
+    int alvo = busca_rotulo(j, ins->rotulo);
+    if (alvo < 0) return 0;
+    int k = alvo;
+    do { k = proxima(j, k); } while (k >= 0 && j->codigo->instrucoes[k].op == OP_ROTULO);
+    if (k < 0 || j->codigo->instrucoes[k].op != OP_J) return 0;
+    Rotulo destino = j->codigo->instrucoes[k].rotulo;
+    if (rotulos_iguais(destino, ins->rotulo)) return 0; // Laço infinito ("L: j L").
+    ins->rotulo = destino;
+    return 1;
+}
+
+// "op $tX, ..." seguido de "move rY, $tX", com $tX morto depois: o resultado vai direto para rY.
+// Ex: "lw $t0, -4($fp)" + "move $a0, $t0"  ->  "lw $a0, -4($fp)".
+static int regra_copia(Janela* j, int i) {
+    Instrucao* def = &j->codigo->instrucoes[i];
+    Registrador x = registrador_escrito(def);
+    if (!eh_temporario(x) || def->op == OP_JAL || def->op == OP_SYSCALL) return 0;
+    int k = proxima(j, i);
+    if (k < 0) return 0;
+    Instrucao* mv = &j->codigo->instrucoes[k];
+    if (mv->op != OP_MOVE || mv->rs != x || mv->rd == x) return 0;
+    if (!morto_a_partir_de(j, k + 1, x)) return 0;
+    muda_destino(def, mv->rd);
+    remove_instrucao(j, k);
+    return 1;
+}
+
+// "li $tX, k" seguido de "add rd, rs, $tX" (ou "sub"), com $tX morto depois: usa o imediato.
+// Ex: "li $t1, 1" + "add $t0, $t0, $t1"  ->  "addi $t0, $t0, 1". 'addu' e 'subu', que não
+// param no transbordamento, viram 'addiu'.
+static int regra_imediato(Janela* j, int i) {
+    Instrucao* li = &j->codigo->instrucoes[i];
+    if (li->op != OP_LI || !eh_temporario(li->rd)) return 0;
+    Registrador x = li->rd;
+    int k = proxima(j, i);
+    if (k < 0) return 0;
+    Instrucao* op = &j->codigo->instrucoes[k];
+    Registrador outro;
+    long valor = li->imediato;
+    int soma = op->op == OP_ADD || op->op == OP_ADDU;
+    int modular = op->op == OP_ADDU || op->op == OP_SUBU;
+    if (soma && op->rt == x && op->rs != x) {
+        outro = op->rs;
+    } else if (soma && op->rs == x && op->rt != x) {
+        outro = op->rt;
+    } else if ((op->op == OP_SUB || op->op == OP_SUBU) && op->rt == x && op->rs != x) {
+        outro = op->rs;
+        valor = -valor;
+    } else {
+        return 0;
+    }
+    if (!cabe_em_16_bits(valor)) return 0;
+    if (op->rd != x && !morto_a_partir_de(j, k + 1, x)) return 0;
+    Registrador destino = op->rd;
+    op->op = modular ? OP_ADDIU : OP_ADDI;
+    op->rt = destino;
+    op->rs = outro;
+    op->rd = REG_ZERO;
+    op->imediato = (int)valor;
+    remove_instrucao(j, i);
+    return 1;
+}
+
+// "li $tX, 0" seguido de uma instrução que lê $tX (com $tX morto depois): lê $zero.
+// Ex: "li $t1, 0" + "sne $t0, $t0, $t1"  ->  "sne $t0, $t0, $zero".
+static int regra_zero(Janela* j, int i) {
+    Instrucao* li = &j->codigo->instrucoes[i];
+    if (li->op != OP_LI || li->imediato != 0 || !eh_temporario(li->rd)) return 0;
+    Registrador x = li->rd;
+    int k = proxima(j, i);
+    if (k < 0) return 0;
+    Instrucao* uso = &j->codigo->instrucoes[k];
+    switch (uso->op) {
+        case OP_ADD: case OP_SUB: case OP_ADDU: case OP_SUBU: case OP_MUL: case OP_AND: case OP_OR:
+        case OP_SEQ: case OP_SNE: case OP_SLT: case OP_SLE: case OP_SGT: case OP_SGE:
+        case OP_MOVE: case OP_SW:
+            break;
+        default: // 'div' por zero fica como está; as demais não leem $tX ou usam imediatos.
+            return 0;
+    }
+    if (!le_registrador(uso, x)) return 0;
+    if (uso->op == OP_SW && uso->rs == x) return 0; // Base de endereço: não vale a pena.
+    if (registrador_escrito(uso) != x && !morto_a_partir_de(j, k + 1, x)) return 0;
+    if (uso->rs == x) uso->rs = REG_ZERO;
+    if (uso->rt == x && uso->op != OP_MOVE) uso->rt = REG_ZERO;
+    remove_instrucao(j, i);
+    return 1;
+}
+
+// Tabela de regras, na ordem em que são tentadas em cada posição.
+static const RegraPeephole regras[NUM_REGRAS_PEEPHOLE] = {
+    { "move_inutil",       "remove 'move r, r'",                                   regra_move_inutil },
+    { "recarga",           "remove o 'lw' do endereço que acabou de ser escrito",  regra_recarga },
+    { "ajuste_pilha",      "junta ajustes consecutivos de $sp",                    regra_ajuste_pilha },
+    { "salto_proximo",     "remove desvios para o rótulo seguinte",                regra_salto_proximo },
+    { "inalcancavel",      "remove instruções depois de um salto incondicional",   regra_inalcancavel },
+    { "desvio_encadeado",  "desvia direto para o destino final de um 'j'",         regra_desvio_encadeado },
+    { "copia",             "calcula direto no destino de um 'move'",               regra_copia },
+    { "imediato",          "troca 'li' + 'add'/'sub' por 'addi'",                  regra_imediato },
+    { "zero",              "usa $zero no lugar de um temporário carregado com 0",  regra_zero },
+};
+
+
+// --- Interface ---
+
+int peephole_indice_regra(const char* nome) {
+    for (int r = 0; r < NUM_REGRAS_PEEPHOLE; r++) {
+        if (strcmp(regras[r].nome, nome) == 0) return r;
+    }
+    return -1;
+}
+
+const char* peephole_nome_regra(int indice) {
+    return regras[indice].nome;
+}
+
+const char* peephole_descricao_regra(int indice) {
+    return regras[indice].descricao;
+}
+
+// Descarta as instruções marcadas, mantendo a ordem das demais.
+static void compacta(Janela* j) {
+    int n = 0;
+    for (int i = 0; i < j->codigo->num_instrucoes; i++) {
+        if (!j->removida[i]) j->codigo->instrucoes[n++] = j->codigo->instrucoes[i];
+        j->removida[i] = 0;
+    }
+    j->codigo->num_instrucoes = n;
+}
+
+void otimiza_peephole(CodigoMips* codigo, unsigned int regras_ativas) {
+    for (int r = 0; r < NUM_REGRAS_PEEPHOLE; r++) aplicacoes[r] = removidas[r] = 0;
+    instrucoes_antes = conta_instrucoes(codigo);
+
+    Janela j = { codigo, NULL, NULL, 0 };
+    j.removida = calloc(codigo->num_instrucoes + 1, 1);
+    if (!j.removida) {
+        printf("Erro: Falha de alocação de memória na otimização de janela.\n");
+        exit(1);
+    }
+
+    // Uma reescrita pode criar oportunidades para outra (ex: um salto removido deixa dois
+    // ajustes de $sp vizinhos), então as varreduras se repetem até nada mudar.
+    int mudou = 1;
+    while (mudou) {
+        mudou = 0;
+        indexa_rotulos(&j);
+        for (int i = 0; i < codigo->num_instrucoes; i++) {
+            for (int r = 0; r < NUM_REGRAS_PEEPHOLE && !j.removida[i]; r++) {
+                if (!(regras_ativas & (1u << r))) continue;
+                regra_atual = r;
+                if (regras[r].aplica(&j, i)) {
+                    aplicacoes[r]++;
+                    mudou = 1;
+                }
+            }
+        }
+        compacta(&j);
+    }
+    free(j.removida);
+    free(j.indice_rotulos);
+
+    instrucoes_depois = conta_instrucoes(codigo);
+}
+
+void imprime_estatisticas_peephole(void) {
+    printf("--- Otimização de Janela (peephole) ---\n");
+    for (int r = 0; r < NUM_REGRAS_PEEPHOLE; r++) {
+        printf("  %-17s %6d aplicação(ões), %6d instrução(ões) removida(s)\n",
+               regras[r].nome, aplicacoes[r], removidas[r]);
+    }
+    printf("  Total: %d -> %d instruções\n", instrucoes_antes, instrucoes_depois);
+    printf("---------------------------------------\n");
+}
@@ -0,0 +1,30 @@
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include "emissor.h"
+
+// --- Otimização de Janela (Peephole) sobre o Código MIPS ---
+// Depois que toda a geração terminou, e antes de o código ser escrito, esta passada percorre
+// o vetor de instruções procurando pequenos trechos (uma "janela" de duas ou três instruções
+// vizinhas) que podem ser trocados por algo mais curto: um 'lw' logo depois do 'sw' do mesmo
+// endereço, ajustes de $sp consecutivos, um salto para o rótulo seguinte, etc.
+// Cada regra da tabela pode ser desligada individualmente (veja peephole_indice_regra).
+
+#define NUM_REGRAS_PEEPHOLE 9
+#define TODAS_AS_REGRAS_PEEPHOLE ((1u << NUM_REGRAS_PEEPHOLE) - 1)
+
+// Retorna o índice da regra com esse nome (-1 se não existir). O bit (1u << índice) da
+// máscara passada a otimiza_peephole liga a regra.
+int peephole_indice_regra(const char* nome);
+
+// Nome e descrição da regra 'indice' (para a mensagem de uso).
+const char* peephole_nome_regra(int indice);
+const char* peephole_descricao_regra(int indice);
+
+// Aplica as regras ligadas em 'regras_ativas' até que nenhuma encontre mais o que fazer.
+void otimiza_peephole(CodigoMips* codigo, unsigned int regras_ativas);
+
+// Imprime quantas vezes cada regra foi aplicada e quantas instruções ela removeu.
+void imprime_estatisticas_peephole(void);
+
+#endif // PEEPHOLE_H
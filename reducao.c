@@ -0,0 +1,213 @@
+#include <stdio.h>
+#include <limits.h>     // Para INT_MIN.
+#include "reducao.h"
+
+// Máximo de instruções que substituem uma multiplicação: as mesmas duas de "li" + "mul", mas
+// sem a espera pelo multiplicador.
+#define LIMITE_OPERACOES 2
+
+static EstatisticasReducao estatisticas;
+
+static FuncaoIR* funcao;        // A função sendo transformada (para criar temporários).
+
+// Devolve k se 'n' é 2^k, ou -1 se 'n' não é uma potência de 2.
+static int expoente(unsigned int n) {
+    if (n == 0 || (n & (n - 1)) != 0) return -1;
+    int k = 0;
+    while (n > 1) {
+        n >>= 1;
+        k++;
+    }
+    return k;
+}
+
+static int mesmo_operando(Operando x, Operando y) {
+    return x.tipo == y.tipo && x.valor == y.valor && x.var == y.var;
+}
+
+static int constante_valendo(Operando o, int valor) {
+    return o.tipo == OPERANDO_CONST && o.valor == valor;
+}
+
+// Insere antes de 'posicao' a instrução "t = a operador b", com um temporário novo, e devolve t.
+static Operando insere(BlocoBasico* bloco, InstrucaoIR* posicao, OperadorIR operador, Operando a, Operando b) {
+    InstrucaoIR* ins = ir_insere_antes(bloco, posicao, IR_BINARIO);
+    ins->operador = operador;
+    ins->destino = ir_novo_temp(funcao);
+    ins->a = a;
+    ins->b = b;
+    return ins->destino;
+}
+
+// A própria instrução passa a ser a última da sequência: "destino = a operador b".
+static void reescreve(InstrucaoIR* ins, OperadorIR operador, Operando a, Operando b) {
+    ins->operador = operador;
+    ins->a = a;
+    ins->b = b;
+}
+
+static void vira_copia(InstrucaoIR* ins, Operando a) {
+    ins->op = IR_COPIA;
+    ins->a = a;
+    ins->b = ir_nenhum();
+    estatisticas.identidades_aplicadas++;
+}
+
+// Um operando que a sequência lê mais de uma vez. Uma variável é lida uma vez só, para um
+// temporário (se ela estiver na memória, cada leitura seria um 'lw').
+static Operando le_uma_vez(BlocoBasico* bloco, InstrucaoIR* posicao, Operando x) {
+    if (x.tipo != OPERANDO_VAR) return x;
+    InstrucaoIR* copia = ir_insere_antes(bloco, posicao, IR_COPIA);
+    copia->destino = ir_novo_temp(funcao);
+    copia->a = x;
+    return copia->destino;
+}
+
+
+// --- Multiplicação ---
+// x * 2^k = x << k; x * (2^a + 2^b) = (x << a) + (x << b); x * (2^a - 2^b) = (x << a) - (x << b).
+// Com a constante negativa, a subtração tem os operandos trocados ou o resultado é subtraído de 0.
+// As somas e subtrações são modulares ('addu'/'subu'): 'mul' nunca para o programa, e x << a
+// pode transbordar mesmo quando o produto cabe em 32 bits (x * 7 = (x << 3) - x).
+
+static int reduz_multiplicacao(BlocoBasico* bloco, InstrucaoIR* ins) {
+    Operando x;
+    int c;
+    if (ins->b.tipo == OPERANDO_CONST) {
+        x = ins->a;
+        c = ins->b.valor;
+    } else if (ins->a.tipo == OPERANDO_CONST) {
+        x = ins->b;
+        c = ins->a.valor;
+    } else {
+        return 0;
+    }
+    if (c == 0) { vira_copia(ins, ir_const(0)); return 1; }
+    if (c == 1) { vira_copia(ins, x); return 1; }
+
+    int negativo = c < 0;
+    unsigned int m = negativo ? 0u - (unsigned int)c : (unsigned int)c;
+    int k = expoente(m);
+    if (k >= 0) {
+        if (!negativo) {
+            reescreve(ins, OPR_DESLOCA_ESQUERDA, x, ir_const(k));
+        } else {
+            Operando t = k > 0 ? insere(bloco, ins, OPR_DESLOCA_ESQUERDA, x, ir_const(k)) : x;
+            reescreve(ins, OPR_SUBTRACAO_MODULAR, ir_const(0), t);
+        }
+        estatisticas.multiplicacoes_trocadas++;
+        return 1;
+    }
+
+    // Dois termos: 2^b é o bit mais baixo de m, e 2^a o que sobra (soma) ou o que completa m
+    // até a potência de 2 seguinte (subtração).
+    unsigned int baixo = m & (0u - m);
+    int b = expoente(baixo);
+    int soma = expoente(m - baixo) >= 0;
+    int a = soma ? expoente(m - baixo) : expoente(m + baixo);
+    if (a < 0) return 0;
+    int operacoes = 2 + (b > 0) + (x.tipo == OPERANDO_VAR) + (negativo && soma);
+    if (operacoes > LIMITE_OPERACOES) return 0;
+
+    x = le_uma_vez(bloco, ins, x);
+    Operando alto = insere(bloco, ins, OPR_DESLOCA_ESQUERDA, x, ir_const(a));
+    Operando resto = b > 0 ? insere(bloco, ins, OPR_DESLOCA_ESQUERDA, x, ir_const(b)) : x;
+    if (soma && negativo) {
+        Operando t = insere(bloco, ins, OPR_SOMA_MODULAR, alto, resto);
+        reescreve(ins, OPR_SUBTRACAO_MODULAR, ir_const(0), t);
+    } else if (soma) {
+        reescreve(ins, OPR_SOMA_MODULAR, alto, resto);
+    } else if (negativo) {
+        reescreve(ins, OPR_SUBTRACAO_MODULAR, resto, alto);
+    } else {
+        reescreve(ins, OPR_SUBTRACAO_MODULAR, alto, resto);
+    }
+    estatisticas.multiplicacoes_trocadas++;
+    return 1;
+}
+
+
+// --- Divisão ---
+// O deslocamento aritmético x >> k arredonda para baixo; 'div' trunca em direção a zero. Para
+// x negativo, somar 2^k - 1 antes de deslocar corrige a diferença. O valor somado é obtido sem
+// desvios: x >> 31 vale -1 (todos os bits 1) se x < 0 e 0 caso contrário, e deslocá-lo 32 - k
+// bits para a direita, entrando zeros, deixa só os k bits de baixo: 2^k - 1 ou 0.
+
+static int reduz_divisao(BlocoBasico* bloco, InstrucaoIR* ins) {
+    if (ins->b.tipo != OPERANDO_CONST || ins->b.valor == 0 || ins->b.valor == INT_MIN) return 0;
+    int c = ins->b.valor;
+    Operando x = ins->a;
+    if (c == 1) { vira_copia(ins, x); return 1; }
+    if (c == -1) {
+        reescreve(ins, OPR_SUBTRACAO_MODULAR, ir_const(0), x);
+        estatisticas.identidades_aplicadas++;
+        return 1;
+    }
+    int negativo = c < 0;
+    int k = expoente((unsigned int)(negativo ? -c : c));
+    if (k < 0) return 0;
+
+    x = le_uma_vez(bloco, ins, x);
+    Operando correcao;
+    if (k == 1) {
+        correcao = insere(bloco, ins, OPR_DESLOCA_DIREITA_LOGICO, x, ir_const(31));
+    } else {
+        Operando sinal = insere(bloco, ins, OPR_DESLOCA_DIREITA, x, ir_const(31));
+        correcao = insere(bloco, ins, OPR_DESLOCA_DIREITA_LOGICO, sinal, ir_const(32 - k));
+    }
+    Operando corrigido = insere(bloco, ins, OPR_SOMA_MODULAR, x, correcao);
+    if (negativo) {
+        Operando t = insere(bloco, ins, OPR_DESLOCA_DIREITA, corrigido, ir_const(k));
+        reescreve(ins, OPR_SUBTRACAO_MODULAR, ir_const(0), t);
+    } else {
+        reescreve(ins, OPR_DESLOCA_DIREITA, corrigido, ir_const(k));
+    }
+    estatisticas.divisoes_trocadas++;
+    return 1;
+}
+
+
+static void reduz_instrucao(BlocoBasico* bloco, InstrucaoIR* ins) {
+    switch (ins->operador) {
+        case OPR_MULTIPLICACAO:
+            reduz_multiplicacao(bloco, ins);
+            break;
+        case OPR_DIVISAO:
+            reduz_divisao(bloco, ins);
+            break;
+        case OPR_SOMA:
+            if (constante_valendo(ins->b, 0)) vira_copia(ins, ins->a);
+            else if (constante_valendo(ins->a, 0)) vira_copia(ins, ins->b);
+            break;
+        case OPR_SUBTRACAO:
+            if (constante_valendo(ins->b, 0)) vira_copia(ins, ins->a);
+            else if (ins->a.tipo != OPERANDO_CONST && mesmo_operando(ins->a, ins->b)) vira_copia(ins, ir_const(0));
+            break;
+        default:
+            break;
+    }
+}
+
+EstatisticasReducao reduz_forca(ProgramaIR* programa) {
+    EstatisticasReducao zeradas = {0};
+    estatisticas = zeradas;
+    for (int f = 0; f < programa->num_funcoes; f++) {
+        funcao = programa->funcoes[f];
+        for (int i = 0; i < funcao->num_blocos; i++) {
+            BlocoBasico* bloco = funcao->blocos[i];
+            // As instruções novas entram antes da reduzida: o percurso não as visita.
+            for (InstrucaoIR* ins = bloco->primeira; ins; ins = ins->proxima) {
+                if (ins->op == IR_BINARIO) reduz_instrucao(bloco, ins);
+            }
+        }
+    }
+    funcao = NULL;
+    return estatisticas;
+}
+
+void imprime_estatisticas_reducao(void) {
+    printf("Redução de força: %d multiplicação(ões) e %d divisão(ões) trocada(s) por deslocamentos, "
+           "%d identidade(s) aplicada(s).\n",
+           estatisticas.multiplicacoes_trocadas, estatisticas.divisoes_trocadas,
+           estatisticas.identidades_aplicadas);
+}
@@ -0,0 +1,29 @@
+#ifndef REDUCAO_H
+#define REDUCAO_H
+
+#include "ir.h"
+
+// --- Redução de Força (-O1) ---
+// Passada sobre o código intermediário, logo antes da geração de código MIPS (depois das
+// demais otimizações, que podem ter descoberto operandos constantes). Em cada instrução:
+//  - multiplicações por constantes que custam no máximo duas instruções em deslocamentos,
+//    somas e subtrações (±2^k, 2^a + 1, 2^a - 1, 1 - 2^a) deixam de usar 'mul';
+//  - divisões por ±2^k viram deslocamentos aritméticos, com a correção que faz o resultado de
+//    um dividendo negativo ser truncado em direção a zero, como o de 'div';
+//  - as identidades x+0, x-0, x*1, x/1 (que viram cópias), x*0 e x-x (que viram 0) são
+//    aplicadas ao que ainda restar delas.
+
+// Contadores do que a passada fez (para o relatório).
+typedef struct EstatisticasReducao {
+    int multiplicacoes_trocadas; // Multiplicações feitas com deslocamentos, somas e subtrações.
+    int divisoes_trocadas;       // Divisões feitas com deslocamentos.
+    int identidades_aplicadas;   // Operações trocadas por uma cópia.
+} EstatisticasReducao;
+
+// Reduz as operações de todas as funções do programa e devolve o que foi feito.
+EstatisticasReducao reduz_forca(ProgramaIR* programa);
+
+// Imprime o relatório da última execução.
+void imprime_estatisticas_reducao(void);
+
+#endif // REDUCAO_H
@@ -0,0 +1,700 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ssa.h"
+#include "tabela_simbolos.h"
+
+static EstatisticasSSA estatisticas;
+
+// A função sendo transformada e o programa dono dela (para criar blocos).
+static ProgramaIR* programa;
+static FuncaoIR* funcao;
+
+static void* aloca_zerado(int n, size_t tamanho) {
+    void* v = calloc(n ? n : 1, tamanho);
+    if (!v) {
+        fprintf(stderr, "Erro: Falha de alocação de memória na otimização SSA.\n");
+        exit(1);
+    }
+    return v;
+}
+
+static void* cresce_vetor(void* vetor, int* capacidade, size_t tamanho_elemento) {
+    *capacidade = *capacidade ? *capacidade * 2 : 8;
+    vetor = realloc(vetor, *capacidade * tamanho_elemento);
+    if (!vetor) {
+        fprintf(stderr, "Erro: Falha de alocação de memória na otimização SSA.\n");
+        exit(1);
+    }
+    return vetor;
+}
+
+// Lista de blocos que cresce (filhos na árvore de dominadores, fronteira de dominância, ...).
+typedef struct ListaBlocos {
+    BlocoBasico** itens;
+    int num;
+    int capacidade;
+} ListaBlocos;
+
+static void acrescenta_bloco(ListaBlocos* lista, BlocoBasico* b) {
+    if (lista->num == lista->capacidade) {
+        lista->itens = cresce_vetor(lista->itens, &lista->capacidade, sizeof(BlocoBasico*));
+    }
+    lista->itens[lista->num++] = b;
+}
+
+static void libera_listas(ListaBlocos* listas, int n) {
+    for (int i = 0; i < n; i++) free(listas[i].itens);
+    free(listas);
+}
+
+// Por índice de bloco: os filhos na árvore de dominadores e a fronteira de dominância (os
+// blocos onde o domínio do bloco termina, ou seja, onde caminhos vindos dele encontram
+// caminhos que não passam por ele).
+static ListaBlocos* filhos;
+static ListaBlocos* fronteira;
+
+static void calcula_arvore_dominadores(void) {
+    int n = funcao->num_blocos;
+    ir_calcula_dominadores(funcao);
+    filhos = aloca_zerado(n, sizeof(ListaBlocos));
+    fronteira = aloca_zerado(n, sizeof(ListaBlocos));
+    for (int i = 1; i < n; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        acrescenta_bloco(&filhos[b->dominador->indice], b);
+    }
+    // Cooper, Harvey e Kennedy: de cada predecessor de um ponto de junção, sobe pela árvore até
+    // o dominador imediato da junção; todos os blocos do caminho têm a junção na fronteira.
+    for (int i = 0; i < n; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        if (b->num_predecessores < 2) continue;
+        for (int p = 0; p < b->num_predecessores; p++) {
+            for (BlocoBasico* r = b->predecessores[p]; r != b->dominador; r = r->dominador) {
+                ListaBlocos* df = &fronteira[r->indice];
+                if (df->num == 0 || df->itens[df->num - 1] != b) acrescenta_bloco(df, b);
+            }
+        }
+    }
+}
+
+
+// --- Nomes Renomeados ---
+// Viram valores SSA as variáveis locais da função (numeradas em Vinculo.numero_ssa) e os
+// temporários escritos em mais de um lugar. Cada um é um "nome", de 0 a num_nomes - 1.
+
+static int num_nomes;
+static Operando* origem_nome;       // Por nome: a variável ou o temporário original.
+static int num_temporarios_originais;
+static int* nome_do_temporario;     // Por temporário original: o nome, ou -1.
+
+static int nome_de(Operando o) {
+    if (o.tipo == OPERANDO_VAR) return o.var->numero_ssa - 1;
+    if (o.tipo == OPERANDO_TEMP && o.valor < num_temporarios_originais) return nome_do_temporario[o.valor];
+    return -1;
+}
+
+static void prepara_nomes(void) {
+    num_temporarios_originais = funcao->num_temporarios;
+    int* definicoes = aloca_zerado(num_temporarios_originais, sizeof(int));
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        for (InstrucaoIR* ins = funcao->blocos[i]->primeira; ins; ins = ins->proxima) {
+            if (ins->destino.tipo == OPERANDO_TEMP) definicoes[ins->destino.valor]++;
+        }
+    }
+
+    num_nomes = funcao->num_variaveis;
+    nome_do_temporario = aloca_zerado(num_temporarios_originais, sizeof(int));
+    for (int t = 0; t < num_temporarios_originais; t++) {
+        nome_do_temporario[t] = definicoes[t] > 1 ? num_nomes++ : -1;
+    }
+    origem_nome = aloca_zerado(num_nomes, sizeof(Operando));
+    for (int v = 0; v < funcao->num_variaveis; v++) {
+        funcao->variaveis[v]->numero_ssa = v + 1;
+        origem_nome[v] = ir_var(funcao->variaveis[v]);
+    }
+    for (int t = 0; t < num_temporarios_originais; t++) {
+        if (nome_do_temporario[t] >= 0) origem_nome[nome_do_temporario[t]] = (Operando){ OPERANDO_TEMP, t, NULL };
+    }
+    free(definicoes);
+}
+
+
+// --- Colocação das Funções Fi ---
+// SSA semipodado (Briggs): só recebem fi os nomes lidos em algum bloco antes de serem escritos
+// nele, porque só esses podem ter o valor vindo de outro bloco. A entrada conta como uma
+// definição de todos os nomes (o valor inicial).
+
+static void coloca_fis(void) {
+    int n = funcao->num_blocos;
+    char* global = aloca_zerado(num_nomes, 1);
+    ListaBlocos* definidores = aloca_zerado(num_nomes, sizeof(ListaBlocos));
+    int* definido_em = aloca_zerado(num_nomes, sizeof(int));    // Último bloco que escreveu o nome.
+    for (int k = 0; k < num_nomes; k++) acrescenta_bloco(&definidores[k], funcao->blocos[0]);
+
+    for (int i = 0; i < n; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        for (InstrucaoIR* ins = b->primeira; ins; ins = ins->proxima) {
+            int la = nome_de(ins->a), lb = nome_de(ins->b), d = nome_de(ins->destino);
+            if (la >= 0 && definido_em[la] != i) global[la] = 1;
+            if (lb >= 0 && definido_em[lb] != i) global[lb] = 1;
+            if (d >= 0 && definido_em[d] != i) {
+                definido_em[d] = i;
+                acrescenta_bloco(&definidores[d], b);
+            }
+        }
+        int lv = nome_de(b->valor), lv2 = nome_de(b->valor2);
+        if (lv >= 0 && definido_em[lv] != i) global[lv] = 1;
+        if (lv2 >= 0 && definido_em[lv2] != i) global[lv2] = 1;
+    }
+
+    // Fronteira de dominância iterada, com uma lista de trabalho por nome.
+    int* tem_fi = aloca_zerado(n, sizeof(int));
+    int* na_lista = aloca_zerado(n, sizeof(int));
+    ListaBlocos trabalho = { NULL, 0, 0 };
+    for (int k = 0; k < num_nomes; k++) {
+        if (!global[k]) continue;
+        for (int j = 0; j < definidores[k].num; j++) {
+            na_lista[definidores[k].itens[j]->indice] = k + 1;
+            acrescenta_bloco(&trabalho, definidores[k].itens[j]);
+        }
+        while (trabalho.num > 0) {
+            BlocoBasico* b = trabalho.itens[--trabalho.num];
+            for (int j = 0; j < fronteira[b->indice].num; j++) {
+                BlocoBasico* d = fronteira[b->indice].itens[j];
+                if (tem_fi[d->indice] == k + 1) continue;
+                tem_fi[d->indice] = k + 1;
+                InstrucaoIR* fi = ir_insere_fi(d, origem_nome[k]);
+                fi->a = origem_nome[k];
+                estatisticas.funcoes_fi++;
+                if (na_lista[d->indice] != k + 1) {
+                    na_lista[d->indice] = k + 1;
+                    acrescenta_bloco(&trabalho, d);
+                }
+            }
+        }
+    }
+    free(trabalho.itens);
+    free(tem_fi);
+    free(na_lista);
+    free(definido_em);
+    libera_listas(definidores, num_nomes);
+    free(global);
+}
+
+
+// --- Renomeação ---
+// Percorre a árvore de dominadores com a versão atual de cada nome. Ao sair de um bloco, as
+// versões que ele definiu são desfeitas (como os escopos da tabela de símbolos).
+
+static Operando* versao_atual;
+
+typedef struct Troca {
+    int nome;
+    Operando anterior;
+} Troca;
+
+static Troca* trocas;
+static int num_trocas, capacidade_trocas;
+
+static void define_versao(int nome, Operando versao) {
+    if (num_trocas == capacidade_trocas) trocas = cresce_vetor(trocas, &capacidade_trocas, sizeof(Troca));
+    trocas[num_trocas].nome = nome;
+    trocas[num_trocas].anterior = versao_atual[nome];
+    num_trocas++;
+    versao_atual[nome] = versao;
+}
+
+static Operando renomeia_uso(Operando o) {
+    int nome = nome_de(o);
+    return nome >= 0 ? versao_atual[nome] : o;
+}
+
+static int indice_predecessor(const BlocoBasico* b, const BlocoBasico* pred) {
+    for (int p = 0; p < b->num_predecessores; p++) {
+        if (b->predecessores[p] == pred) return p;
+    }
+    return -1;
+}
+
+static void renomeia(BlocoBasico* b) {
+    int marca = num_trocas;
+    for (InstrucaoIR* ins = b->primeira; ins; ins = ins->proxima) {
+        if (ins->op == IR_FI) {
+            ins->destino = ir_novo_temp(funcao);
+            define_versao(nome_de(ins->a), ins->destino);
+            continue;
+        }
+        ins->a = renomeia_uso(ins->a);
+        ins->b = renomeia_uso(ins->b);
+        int nome = nome_de(ins->destino);
+        if (nome >= 0) {
+            ins->destino = ir_novo_temp(funcao);
+            define_versao(nome, ins->destino);
+        }
+    }
+    b->valor = renomeia_uso(b->valor);
+    b->valor2 = renomeia_uso(b->valor2);
+
+    for (int s = 0; s < 2; s++) {
+        BlocoBasico* suc = b->sucessores[s];
+        if (!suc) continue;
+        int p = indice_predecessor(suc, b);
+        for (InstrucaoIR* fi = suc->primeira; fi && fi->op == IR_FI; fi = fi->proxima) {
+            fi->fontes[p] = versao_atual[nome_de(fi->a)];
+        }
+    }
+    for (int f = 0; f < filhos[b->indice].num; f++) renomeia(filhos[b->indice].itens[f]);
+
+    while (num_trocas > marca) {
+        num_trocas--;
+        versao_atual[trocas[num_trocas].nome] = trocas[num_trocas].anterior;
+    }
+}
+
+// Os parâmetros chegam do chamador: a entrada os lê uma vez para os temporários iniciais. As
+// demais variáveis começam valendo 0. Nas do bloco principal é o valor certo: a área global
+// ainda não foi escrita, e o MARS começa com a memória zerada. Nas locais de uma função, ler
+// antes de escrever dá o que sobrou na pilha, um valor com que o programa não pode contar, e 0
+// serve tanto quanto qualquer outro.
+static void converte_para_ssa(void) {
+    prepara_nomes();
+    coloca_fis();
+
+    versao_atual = aloca_zerado(num_nomes, sizeof(Operando));
+    Operando* iniciais = aloca_zerado(funcao->num_variaveis, sizeof(Operando));
+    for (int k = 0; k < num_nomes; k++) {
+        versao_atual[k] = ir_const(0);
+        if (k < funcao->num_variaveis && funcao->variaveis[k]->classe == ARMAZ_PARAMETRO) {
+            versao_atual[k] = iniciais[k] = ir_novo_temp(funcao);
+        }
+    }
+    renomeia(funcao->blocos[0]);
+    // As leituras só entram agora: a renomeação trocaria o parâmetro lido pela versão.
+    BlocoBasico* entrada = funcao->blocos[0];
+    for (int k = funcao->num_variaveis - 1; k >= 0; k--) {
+        if (iniciais[k].tipo == OPERANDO_NENHUM) continue;
+        InstrucaoIR* ins = ir_insere_antes(entrada, entrada->primeira, IR_COPIA);
+        ins->destino = iniciais[k];
+        ins->a = origem_nome[k];
+    }
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        for (InstrucaoIR* fi = funcao->blocos[i]->primeira; fi && fi->op == IR_FI; fi = fi->proxima) {
+            fi->a = ir_nenhum();
+        }
+    }
+    free(iniciais);
+    free(versao_atual);
+    free(trocas);
+    trocas = NULL;
+    num_trocas = capacidade_trocas = 0;
+}
+
+
+// --- Numeração de Valores ---
+// Percorre a árvore de dominadores (Briggs, Cooper e Simpson). Na forma SSA cada temporário
+// tem um único valor, então um cálculo "a op b" já feito num bloco dominante está disponível
+// em todos os blocos dominados. A tabela guarda esses cálculos e, como a renomeação, desfaz ao
+// sair de um bloco o que ele acrescentou.
+
+typedef struct Expressao {
+    OperadorIR operador;
+    Operando a, b;
+    Operando valor;             // Temporário que guarda o resultado.
+    int anterior;               // Próxima expressão do mesmo balde (-1 = fim).
+} Expressao;
+
+static Expressao* expressoes;
+static int num_expressoes, capacidade_expressoes;
+static int* baldes;
+static int num_baldes;          // Potência de 2.
+static Operando* substituto;    // Por temporário: o valor que o substitui (nenhum = ele mesmo).
+
+static Operando valor_de(Operando o) {
+    if (o.tipo == OPERANDO_TEMP && substituto[o.valor].tipo != OPERANDO_NENHUM) return substituto[o.valor];
+    return o;
+}
+
+static int mesmo_operando(Operando x, Operando y) {
+    return x.tipo == y.tipo && x.valor == y.valor && x.var == y.var;
+}
+
+static int compara_operandos(Operando x, Operando y) {
+    if (x.tipo != y.tipo) return x.tipo < y.tipo ? -1 : 1;
+    return x.valor < y.valor ? -1 : x.valor > y.valor;
+}
+
+// Forma canônica de "a op b": operandos dos operadores comutativos em ordem, e '>'/'>=' como
+// '<'/'<=' com os operandos trocados. Assim "x + y" e "y + x" caem na mesma entrada.
+static void forma_canonica(const InstrucaoIR* ins, Expressao* e) {
+    e->operador = ins->operador;
+    e->a = ins->a;
+    e->b = ins->b;
+    switch (e->operador) {
+        case OPR_MAIOR:
+        case OPR_MAIOR_IGUAL:
+            e->operador = e->operador == OPR_MAIOR ? OPR_MENOR : OPR_MENOR_IGUAL;
+            e->a = ins->b;
+            e->b = ins->a;
+            break;
+        case OPR_SOMA: case OPR_SOMA_MODULAR: case OPR_MULTIPLICACAO: case OPR_IGUAL: case OPR_DIFERENTE:
+            if (compara_operandos(e->a, e->b) > 0) {
+                e->a = ins->b;
+                e->b = ins->a;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static int balde(const Expressao* e) {
+    unsigned int h = (unsigned int)e->operador;
+    h = h * 31u + (unsigned int)e->a.tipo * 7u + (unsigned int)e->a.valor;
+    h = h * 31u + (unsigned int)e->b.tipo * 7u + (unsigned int)e->b.valor;
+    return (int)(h & (unsigned int)(num_baldes - 1));
+}
+
+static int procura_expressao(const Expressao* e) {
+    for (int k = baldes[balde(e)]; k >= 0; k = expressoes[k].anterior) {
+        if (expressoes[k].operador == e->operador && mesmo_operando(expressoes[k].a, e->a)
+            && mesmo_operando(expressoes[k].b, e->b)) {
+            return k;
+        }
+    }
+    return -1;
+}
+
+static void insere_expressao(Expressao e) {
+    if (num_expressoes == capacidade_expressoes) {
+        expressoes = cresce_vetor(expressoes, &capacidade_expressoes, sizeof(Expressao));
+    }
+    int h = balde(&e);
+    e.anterior = baldes[h];
+    expressoes[num_expressoes] = e;
+    baldes[h] = num_expressoes++;
+}
+
+// Um fi cujas fontes são todas o mesmo valor (ou o próprio fi, numa volta de laço que não
+// muda o nome) não escolhe nada. As fontes das arestas de volta ainda não foram numeradas,
+// então são comparadas como estão: a conclusão pode falhar, mas nunca ser errada.
+static int fi_inutil(const BlocoBasico* b, const InstrucaoIR* fi, Operando* unico) {
+    *unico = ir_nenhum();
+    for (int p = 0; p < b->num_predecessores; p++) {
+        Operando f = valor_de(fi->fontes[p]);
+        if (mesmo_operando(f, fi->destino)) continue;
+        if (unico->tipo == OPERANDO_NENHUM) *unico = f;
+        else if (!mesmo_operando(f, *unico)) return 0;
+    }
+    return unico->tipo != OPERANDO_NENHUM;
+}
+
+static void numera_valores(BlocoBasico* b) {
+    int marca = num_expressoes;
+    InstrucaoIR* proxima;
+    for (InstrucaoIR* ins = b->primeira; ins; ins = proxima) {
+        proxima = ins->proxima;
+        Operando valor;
+        if (ins->op == IR_FI) {
+            if (fi_inutil(b, ins, &valor)) {
+                substituto[ins->destino.valor] = valor;
+                ir_remove_instrucao(b, ins);
+            }
+            continue;
+        }
+        ins->a = valor_de(ins->a);
+        ins->b = valor_de(ins->b);
+        // Leituras de variáveis globais não entram: o valor pode mudar entre duas leituras.
+        if (ins->destino.tipo != OPERANDO_TEMP || ins->a.tipo == OPERANDO_VAR || ins->b.tipo == OPERANDO_VAR) {
+            continue;
+        }
+        if (ins->op == IR_COPIA) {
+            substituto[ins->destino.valor] = ins->a;
+            ir_remove_instrucao(b, ins);
+            estatisticas.copias_propagadas++;
+        } else if (ins->op == IR_BINARIO) {
+            int resultado;
+            Expressao e;
+            forma_canonica(ins, &e);
+            int k;
+            if (ins->a.tipo == OPERANDO_CONST && ins->b.tipo == OPERANDO_CONST
+                && ir_calcula(ins->operador, ins->a.valor, ins->b.valor, &resultado)) {
+                substituto[ins->destino.valor] = ir_const(resultado);
+                ir_remove_instrucao(b, ins);
+                estatisticas.operacoes_dobradas++;
+            } else if ((k = procura_expressao(&e)) >= 0) {
+                substituto[ins->destino.valor] = expressoes[k].valor;
+                ir_remove_instrucao(b, ins);
+                estatisticas.expressoes_redundantes++;
+            } else {
+                e.valor = ins->destino;
+                insere_expressao(e);
+            }
+        }
+    }
+    b->valor = valor_de(b->valor);
+    b->valor2 = valor_de(b->valor2);
+
+    for (int s = 0; s < 2; s++) {
+        BlocoBasico* suc = b->sucessores[s];
+        if (!suc) continue;
+        int p = indice_predecessor(suc, b);
+        for (InstrucaoIR* fi = suc->primeira; fi && fi->op == IR_FI; fi = fi->proxima) {
+            fi->fontes[p] = valor_de(fi->fontes[p]);
+        }
+    }
+    for (int f = 0; f < filhos[b->indice].num; f++) numera_valores(filhos[b->indice].itens[f]);
+
+    while (num_expressoes > marca) {
+        num_expressoes--;
+        baldes[balde(&expressoes[num_expressoes])] = expressoes[num_expressoes].anterior;
+    }
+}
+
+static void numeracao_de_valores(void) {
+    int num_instrucoes = 0;
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        for (InstrucaoIR* ins = funcao->blocos[i]->primeira; ins; ins = ins->proxima) num_instrucoes++;
+    }
+    num_baldes = 16;
+    while (num_baldes < 2 * num_instrucoes) num_baldes *= 2;
+    baldes = aloca_zerado(num_baldes, sizeof(int));
+    for (int h = 0; h < num_baldes; h++) baldes[h] = -1;
+    substituto = aloca_zerado(funcao->num_temporarios, sizeof(Operando));
+
+    numera_valores(funcao->blocos[0]);
+
+    free(substituto);
+    free(baldes);
+    free(expressoes);
+    expressoes = NULL;
+    num_expressoes = capacidade_expressoes = 0;
+}
+
+
+// --- Remoção de Código Morto ---
+// Cópias, operações e fis cujo destino ninguém lê são removidos, até não sobrar nenhum (remover
+// um pode deixar sem uso os operandos dele). Uma chamada sem uso do resultado continua, mas sem
+// destino. A divisão também sai: o erro de divisão por zero não é um efeito garantido.
+
+static int* usos;
+
+static void conta_uso(Operando o, int delta) {
+    if (o.tipo == OPERANDO_TEMP) usos[o.valor] += delta;
+}
+
+static void conta_usos_instrucao(const BlocoBasico* b, const InstrucaoIR* ins, int delta) {
+    if (ins->op == IR_FI) {
+        for (int p = 0; p < b->num_predecessores; p++) conta_uso(ins->fontes[p], delta);
+    } else {
+        conta_uso(ins->a, delta);
+        conta_uso(ins->b, delta);
+    }
+}
+
+static void remove_codigo_morto(void) {
+    usos = aloca_zerado(funcao->num_temporarios, sizeof(int));
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        for (InstrucaoIR* ins = b->primeira; ins; ins = ins->proxima) conta_usos_instrucao(b, ins, 1);
+        conta_uso(b->valor, 1);
+        conta_uso(b->valor2, 1);
+    }
+
+    int mudou = 1;
+    while (mudou) {
+        mudou = 0;
+        for (int i = 0; i < funcao->num_blocos; i++) {
+            BlocoBasico* b = funcao->blocos[i];
+            InstrucaoIR* anterior;
+            for (InstrucaoIR* ins = b->ultima; ins; ins = anterior) {
+                anterior = ins->anterior;
+                if (ins->destino.tipo != OPERANDO_TEMP || usos[ins->destino.valor] > 0) continue;
+                if (ins->op == IR_CHAMADA) {
+                    ins->destino = ir_nenhum();
+                } else if (ins->op == IR_COPIA || ins->op == IR_BINARIO || ins->op == IR_FI) {
+                    conta_usos_instrucao(b, ins, -1);
+                    ir_remove_instrucao(b, ins);
+                    estatisticas.instrucoes_mortas++;
+                    mudou = 1;
+                }
+            }
+        }
+    }
+    free(usos);
+}
+
+
+// --- Saída da Forma SSA ---
+// Cada fi "t = fi(x, y)" vira uma cópia para um temporário novo no fim de cada predecessor e
+// "t = novo" no lugar do fi. O temporário intermediário evita que as cópias de fis do mesmo
+// bloco se atropelem (quando um fi lê o resultado de outro, como numa troca de variáveis).
+// As arestas críticas já foram divididas, então cada predecessor só leva a este bloco.
+
+static void sai_da_forma_ssa(void) {
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        for (InstrucaoIR* fi = b->primeira; fi && fi->op == IR_FI; fi = fi->proxima) {
+            Operando intermediario = ir_novo_temp(funcao);
+            for (int p = 0; p < b->num_predecessores; p++) {
+                ir_copia(b->predecessores[p], intermediario, fi->fontes[p]);
+            }
+            fi->op = IR_COPIA;
+            fi->a = intermediario;
+            fi->fontes = NULL;
+        }
+    }
+    // Condições que a numeração tornou constantes viram saltos (e o ramo que não é mais
+    // alcançado sai do grafo).
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        if (b->terminador == TERM_DESVIO && b->valor.tipo == OPERANDO_CONST
+            && b->valor2.tipo == OPERANDO_CONST) {
+            ir_desvio_comparacao(b, b->comparacao, b->valor, b->valor2, b->sucessores[0], b->sucessores[1]);
+        }
+    }
+    ir_atualiza_grafo(funcao);
+}
+
+
+// --- Agregação de Cópias ---
+// Sair da forma SSA deixa muitas cópias "t = u". Quando t e u nunca estão vivos ao mesmo tempo
+// (não interferem), os dois podem ser o mesmo temporário e a cópia some (Chaitin). O grafo de
+// interferência é uma matriz de bits: t interfere com todos os temporários vivos onde t é
+// escrito, exceto com a origem quando a escrita é uma cópia.
+
+static unsigned int* interferencia;
+static int palavras_linha;
+
+#define BITS_PALAVRA (8 * (int)sizeof(unsigned int))
+
+static unsigned int* linha(int t) {
+    return &interferencia[(size_t)t * palavras_linha];
+}
+
+static void marca_bit(unsigned int* conjunto, int t) {
+    conjunto[t / BITS_PALAVRA] |= 1u << (t % BITS_PALAVRA);
+}
+
+static void desmarca_bit(unsigned int* conjunto, int t) {
+    conjunto[t / BITS_PALAVRA] &= ~(1u << (t % BITS_PALAVRA));
+}
+
+static void interfere(int x, int y) {
+    marca_bit(linha(x), y);
+    marca_bit(linha(y), x);
+}
+
+static void calcula_interferencia(void) {
+    ir_calcula_vivacidade(funcao);
+    int n = funcao->num_temporarios;
+    palavras_linha = ir_palavras_conjunto(funcao);
+    interferencia = aloca_zerado(n * palavras_linha, sizeof(unsigned int));
+    unsigned int* vivos = aloca_zerado(palavras_linha, sizeof(unsigned int));
+
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        memcpy(vivos, b->vivos_saida, palavras_linha * sizeof(unsigned int));
+        if (b->valor.tipo == OPERANDO_TEMP) marca_bit(vivos, b->valor.valor);
+        if (b->valor2.tipo == OPERANDO_TEMP) marca_bit(vivos, b->valor2.valor);
+        for (InstrucaoIR* ins = b->ultima; ins; ins = ins->anterior) {
+            if (ins->destino.tipo == OPERANDO_TEMP) {
+                int d = ins->destino.valor;
+                int origem = ins->op == IR_COPIA && ins->a.tipo == OPERANDO_TEMP ? ins->a.valor : -1;
+                for (int t = 0; t < n; t++) {
+                    if (t != d && t != origem && ir_pertence(vivos, t)) interfere(d, t);
+                }
+                desmarca_bit(vivos, d);
+            }
+            if (ins->a.tipo == OPERANDO_TEMP) marca_bit(vivos, ins->a.valor);
+            if (ins->b.tipo == OPERANDO_TEMP) marca_bit(vivos, ins->b.valor);
+        }
+    }
+    free(vivos);
+}
+
+static int* agregado_em;    // Por temporário: com quem foi juntado (ele mesmo = representante).
+
+static int representante(int t) {
+    while (agregado_em[t] != t) t = agregado_em[t] = agregado_em[agregado_em[t]];
+    return t;
+}
+
+static Operando agregado(Operando o) {
+    if (o.tipo == OPERANDO_TEMP) o.valor = representante(o.valor);
+    return o;
+}
+
+static void agrega_copias(void) {
+    int n = funcao->num_temporarios;
+    calcula_interferencia();
+    agregado_em = aloca_zerado(n, sizeof(int));
+    for (int t = 0; t < n; t++) agregado_em[t] = t;
+
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        InstrucaoIR* proxima;
+        for (InstrucaoIR* ins = b->primeira; ins; ins = proxima) {
+            proxima = ins->proxima;
+            if (ins->op != IR_COPIA || ins->destino.tipo != OPERANDO_TEMP || ins->a.tipo != OPERANDO_TEMP) continue;
+            int d = representante(ins->destino.valor), o = representante(ins->a.valor);
+            if (d != o) {
+                if (ir_pertence(linha(d), o)) continue;
+                // O representante herda as interferências do agregado.
+                agregado_em[o] = d;
+                for (int t = 0; t < n; t++) {
+                    if (ir_pertence(linha(o), t)) interfere(d, t);
+                }
+            }
+            ir_remove_instrucao(b, ins);
+            estatisticas.copias_agregadas++;
+        }
+    }
+
+    for (int i = 0; i < funcao->num_blocos; i++) {
+        BlocoBasico* b = funcao->blocos[i];
+        for (InstrucaoIR* ins = b->primeira; ins; ins = ins->proxima) {
+            ins->destino = agregado(ins->destino);
+            ins->a = agregado(ins->a);
+            ins->b = agregado(ins->b);
+        }
+        b->valor = agregado(b->valor);
+        b->valor2 = agregado(b->valor2);
+    }
+    free(agregado_em);
+    free(interferencia);
+    ir_remove_blocos_vazios(funcao);
+}
+
+
+static void otimiza_funcao(FuncaoIR* f) {
+    funcao = f;
+    if (funcao->num_blocos == 0) return;
+    ir_divide_arestas_criticas(programa, funcao);
+    calcula_arvore_dominadores();
+    converte_para_ssa();
+    numeracao_de_valores();
+    remove_codigo_morto();
+    libera_listas(filhos, funcao->num_blocos);
+    libera_listas(fronteira, funcao->num_blocos);
+    filhos = fronteira = NULL;
+    sai_da_forma_ssa();
+    agrega_copias();
+
+    for (int v = 0; v < funcao->num_variaveis; v++) funcao->variaveis[v]->numero_ssa = 0;
+    free(origem_nome);
+    free(nome_do_temporario);
+}
+
+EstatisticasSSA otimiza_ssa(ProgramaIR* p) {
+    memset(&estatisticas, 0, sizeof(estatisticas));
+    programa = p;
+    for (int f = 0; f < programa->num_funcoes; f++) otimiza_funcao(programa->funcoes[f]);
+    return estatisticas;
+}
+
+void imprime_estatisticas_ssa(void) {
+    printf("SSA: %d fi(s), %d expressão(ões) redundante(s), %d cópia(s) propagada(s), "
+           "%d operação(ões) dobrada(s), %d instrução(ões) morta(s) removida(s), %d cópia(s) agregada(s).\n",
+           estatisticas.funcoes_fi, estatisticas.expressoes_redundantes, estatisticas.copias_propagadas,
+           estatisticas.operacoes_dobradas, estatisticas.instrucoes_mortas, estatisticas.copias_agregadas);
+}
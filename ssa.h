@@ -0,0 +1,36 @@
+#ifndef SSA_H
+#define SSA_H
+
+#include "ir.h"
+
+// --- Otimização em Forma SSA (-O3) ---
+// Passada sobre o código intermediário, entre a sua geração e a geração de código MIPS. Em
+// cada função:
+//  - calcula a árvore de dominadores e as fronteiras de dominância do grafo de fluxo;
+//  - coloca as funções fi e renomeia as variáveis locais (parâmetros, variáveis do corpo e do
+//    bloco principal) para temporários definidos uma única vez (forma SSA);
+//  - numera os valores percorrendo a árvore de dominadores: um cálculo cujo valor já está num
+//    temporário de um bloco dominante é trocado por esse temporário, as cópias são propagadas
+//    e as operações sobre constantes são dobradas;
+//  - remove as instruções cujo resultado não é usado;
+//  - sai da forma SSA trocando cada fi por cópias no fim dos predecessores e junta num só
+//    temporário a origem e o destino das cópias que não interferem.
+// As variáveis globais continuam na memória: chamadas de função podem alterá-las.
+
+// Contadores do que a passada fez (para o relatório).
+typedef struct EstatisticasSSA {
+    int funcoes_fi;             // Funções fi colocadas.
+    int expressoes_redundantes; // Cálculos substituídos por um valor já disponível.
+    int copias_propagadas;      // Cópias eliminadas (os usos passam a ler a origem).
+    int operacoes_dobradas;     // Operações sobre constantes substituídas pelo resultado.
+    int instrucoes_mortas;      // Instruções removidas porque o resultado não era usado.
+    int copias_agregadas;       // Cópias que sumiram ao juntar origem e destino num temporário.
+} EstatisticasSSA;
+
+// Otimiza todas as funções do programa e devolve o que foi feito.
+EstatisticasSSA otimiza_ssa(ProgramaIR* programa);
+
+// Imprime o relatório da última execução.
+void imprime_estatisticas_ssa(void);
+
+#endif // SSA_H
@@ -1,176 +1,255 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
 #include "tabela_simbolos.h"
 
-// Função de hash simples para distribuir os símbolos na tabela.
-// O objetivo é converter uma string (o nome do símbolo) em um número inteiro (o índice na tabela).
-unsigned int hash(const char* str) {
-    unsigned int hash = 0;
-    // Itera por cada caractere da string.
-    while (*str) {
-        // A fórmula (hash << 5) + *str++ é uma maneira simples e eficaz de gerar
-        // um valor de hash que depende de todos os caracteres da string.
-        hash = (hash << 5) + *str++;
-    }
-    // O operador '%' (módulo) garante que o índice calculado esteja dentro dos limites do array da tabela.
-    return hash % TAMANHO_TABELA;
+// Função de hash para distribuir os símbolos na tabela.
+// O nome já é um átomo (um inteiro único por texto), mas átomos vizinhos são números vizinhos.
+// A etapa final do MurmurHash3 (fmix32) espalha esses bits, e a máscara reduz o valor ao
+// tamanho da tabela (que é sempre uma potência de 2).
+static unsigned int hash(Atomo nome, unsigned int capacidade) {
+    unsigned int h = (unsigned int)nome;
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h & (capacidade - 1);
 }
 
-// Inicializa uma tabela de símbolos, definindo todos os ponteiros como NULL.
-// Isso significa que, no início, todas as "listas" da tabela de hash estão vazias.
+// Inicializa uma tabela de símbolos vazia. Nenhuma memória é reservada até a primeira inserção.
 void inicializar_tabela(TabelaDeSimbolos* tabela) {
-    for (int i = 0; i < TAMANHO_TABELA; i++) {
-        tabela->simbolos[i] = NULL;
+    tabela->entradas = NULL;
+    tabela->capacidade = 0;
+    tabela->ocupados = 0;
+    tabela->buscas = 0;
+    tabela->sondagens = 0;
+    tabela->maior_sondagem = 0;
+    tabela->crescimentos = 0;
+}
+
+// Encontra a posição do nome na tabela: a posição onde ele está ou a posição livre onde ele
+// deveria ser inserido (sondagem linear a partir do hash). Devolve quantas posições examinou.
+static unsigned int localizar(const TabelaDeSimbolos* tabela, Atomo nome, unsigned int* posicao) {
+    unsigned int mascara = tabela->capacidade - 1;
+    unsigned int pos = hash(nome, tabela->capacidade);
+    unsigned int examinadas = 1;
+    while (tabela->entradas[pos].nome != ATOMO_NULO && tabela->entradas[pos].nome != nome) {
+        pos = (pos + 1) & mascara;
+        examinadas++;
     }
+    *posicao = pos;
+    return examinadas;
 }
 
-// Cria e inicializa uma nova tabela de símbolos.
-TabelaDeSimbolos* criar_tabela() {
-    // Aloca memória para a estrutura da tabela.
-    TabelaDeSimbolos* tabela = malloc(sizeof(TabelaDeSimbolos));
-    // Verifica se a alocação foi bem-sucedida.
-    if (!tabela) {
+// Dobra a capacidade da tabela (ou cria o vetor inicial) e reinsere os símbolos existentes.
+static void crescer_tabela(TabelaDeSimbolos* tabela) {
+    Simbolo* antigas = tabela->entradas;
+    unsigned int capacidade_antiga = tabela->capacidade;
+
+    tabela->capacidade = capacidade_antiga ? capacidade_antiga * 2 : CAPACIDADE_INICIAL_TABELA;
+    // calloc zera o vetor, o que marca todas as posições como livres (nome == ATOMO_NULO).
+    tabela->entradas = calloc(tabela->capacidade, sizeof(Simbolo));
+    if (!tabela->entradas) {
         printf("Erro: Falha de alocação de memória para Tabela de Símbolos.\n");
         exit(1);
     }
-    // Chama a função para inicializar a tabela recém-criada.
-    inicializar_tabela(tabela);
-    return tabela;
+    for (unsigned int i = 0; i < capacidade_antiga; i++) {
+        if (antigas[i].nome != ATOMO_NULO) {
+            unsigned int pos;
+            localizar(tabela, antigas[i].nome, &pos);
+            tabela->entradas[pos] = antigas[i];
+        }
+    }
+    if (capacidade_antiga) tabela->crescimentos++;
+    free(antigas);
 }
 
-// Insere um símbolo na tabela de símbolos (que é uma tabela de hash).
+// Insere um símbolo na tabela de símbolos (que é uma tabela de hash com endereçamento aberto).
+// Se o nome já existir na tabela, o registro é substituído pelo novo (o mais recente prevalece).
 void inserir_simbolo(TabelaDeSimbolos* tabela, Simbolo simbolo) {
-    // Calcula o índice da tabela de hash onde o símbolo deve ser inserido.
-    unsigned int idx = hash(simbolo.nome);
-    // Aloca memória para um novo nó de símbolo.
-    Simbolo* novo = malloc(sizeof(Simbolo));
-    if (!novo) {
-        printf("Erro: Falha de alocação de memória para Símbolo.\n");
-        exit(1);
+    // Garante espaço: a tabela cresce antes que o fator de carga passe do limite.
+    if ((tabela->ocupados + 1) * 10 > tabela->capacidade * CARGA_MAXIMA_TABELA) {
+        crescer_tabela(tabela);
     }
-    // Copia os dados do símbolo para a estrutura recém-alocada.
-    *novo = simbolo;
-
-    // --- Lógica de Encadeamento Separado (Separate Chaining) ---
-    // O novo símbolo é inserido no início da lista ligada naquela posição da tabela.
-    // 1. O 'proximo' do novo símbolo aponta para o antigo início da lista.
-    novo->proximo = tabela->simbolos[idx];
-    // 2. A posição da tabela agora aponta para o novo símbolo, que se torna o novo início da lista.
-    tabela->simbolos[idx] = novo;
+    unsigned int pos;
+    localizar(tabela, simbolo.nome, &pos);
+    if (tabela->entradas[pos].nome == ATOMO_NULO) {
+        tabela->ocupados++;
+    }
+    // Copia os dados do símbolo diretamente para a posição do vetor.
+    tabela->entradas[pos] = simbolo;
 }
 
 // Busca um símbolo pelo nome na tabela fornecida.
-Simbolo* buscar_simbolo(TabelaDeSimbolos* tabela, const char* nome) {
-    // Calcula o índice onde o símbolo deveria estar.
-    unsigned int idx = hash(nome);
-    // Pega o ponteiro para o início da lista ligada naquele índice.
-    Simbolo* atual = tabela->simbolos[idx];
-    // Percorre a lista ligada (se houver alguma).
-    while (atual) {
-        // Compara o nome do símbolo atual com o nome procurado.
-        if (strcmp(atual->nome, nome) == 0) {
-            return atual; // Símbolo encontrado.
+Simbolo* buscar_simbolo(TabelaDeSimbolos* tabela, Atomo nome) {
+    if (tabela->ocupados == 0) return NULL; // Tabela vazia (talvez nem alocada).
+    unsigned int pos;
+    unsigned int examinadas = localizar(tabela, nome, &pos);
+
+    // Atualiza as estatísticas de sondagem.
+    tabela->buscas++;
+    tabela->sondagens += examinadas;
+    if (examinadas > tabela->maior_sondagem) tabela->maior_sondagem = examinadas;
+
+    // A sondagem para no nome procurado ou numa posição livre (não encontrado).
+    return tabela->entradas[pos].nome == nome ? &tabela->entradas[pos] : NULL;
+}
+
+// Remove um nome da tabela. Para não deixar "buracos" que interromperiam as sondagens
+// de outros nomes, os registros seguintes do mesmo agrupamento são puxados para trás
+// (remoção por deslocamento, sem marcadores de posição apagada).
+void remover_simbolo(TabelaDeSimbolos* tabela, Atomo nome) {
+    if (tabela->ocupados == 0) return;
+    unsigned int mascara = tabela->capacidade - 1;
+    unsigned int livre;
+    localizar(tabela, nome, &livre);
+    if (tabela->entradas[livre].nome == ATOMO_NULO) return; // Nome não estava na tabela.
+
+    unsigned int pos = livre;
+    for (;;) {
+        pos = (pos + 1) & mascara;
+        if (tabela->entradas[pos].nome == ATOMO_NULO) break;
+        // O registro em 'pos' só pode ocupar a posição livre se ela estiver no caminho
+        // entre sua posição ideal e 'pos' (considerando a volta ao início do vetor).
+        unsigned int ideal = hash(tabela->entradas[pos].nome, tabela->capacidade);
+        if (((pos - ideal) & mascara) >= ((pos - livre) & mascara)) {
+            tabela->entradas[livre] = tabela->entradas[pos];
+            livre = pos;
         }
-        // Move para o próximo símbolo na lista de colisão.
-        atual = atual->proximo;
     }
-    return NULL; // Símbolo não encontrado nesta tabela.
+    tabela->entradas[livre].nome = ATOMO_NULO;
+    tabela->ocupados--;
 }
 
-// Libera a memória de uma tabela e todos os seus símbolos.
+// Libera a memória dos símbolos de uma tabela, deixando-a vazia.
 void liberar_tabela(TabelaDeSimbolos* tabela) {
-    // Itera por cada uma das posições da tabela de hash.
-    for (int i = 0; i < TAMANHO_TABELA; i++) {
-        Simbolo* atual = tabela->simbolos[i];
-        // Itera pela lista ligada em cada posição, liberando cada nó.
-        while (atual) {
-            Simbolo* temp = atual;
-            atual = atual->proximo;
-            free(temp);
-        }
-    }
-    // Por fim, libera a própria estrutura da tabela.
-    free(tabela);
+    // Os símbolos estão guardados no próprio vetor de entradas: basta liberá-lo.
+    free(tabela->entradas);
+    inicializar_tabela(tabela);
 }
 
-// --- Funções da Pilha de Tabelas (Gerenciamento de Escopo) ---
+// Imprime as estatísticas de ocupação e sondagem de uma tabela.
+void imprime_estatisticas_tabela(const TabelaDeSimbolos* tabela, const char* nome) {
+    double carga = tabela->capacidade ? (double)tabela->ocupados / tabela->capacidade : 0.0;
+    double media = tabela->buscas ? (double)tabela->sondagens / tabela->buscas : 0.0;
+    printf("  %-8s %6u símbolos, %6u posições (carga %.2f, %u crescimento(s)), "
+           "%lu buscas, %.2f sondagens/busca, pior caso %u\n",
+           nome, tabela->ocupados, tabela->capacidade, carga, tabela->crescimentos,
+           tabela->buscas, media, tabela->maior_sondagem);
+}
+
+// --- Funções da Pilha de Escopos (Gerenciamento de Escopo) ---
 
-// Inicializa a pilha de escopos.
-void inicializar_pilha(PilhaDeTabelas* pilha) {
+// Inicializa a pilha de escopos, sem nenhum escopo aberto.
+void inicializar_pilha(PilhaDeEscopos* pilha) {
+    inicializar_tabela(&pilha->vinculos);
+    pilha->registros = NULL;
+    pilha->num_registros = 0;
+    pilha->capacidade_registros = 0;
+    pilha->marcas = NULL;
+    pilha->capacidade_marcas = 0;
     // O topo em -1 indica que a pilha está vazia.
     pilha->topo = -1;
+    pilha->escopos_abertos = 0;
+    pilha->maior_profundidade = 0;
+    pilha->sombreamentos = 0;
 }
 
-// Empilha uma nova tabela, ou seja, cria um novo escopo.
-void empilhar(PilhaDeTabelas* pilha) {
-    // Verifica se há espaço na pilha (evita estouro de pilha/stack overflow).
-    if (pilha->topo < 99) {
-        // Incrementa o topo.
-        pilha->topo++;
-        // Cria uma nova tabela de símbolos para este novo nível de escopo.
-        pilha->tabelas[pilha->topo] = criar_tabela();
-    } else {
-        // Se o limite de escopos aninhados for atingido, o compilador aborta.
-        printf("Erro: Estouro da pilha de tabelas de símbolos (limite de 100 escopos aninhados).\n");
-        exit(1);
+// Abre um novo escopo: basta lembrar onde o diário de desfazer estava neste momento.
+void empilhar(PilhaDeEscopos* pilha) {
+    if (pilha->topo + 1 == pilha->capacidade_marcas) {
+        pilha->capacidade_marcas = pilha->capacidade_marcas ? pilha->capacidade_marcas * 2 : 16;
+        pilha->marcas = realloc(pilha->marcas, pilha->capacidade_marcas * sizeof(int));
+        if (!pilha->marcas) {
+            printf("Erro: Falha de alocação de memória para a pilha de escopos.\n");
+            exit(1);
+        }
     }
+    pilha->topo++;
+    pilha->marcas[pilha->topo] = pilha->num_registros;
+
+    pilha->escopos_abertos++;
+    if (pilha->topo + 1 > pilha->maior_profundidade) pilha->maior_profundidade = pilha->topo + 1;
 }
 
-// Desempilha a tabela do topo, ou seja, fecha o escopo atual.
-void desempilhar(PilhaDeTabelas* pilha) {
+// Fecha o escopo atual, desfazendo (do mais recente para o mais antigo) as declarações feitas nele:
+// cada nome volta ao vínculo que ele sombreava, ou sai da tabela se não sombreava nenhum.
+void desempilhar(PilhaDeEscopos* pilha) {
     // Verifica se a pilha não está vazia.
     if (pilha->topo >= 0) {
-        // Libera toda a memória usada pela tabela do escopo que está sendo fechado.
-        liberar_tabela(pilha->tabelas[pilha->topo]);
+        int marca = pilha->marcas[pilha->topo];
+        while (pilha->num_registros > marca) {
+            RegistroDesfazer* r = &pilha->registros[--pilha->num_registros];
+            if (r->havia_anterior) {
+                inserir_simbolo(&pilha->vinculos, r->anterior);
+            } else {
+                remover_simbolo(&pilha->vinculos, r->nome);
+            }
+        }
         // Decrementa o topo, fazendo o escopo anterior se tornar o escopo atual.
         pilha->topo--;
     }
 }
 
-// Retorna um ponteiro para a tabela que está no topo da pilha (o escopo atual).
-TabelaDeSimbolos* topo_pilha(PilhaDeTabelas* pilha) {
-    if (pilha->topo >= 0) {
-        return pilha->tabelas[pilha->topo];
-    }
-    return NULL; // Retorna NULL se a pilha estiver vazia.
-}
-
-// Insere um símbolo no escopo atual.
-void inserir_na_pilha(PilhaDeTabelas* pilha, Simbolo s) {
-    // Obtém a tabela de símbolos do escopo atual.
-    TabelaDeSimbolos* tabela_atual = topo_pilha(pilha);
-    if (tabela_atual) {
-        // Associa o nível de escopo atual ao símbolo.
-        s.escopo = pilha->topo;
-        // Insere o símbolo na tabela do escopo atual.
-        inserir_simbolo(tabela_atual, s);
-    }
+// Fecha todos os escopos ainda abertos e libera a memória da pilha.
+void liberar_pilha(PilhaDeEscopos* pilha) {
+    liberar_tabela(&pilha->vinculos);
+    free(pilha->registros);
+    free(pilha->marcas);
+    inicializar_pilha(pilha);
 }
 
-// Busca um símbolo em todos os escopos, do mais interno para o mais externo.
-// Isso implementa a regra de "sombreamento" de variáveis (shadowing).
-Simbolo* buscar_em_todos_escopos(PilhaDeTabelas* pilha, const char* nome) {
-    // Começa a busca do topo da pilha (escopo mais interno) para baixo.
-    for (int i = pilha->topo; i >= 0; i--) {
-        // Busca o símbolo na tabela do escopo 'i'.
-        Simbolo* s = buscar_simbolo(pilha->tabelas[i], nome);
-        // Se encontrou, retorna imediatamente. A primeira correspondência encontrada é a correta.
-        if (s) {
-            return s;
+// Insere um símbolo no escopo atual, anotando no diário o vínculo que ele esconde.
+void inserir_na_pilha(PilhaDeEscopos* pilha, Simbolo s) {
+    if (pilha->topo < 0) return; // Nenhum escopo aberto.
+
+    if (pilha->num_registros == pilha->capacidade_registros) {
+        pilha->capacidade_registros = pilha->capacidade_registros ? pilha->capacidade_registros * 2 : 64;
+        pilha->registros = realloc(pilha->registros, pilha->capacidade_registros * sizeof(RegistroDesfazer));
+        if (!pilha->registros) {
+            printf("Erro: Falha de alocação de memória para a pilha de escopos.\n");
+            exit(1);
         }
     }
-    return NULL; // Se percorreu todos os escopos e não encontrou, retorna NULL.
+    RegistroDesfazer* r = &pilha->registros[pilha->num_registros++];
+    Simbolo* anterior = buscar_simbolo(&pilha->vinculos, s.nome);
+    r->nome = s.nome;
+    r->havia_anterior = anterior != NULL;
+    if (anterior) {
+        r->anterior = *anterior;
+        // Redeclaração no mesmo escopo (o chamador já reportou o erro) não conta como sombreamento.
+        if (anterior->escopo != pilha->topo) pilha->sombreamentos++;
+    }
+
+    // Associa o nível de escopo atual ao símbolo e o torna o vínculo visível do nome.
+    s.escopo = pilha->topo;
+    inserir_simbolo(&pilha->vinculos, s);
+}
+
+// Busca o vínculo visível de um nome. Como a tabela só guarda o vínculo mais interno,
+// a regra de "sombreamento" de variáveis (shadowing) já está aplicada: uma única consulta basta.
+Simbolo* buscar_em_todos_escopos(PilhaDeEscopos* pilha, Atomo nome) {
+    return buscar_simbolo(&pilha->vinculos, nome);
 }
 
 // Busca um símbolo apenas no escopo atual.
 // Usado principalmente para detectar erros de redeclaração de variáveis no mesmo escopo.
-Simbolo* buscar_no_escopo_atual(PilhaDeTabelas* pilha, const char* nome) {
-    // Pega a tabela do topo da pilha.
-    TabelaDeSimbolos* tabela_atual = topo_pilha(pilha);
-    if (tabela_atual) {
-        // Busca o símbolo apenas nesta tabela.
-        return buscar_simbolo(tabela_atual, nome);
+Simbolo* buscar_no_escopo_atual(PilhaDeEscopos* pilha, Atomo nome) {
+    Simbolo* s = buscar_simbolo(&pilha->vinculos, nome);
+    // O vínculo visível só pertence ao escopo atual se foi declarado neste nível.
+    if (s && s->escopo == pilha->topo) {
+        return s;
     }
     return NULL;
-}
\ No newline at end of file
+}
+
+// Imprime as estatísticas da tabela de vínculos e do uso dos escopos.
+void imprime_estatisticas_pilha(const PilhaDeEscopos* pilha) {
+    printf("--- Tabela de Símbolos ---\n");
+    imprime_estatisticas_tabela(&pilha->vinculos, "vínculos");
+    printf("  %lu escopo(s) aberto(s), profundidade máxima %d, %lu sombreamento(s), "
+           "diário com %d posições\n",
+           pilha->escopos_abertos, pilha->maior_profundidade, pilha->sombreamentos,
+           pilha->capacidade_registros);
+    printf("--------------------------\n\n");
+}
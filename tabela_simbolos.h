@@ -1,13 +1,16 @@
 #ifndef TABELA_SIMBOLOS_H
 #define TABELA_SIMBOLOS_H
 
-// Inclui o cabeçalho da árvore, pois a estrutura do símbolo precisa conhecer
+// Inclui o cabeçalho da árvore, pois o vínculo precisa conhecer
 // os tipos de dados (`TipoDado`) e também pode apontar para nós da árvore (`struct No* params`).
 #include "arvore.h"
 
-// Define o tamanho da nossa tabela de hash. 256 é um valor comum.
-// A tabela de hash é usada para armazenar e buscar símbolos de forma eficiente.
-#define TAMANHO_TABELA 256
+// Capacidade inicial de uma tabela de hash, alocada apenas na primeira inserção.
+// Deve ser uma potência de 2, pois o índice é obtido com uma máscara de bits.
+#define CAPACIDADE_INICIAL_TABELA 8
+
+// Fator de carga máximo (em décimos): ao passar de 70% de ocupação, a tabela dobra de tamanho.
+#define CARGA_MAXIMA_TABELA 7
 
 // Enumeração para a categoria de um símbolo. Ajuda a distinguir
 // entre uma variável e uma função que possam ter o mesmo nome.
@@ -17,56 +20,130 @@ typedef enum {
     CAT_PARAMETRO     // O símbolo é um parâmetro de função.
 } CategoriaSimbolo;
 
-// Estrutura que armazena todas as informações relevantes sobre um símbolo (identificador).
-typedef struct Simbolo {
-    char nome[100];             // O nome do identificador (ex: "minhaVariavel").
+// Classe de armazenamento de um vínculo: diz ONDE o valor do nome vive durante a execução.
+// É decidida uma única vez, pela análise semântica, e apenas lida pela geração de código.
+typedef enum {
+    ARMAZ_GLOBAL,     // Área global, endereçada a partir de $gp (variáveis fora de funções).
+    ARMAZ_LOCAL,      // Quadro da função, endereçado a partir de $fp (deslocamento negativo).
+    ARMAZ_PARAMETRO,  // Argumento recebido num registrador e guardado no quadro (deslocamento negativo)
+                      // ou empilhado pelo chamador (deslocamento positivo), a partir de $fp.
+    ARMAZ_FUNCAO,     // Função definida no programa (um rótulo no código).
+    ARMAZ_NATIVA      // Função nativa da linguagem (leia, escreva, novalinha), gerada em linha.
+} ClasseArmazenamento;
+
+// Quantos argumentos são passados em registradores ($a0-$a3); os seguintes vão na pilha.
+#define PARAMETROS_EM_REGISTRADORES 4
+
+// Vínculo (binding): tudo o que se sabe sobre uma declaração depois que ela foi resolvida.
+// A análise semântica cria um vínculo por declaração e o anota nos nós que a usam
+// (identificadores, chamadas e as próprias declarações), então a geração de código nunca
+// precisa procurar um nome. Os vínculos ficam numa arena e não mudam de endereço.
+typedef struct Vinculo {
+    Atomo nome;                 // O nome declarado.
     CategoriaSimbolo categoria; // A categoria do símbolo (CAT_VARIAVEL, CAT_FUNCAO, etc.).
-    TipoDado tipo_dado;         // O tipo de dado associado ao símbolo (TIPO_INT, TIPO_VOID, etc.).
+    ClasseArmazenamento classe; // Onde o valor vive (global, local, parâmetro, função).
+    TipoDado tipo_dado;         // O tipo de dado associado ao símbolo (para funções, o tipo de retorno).
     int linha;                  // A linha onde o símbolo foi declarado.
-    int escopo;                 // O nível de escopo onde foi declarado (0 para global, 1 para o primeiro nível de aninhamento, etc.).
+    int deslocamento;           // Variáveis e parâmetros: deslocamento em bytes a partir de $gp (área global) ou $fp.
+    int registrador;            // Registrador ($s2-$s7) onde a geração de código manteve a variável (0 = memória).
+    int peso_uso;               // Usos da variável ponderados pelo aninhamento de laços (geração de código).
+    int constante_versao;       // Otimização: != 0 se o valor atual da variável é conhecido (ver otimizacao.c).
+    int constante_valor;        // Otimização: o valor conhecido.
+    int numero_ssa;             // Otimização SSA: 1 + índice da variável na função (0 = fora dela).
 
     // Campos específicos para funções:
     struct No* params;          // Ponteiro para a lista de nós de parâmetros na ASA. Usado para verificar os tipos dos argumentos na chamada da função.
     int num_params;             // O número de parâmetros que a função espera.
+    int tamanho_quadro;         // Bytes de variáveis locais (de todos os blocos; os disjuntos dividem posições) que o prólogo deve reservar.
+} Vinculo;
 
-    // Ponteiro para o próximo símbolo em caso de colisão na tabela de hash.
-    // A nossa tabela usa uma técnica chamada "encadeamento separado" (separate chaining).
-    struct Simbolo* proximo;
+// Entrada da tabela de símbolos: associa um nome, no escopo em que foi declarado, ao seu vínculo.
+typedef struct Simbolo {
+    Atomo nome;                 // O nome do identificador, como átomo (o texto é obtido com `texto_atomo`).
+    int escopo;                 // O nível de escopo onde foi declarado (0 para global, 1 para o primeiro nível de aninhamento, etc.).
+    Vinculo* vinculo;           // A declaração propriamente dita (estável: pode ser guardada na ASA).
 } Simbolo;
 
-// Estrutura da Tabela de Símbolos. É basicamente uma tabela de hash.
-// É um array de ponteiros para Símbolo. Cada posição do array é a "cabeça" de uma lista ligada de símbolos.
+// Estrutura da Tabela de Símbolos: uma tabela de hash com endereçamento aberto (sondagem linear).
+// Os registros 'Simbolo' ficam guardados diretamente no vetor 'entradas' (sem listas ligadas nem
+// um malloc por símbolo). Uma posição está livre quando seu 'nome' é ATOMO_NULO.
+// A tabela começa vazia, aloca CAPACIDADE_INICIAL_TABELA posições na primeira inserção e dobra
+// de tamanho sempre que o fator de carga passaria de CARGA_MAXIMA_TABELA décimos.
+// Atenção: como o vetor pode ser realocado, um 'Simbolo*' obtido da tabela só é válido até a
+// próxima inserção NA MESMA tabela.
 typedef struct TabelaDeSimbolos {
-    Simbolo* simbolos[TAMANHO_TABELA];
+    Simbolo* entradas;          // Vetor de 'capacidade' posições (NULL enquanto a tabela estiver vazia).
+    unsigned int capacidade;    // Número de posições (0 ou uma potência de 2).
+    unsigned int ocupados;      // Número de posições em uso.
+
+    // --- Estatísticas (para verificar que as buscas continuam O(1)) ---
+    unsigned long buscas;       // Quantas buscas foram feitas na tabela.
+    unsigned long sondagens;    // Total de posições examinadas por todas as buscas.
+    unsigned int maior_sondagem; // Maior número de posições examinadas em uma única busca.
+    unsigned int crescimentos;  // Quantas vezes a tabela dobrou de tamanho.
 } TabelaDeSimbolos;
 
-// Estrutura da Pilha de Tabelas. Essencial para o gerenciamento de escopos.
-// Quando entramos em um novo escopo (como uma função ou um bloco), uma nova tabela é "empilhada".
-// Quando saímos do escopo, ela é "desempilhada".
-typedef struct PilhaDeTabelas {
-    TabelaDeSimbolos* tabelas[100]; // Um array de ponteiros para tabelas de símbolos. Suporta até 100 níveis de escopo aninhados.
-    int topo;                       // Um índice que aponta para o topo da pilha (o escopo atual).
-} PilhaDeTabelas;
+// Registro do "diário de desfazer" de um escopo. Cada declaração feita num escopo anota aqui
+// o vínculo que ela escondeu (ou que não havia nenhum), para que o fechamento do escopo
+// possa devolver a tabela ao estado anterior.
+typedef struct RegistroDesfazer {
+    Atomo nome;                 // Nome declarado no escopo.
+    int havia_anterior;         // 1 se a declaração sombreou um vínculo de um escopo externo.
+    Simbolo anterior;           // O vínculo sombreado (válido apenas se 'havia_anterior').
+} RegistroDesfazer;
+
+// Pilha de Escopos no estilo LeBlanc-Cook. Em vez de uma tabela por escopo, existe UMA única
+// tabela de hash que guarda, para cada nome, apenas o vínculo visível no ponto atual da análise.
+// Os vínculos escondidos por sombreamento ficam no diário de desfazer, então a "pilha de
+// vínculos" de cada nome está espalhada pelo diário, do mais recente para o mais antigo.
+// - Buscar um nome: uma consulta à tabela, qualquer que seja a profundidade de aninhamento.
+// - Abrir um escopo: anota a posição atual do diário (uma marca).
+// - Fechar um escopo: desfaz os registros feitos desde a marca (custo proporcional apenas
+//   ao número de declarações do próprio escopo).
+// Não há limite fixo de aninhamento: o diário e as marcas crescem conforme a necessidade.
+typedef struct PilhaDeEscopos {
+    TabelaDeSimbolos vinculos;      // Nome -> vínculo visível.
+    RegistroDesfazer* registros;    // Diário de desfazer de todos os escopos abertos.
+    int num_registros;
+    int capacidade_registros;
+    int* marcas;                    // marcas[n] = início do diário do escopo de nível n.
+    int capacidade_marcas;
+    int topo;                       // Nível do escopo atual (-1 = nenhum escopo aberto, 0 = global).
+
+    // Estatísticas.
+    unsigned long escopos_abertos;  // Quantos escopos foram abertos ao todo.
+    int maior_profundidade;         // Maior nível de aninhamento alcançado.
+    unsigned long sombreamentos;    // Quantas declarações esconderam um vínculo externo.
+} PilhaDeEscopos;
 
 
 // --- Assinaturas das Funções da Tabela de Símbolos (operações em uma única tabela) ---
 void inicializar_tabela(TabelaDeSimbolos* tabela);
 void inserir_simbolo(TabelaDeSimbolos* tabela, Simbolo s);
-Simbolo* buscar_simbolo(TabelaDeSimbolos* tabela, const char* nome);
+Simbolo* buscar_simbolo(TabelaDeSimbolos* tabela, Atomo nome);
+void remover_simbolo(TabelaDeSimbolos* tabela, Atomo nome);
 void liberar_tabela(TabelaDeSimbolos* tabela);
 
+// Imprime ocupação, fator de carga e comprimento das sondagens de uma tabela.
+void imprime_estatisticas_tabela(const TabelaDeSimbolos* tabela, const char* nome);
+
 
-// --- Assinaturas das Funções da Pilha de Tabelas (Gerenciamento de Escopos) ---
-void inicializar_pilha(PilhaDeTabelas* pilha);
-void empilhar(PilhaDeTabelas* pilha); // Cria um novo escopo.
-void desempilhar(PilhaDeTabelas* pilha); // Fecha o escopo atual.
-TabelaDeSimbolos* topo_pilha(PilhaDeTabelas* pilha); // Retorna a tabela do escopo atual.
+// --- Assinaturas das Funções da Pilha de Escopos (Gerenciamento de Escopos) ---
+// Atenção: como todos os escopos compartilham a mesma tabela, um 'Simbolo*' devolvido pelas
+// buscas só é válido até a próxima inserção ou o próximo fechamento de escopo.
+void inicializar_pilha(PilhaDeEscopos* pilha);
+void empilhar(PilhaDeEscopos* pilha); // Cria um novo escopo.
+void desempilhar(PilhaDeEscopos* pilha); // Fecha o escopo atual.
+void liberar_pilha(PilhaDeEscopos* pilha); // Fecha todos os escopos e devolve a memória.
 
 // Funções de busca que operam na pilha de escopos:
-Simbolo* buscar_em_todos_escopos(PilhaDeTabelas* pilha, const char* nome); // Procura do escopo atual para o global.
-Simbolo* buscar_no_escopo_atual(PilhaDeTabelas* pilha, const char* nome);  // Procura apenas no escopo atual (para checar redeclarações).
+Simbolo* buscar_em_todos_escopos(PilhaDeEscopos* pilha, Atomo nome); // Procura do escopo atual para o global.
+Simbolo* buscar_no_escopo_atual(PilhaDeEscopos* pilha, Atomo nome);  // Procura apenas no escopo atual (para checar redeclarações).
 
 // Insere um símbolo no escopo atual (no topo da pilha).
-void inserir_na_pilha(PilhaDeTabelas* pilha, Simbolo s);
+void inserir_na_pilha(PilhaDeEscopos* pilha, Simbolo s);
+
+// Imprime as estatísticas da tabela de vínculos e do uso dos escopos.
+void imprime_estatisticas_pilha(const PilhaDeEscopos* pilha);
 
 #endif // TABELA_SIMBOLOS_H
\ No newline at end of file
@@ -0,0 +1,73 @@
+// Arquivo: teste_expansao.g
+// Objetivo: Testar a expansão em linha e a divisão de posições entre as variáveis das cópias.
+// Compile com -O2 -inline=200 (ou -O3 -inline=200): 'pesa' e 'borda' são copiadas várias
+// vezes, dentro de blocos aninhados, no programa principal e em 'usa', e as cópias que nunca
+// estão vivas ao mesmo tempo passam a dividir a mesma posição (na área global ou no quadro
+// de 'usa', que chama a si mesma e por isso não é expandida). Com a entrada 3, a saída é a
+// mesma de -O0:
+//   488 b
+//   750 b
+//   927 b
+//   113
+//   183 b
+//   -109
+int total;
+
+int pesa(int x, int y) {
+  int t;
+  t = x * 3 + y;
+  { int u; u = t - x; t = t + u; }
+  retorne t;
+}
+
+int borda(int n) {
+  int s, i;
+  s = 0;
+  i = 0;
+  enquanto (i < n) execute {
+    { int d; d = pesa(i, n); s = s + d; }
+    i = i + 1;
+  }
+  retorne s;
+}
+
+car marca(int v) {
+  car c;
+  c = 'a';
+  se (v > 100) entao c = 'b';
+  retorne c;
+}
+
+int usa(int a, int b, int c, int d, int x) {
+  int r;
+  r = pesa(a, b);
+  {
+    int m;
+    m = pesa(c, d) + pesa(r, x);
+    r = r + m;
+    {
+      int k;
+      k = borda(a) - borda(b);
+      total = total + k;
+      r = r + k + pesa(k, m);
+    }
+  }
+  se (x > 6) entao r = r + usa(a - 1, b, c, d, x - 1);
+  retorne r;
+}
+
+programa {
+  int i, v;
+  car c;
+  leia i;
+  v = 0;
+  enquanto (i > 0) execute {
+    v = v + usa(i, i + 1, i + 2, i + 3, i + 4);
+    c = marca(v);
+    escreva v; escreva " "; escreva c; novalinha;
+    i = i - 1;
+  }
+  { int w; w = borda(5) + borda(2); escreva w; novalinha; }
+  { int z; z = pesa(borda(3), pesa(1, 2)); escreva z; escreva " "; escreva marca(z); novalinha; }
+  escreva total; novalinha;
+}
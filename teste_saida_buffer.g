@@ -0,0 +1,11 @@
+car c;
+
+programa {
+    escreva "antes";
+    novalinha;
+    escreva c;
+    escreva "depois";
+    novalinha;
+    escreva 42;
+    novalinha;
+}